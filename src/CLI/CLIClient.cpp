@@ -105,7 +105,7 @@ void Client::ping()
     }
 }
 
-int32_t Client::start(std::string command)
+int32_t Client::connect()
 {
 	try
 	{
@@ -131,7 +131,7 @@ int32_t Client::start(std::string command)
 			}
 			strncpy(remoteAddress.sun_path, _socketPath.c_str(), 104);
 			remoteAddress.sun_path[103] = 0; //Just to make sure it is null terminated.
-			if(connect(_fileDescriptor->descriptor, (struct sockaddr*)&remoteAddress, strlen(remoteAddress.sun_path) + 1 + sizeof(remoteAddress.sun_family)) == -1)
+			if(::connect(_fileDescriptor->descriptor, (struct sockaddr*)&remoteAddress, strlen(remoteAddress.sun_path) + 1 + sizeof(remoteAddress.sun_family)) == -1)
 			{
 				GD::bl->fileDescriptorManager.shutdown(_fileDescriptor);
 				if(i == 0)
@@ -150,6 +150,103 @@ int32_t Client::start(std::string command)
 			else break;
 		}
 		if(GD::bl->debugLevel >= 4) std::cout << "Connected to Homegear (version " + GD::bl->version() + ")." << std::endl;
+		return 0;
+	}
+    catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return 3;
+}
+
+bool Client::sendAll(const std::string& data)
+{
+	try
+	{
+		uint32_t totallySentBytes = 0;
+		while(totallySentBytes < data.size())
+		{
+			int32_t sentBytes = send(_fileDescriptor->descriptor, data.c_str() + totallySentBytes, data.size() - totallySentBytes, MSG_NOSIGNAL);
+			if(sentBytes == -1) return false;
+			totallySentBytes += sentBytes;
+		}
+		return true;
+	}
+    catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return false;
+}
+
+int32_t Client::getExitCode(std::string& response)
+{
+	try
+	{
+		// {{{ Get last line and check if it contains the exit code.
+		if(response.size() > 2)
+		{
+			const char* pos = response.c_str() + response.size() - 2; // -2, because last line ends with new line
+			while(pos >= response.c_str())
+			{
+				if(*pos == 'E') break;
+				else if(*pos == '\n')
+				{
+					pos++;
+					break;
+				}
+				pos--;
+			}
+
+			int32_t count = (response.c_str() + response.size()) - pos - 1;
+			std::string lastLine(pos, count);
+			if(lastLine.compare(0, 11, "Exit code: ") == 0 && lastLine.size() > 11)
+			{
+				count = pos - response.c_str();
+				response = response.substr(0, count);
+				std::string exitCodeString = lastLine.substr(11);
+				return BaseLib::Math::getNumber(exitCodeString);
+			}
+		}
+		// }}}
+	}
+    catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return 0;
+}
+
+int32_t Client::start(std::string command)
+{
+	try
+	{
+		int32_t result = connect();
+		if(result != 0) return result;
 
 		if(command.empty()) _pingThread = std::thread(&CLI::Client::ping, this);
 
@@ -269,37 +366,8 @@ int32_t Client::start(std::string command)
 						{
 							_sendMutex.unlock();
 
-							int32_t exitCode = 0;
-
-							// {{{ Get last line and check if it contains the exit code.
-							if(response.size() > 2)
-							{
-
-								const char* pos = response.c_str() + response.size() - 2; // -2, because last line ends with new line
-								while(pos >= response.c_str())
-								{
-									if(*pos == 'E') break;
-									else if(*pos == '\n')
-									{
-										pos++;
-										break;
-									}
-									pos--;
-								}
-
-								int32_t count = (response.c_str() + response.size()) - pos - 1;
-								std::string lastLine(pos, count);
-								if(lastLine.compare(0, 11, "Exit code: ") == 0 && lastLine.size() > 11)
-								{
-									count = pos - response.c_str();
-									response = response.substr(0, count);
-									std::string exitCodeString = lastLine.substr(11);
-									exitCode = BaseLib::Math::getNumber(exitCodeString);
-								}
-								std::cout << response;
-							}
-							// }}}
-
+							int32_t exitCode = getExitCode(response);
+							if(response.size() > 2) std::cout << response;
 							return exitCode;
 						}
 						else std::cout << response;
@@ -335,4 +403,105 @@ int32_t Client::start(std::string command)
     return 0;
 }
 
+int32_t Client::startBatch()
+{
+	try
+	{
+		int32_t result = connect();
+		if(result != 0) return result;
+
+		if(!sendAll(Server::channelHandshake))
+		{
+			GD::out.printError("Error sending to socket.");
+			return 6;
+		}
+
+		int32_t exitCode = 0;
+		uint64_t currentId = 0;
+		uint64_t nextResponseId = 0;
+		bool inputFinished = false;
+		std::string receivedData;
+		char receiveBuffer[1024];
+		while(!inputFinished || nextResponseId < currentId)
+		{
+			// {{{ Send commands until the maximum number of pending commands is reached
+			std::string packet;
+			while(!inputFinished && currentId - nextResponseId < _maxPendingCommands)
+			{
+				std::string command;
+				if(!std::getline(std::cin, command))
+				{
+					inputFinished = true;
+					break;
+				}
+				if(!command.empty() && command.back() == '\r') command.pop_back();
+				if(command.empty()) continue;
+				packet.append(std::to_string(currentId++) + ' ' + command + '\n');
+			}
+			if(!packet.empty() && !sendAll(packet))
+			{
+				GD::out.printError("Error sending to socket.");
+				return 6;
+			}
+			if(nextResponseId == currentId) continue;
+			// }}}
+
+			// {{{ Receive and output the responses in the order the commands were sent
+			bool responseReceived = false;
+			while(!responseReceived)
+			{
+				std::string::size_type headerEnd = receivedData.find('\n');
+				if(headerEnd != std::string::npos)
+				{
+					std::string header = receivedData.substr(0, headerEnd);
+					std::string::size_type idEnd = header.find(' ');
+					if(idEnd == std::string::npos)
+					{
+						GD::out.printError("Error: Received invalid response header.");
+						return 7;
+					}
+					std::string sizeString = header.substr(idEnd + 1);
+					uint32_t size = BaseLib::Math::getNumber(sizeString);
+					if(receivedData.size() >= headerEnd + 1 + size)
+					{
+						std::string response = receivedData.substr(headerEnd + 1, size);
+						receivedData.erase(0, headerEnd + 1 + size);
+						int32_t responseExitCode = getExitCode(response);
+						if(responseExitCode != 0) exitCode = responseExitCode;
+						std::cout << response;
+						nextResponseId++;
+						responseReceived = true;
+						break;
+					}
+				}
+
+				int32_t bytes = recv(_fileDescriptor->descriptor, receiveBuffer, sizeof(receiveBuffer), 0);
+				if(bytes <= 0)
+				{
+					if(bytes < 0) std::cerr << "Error receiving data from socket." << std::endl;
+					else std::cout << "Connection closed." << std::endl;
+					return 8;
+				}
+				receivedData.append(receiveBuffer, bytes);
+			}
+			// }}}
+		}
+		std::cout << std::flush;
+		return exitCode;
+	}
+    catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return 0;
+}
+
 } /* namespace CLI */
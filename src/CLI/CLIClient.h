@@ -51,6 +51,14 @@ public:
 	 * @return Returns the exit code. If a script is executed the script exit code is returned.
 	 */
 	int32_t start(std::string command = "");
+
+	/**
+	 * Reads CLI commands line by line from standard input and executes them over one command channel. Commands are sent without waiting for
+	 * the response of the previous command, so large numbers of commands don't pay a connection setup or round trip each.
+	 *
+	 * @return Returns the last exit code other than 0 returned by a command or a value greater than 0 on connection errors.
+	 */
+	int32_t startBatch();
 private:
 	std::string _socketPath;
 	std::shared_ptr<BaseLib::FileDescriptor> _fileDescriptor;
@@ -59,6 +67,21 @@ private:
 	bool _closed = false;
 	std::mutex _sendMutex;
 
+	/**
+	 * The maximum number of commands sent in batch mode before waiting for responses.
+	 */
+	uint32_t _maxPendingCommands = 64;
+
+	int32_t connect();
+	bool sendAll(const std::string& data);
+
+	/**
+	 * Removes the line "Exit code: ..." from the end of a response.
+	 *
+	 * @param response The response of the CLI server.
+	 * @return Returns the exit code or 0 if the response contains none.
+	 */
+	int32_t getExitCode(std::string& response);
 	void ping();
 };
 
@@ -35,9 +35,13 @@
 namespace CLI {
 
 int32_t Server::_currentClientID = 0;
+const std::string Server::channelHandshake = std::string("\x01" "channel\n");
 
-Server::Server()
+Server::Server() : BaseLib::IQueue(GD::bl.get(), 1000)
 {
+	_wakeUpPipe[0] = -1;
+	_wakeUpPipe[1] = -1;
+	_queueDepth = GD::metrics.queueDepth("cliServer");
 }
 
 Server::~Server()
@@ -45,66 +49,6 @@ Server::~Server()
 	stop();
 }
 
-void Server::collectGarbage()
-{
-	_garbageCollectionMutex.lock();
-	try
-	{
-		_lastGargabeCollection = GD::bl->hf.getTime();
-		std::vector<std::shared_ptr<ClientData>> clientsToRemove;
-		_stateMutex.lock();
-		try
-		{
-			for(std::map<int32_t, std::shared_ptr<ClientData>>::iterator i = _clients.begin(); i != _clients.end(); ++i)
-			{
-				if(i->second->closed) clientsToRemove.push_back(i->second);
-			}
-		}
-		catch(const std::exception& ex)
-		{
-			GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-		}
-		catch(...)
-		{
-			GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
-		}
-		_stateMutex.unlock();
-		for(std::vector<std::shared_ptr<ClientData>>::iterator i = clientsToRemove.begin(); i != clientsToRemove.end(); ++i)
-		{
-			GD::out.printDebug("Debug: Joining read thread of CLI client " + std::to_string((*i)->id));
-			GD::bl->threadManager.join((*i)->readThread);
-			_stateMutex.lock();
-			try
-			{
-				_clients.erase((*i)->id);
-			}
-			catch(const std::exception& ex)
-			{
-				GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-			}
-			catch(...)
-			{
-				GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
-			}
-			_stateMutex.unlock();
-			GD::out.printDebug("Debug: CLI client " + std::to_string((*i)->id) + " removed.");
-		}
-	}
-	catch(const std::exception& ex)
-    {
-    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-    }
-    catch(BaseLib::Exception& ex)
-    {
-    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-    }
-    catch(...)
-    {
-    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
-    }
-    _garbageCollectionMutex.unlock();
-}
-
 void Server::start()
 {
 	try
@@ -112,6 +56,18 @@ void Server::start()
 		_socketPath = GD::bl->settings.socketPath() + "homegear.sock";
 		stop();
 		_stopServer = false;
+		if(pipe(_wakeUpPipe) == -1)
+		{
+			_wakeUpPipe[0] = -1;
+			_wakeUpPipe[1] = -1;
+			GD::out.printError("Error: Could not create wake up pipe of CLI server: " + std::string(strerror(errno)));
+			return;
+		}
+		//Nonblocking, so a worker never waits for the main thread and the main thread can empty the pipe without knowing how many bytes were written.
+		fcntl(_wakeUpPipe[0], F_SETFL, fcntl(_wakeUpPipe[0], F_GETFL) | O_NONBLOCK);
+		fcntl(_wakeUpPipe[1], F_SETFL, fcntl(_wakeUpPipe[1], F_GETFL) | O_NONBLOCK);
+		_started = true;
+		startQueue(0, _workerThreads, 0, SCHED_OTHER);
 		GD::bl->threadManager.start(_mainThread, true, &Server::mainThread, this);
 	}
     catch(const std::exception& ex)
@@ -134,18 +90,33 @@ void Server::stop()
 	{
 		_stopServer = true;
 		GD::bl->threadManager.join(_mainThread);
-		GD::out.printDebug("Debug: Waiting for CLI client threads to finish.");
+		GD::out.printDebug("Debug: Closing CLI client connections.");
+		std::map<int32_t, std::shared_ptr<ClientData>> clients;
 		{
 			std::lock_guard<std::mutex> stateGuard(_stateMutex);
-			for(std::map<int32_t, std::shared_ptr<ClientData>>::iterator i = _clients.begin(); i != _clients.end(); ++i)
-			{
-				closeClientConnection(i->second);
-			}
+			clients = _clients;
 		}
-		while(_clients.size() > 0)
+		//Close the connections first, so workers currently sending to a client return immediately.
+		for(std::map<int32_t, std::shared_ptr<ClientData>>::iterator i = clients.begin(); i != clients.end(); ++i)
 		{
-			collectGarbage();
-			if(_clients.size() > 0) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			closeClientConnection(i->second);
+		}
+		if(_started)
+		{
+			_started = false;
+			GD::out.printDebug("Debug: Waiting for CLI worker threads to finish.");
+			stopQueue(0);
+			_queueDepth->clear();
+		}
+		GD::out.printDebug("Debug: Waiting for CLI scripts to finish.");
+		for(std::map<int32_t, std::shared_ptr<ClientData>>::iterator i = clients.begin(); i != clients.end(); ++i)
+		{
+			GD::bl->threadManager.join(i->second->scriptThread);
+		}
+		for(int32_t i = 0; i < 2; i++)
+		{
+			if(_wakeUpPipe[i] != -1) close(_wakeUpPipe[i]);
+			_wakeUpPipe[i] = -1;
 		}
 		unlink(_socketPath.c_str());
 	}
@@ -170,6 +141,33 @@ void Server::closeClientConnection(std::shared_ptr<ClientData> client)
 		if(!client) return;
 		GD::bl->fileDescriptorManager.close(client->fileDescriptor);
 		client->closed = true;
+		//Busy clients are closed by stop() only, which joins the thread after the workers are stopped.
+		if(!client->busy) GD::bl->threadManager.join(client->scriptThread);
+		std::lock_guard<std::mutex> stateGuard(_stateMutex);
+		_clients.erase(client->id);
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+void Server::wakeUp()
+{
+	try
+	{
+		if(_wakeUpPipe[1] == -1) return;
+		char data = 0;
+		//When the pipe is full, the main thread is woken up anyway, so the result can be ignored.
+		if(write(_wakeUpPipe[1], &data, 1) == -1) return;
 	}
 	catch(const std::exception& ex)
     {
@@ -190,53 +188,63 @@ void Server::mainThread()
 	try
 	{
 		getFileDescriptor(true); //Deletes an existing socket file
-		std::shared_ptr<BaseLib::FileDescriptor> clientFileDescriptor;
+		std::vector<pollfd> pollFileDescriptors;
+		std::vector<std::shared_ptr<ClientData>> polledClients;
 		while(!_stopServer)
 		{
 			try
 			{
-				//Don't lock _stateMutex => no synchronisation needed
-				if(_clients.size() > GD::bl->settings.cliServerMaxConnections())
+				getFileDescriptor();
+				if(!_serverFileDescriptor || _serverFileDescriptor->descriptor == -1)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+					continue;
+				}
+
+				pollFileDescriptors.clear();
+				polledClients.clear();
+				pollfd pollFileDescriptor;
+				pollFileDescriptor.events = POLLIN;
+				pollFileDescriptor.revents = 0;
+				pollFileDescriptor.fd = _wakeUpPipe[0];
+				pollFileDescriptors.push_back(pollFileDescriptor);
 				{
-					collectGarbage();
-					if(_clients.size() > GD::bl->settings.cliServerMaxConnections())
+					std::lock_guard<std::mutex> stateGuard(_stateMutex);
+					GD::bl->fileDescriptorManager.lock();
+					pollFileDescriptor.fd = _serverFileDescriptor->descriptor;
+					pollFileDescriptors.push_back(pollFileDescriptor);
+					for(std::map<int32_t, std::shared_ptr<ClientData>>::iterator i = _clients.begin(); i != _clients.end(); ++i)
 					{
-						GD::out.printError("Error in CLI server: There are too many clients connected to me. Waiting for connections to close. You can increase the number of allowed connections in main.conf.");
-						std::this_thread::sleep_for(std::chrono::milliseconds(5000));
-						continue;
+						//Busy clients are polled again, when the worker executing their commands is finished.
+						if(i->second->closed || i->second->busy || i->second->fileDescriptor->descriptor == -1) continue;
+						pollFileDescriptor.fd = i->second->fileDescriptor->descriptor;
+						pollFileDescriptors.push_back(pollFileDescriptor);
+						polledClients.push_back(i->second);
 					}
+					GD::bl->fileDescriptorManager.unlock();
 				}
-				getFileDescriptor();
-				if(!_serverFileDescriptor || _serverFileDescriptor->descriptor == -1)
+				if(pollFileDescriptors.at(1).fd == -1) continue;
+
+				int32_t result = poll(pollFileDescriptors.data(), pollFileDescriptors.size(), 1000);
+				if(result == 0) continue;
+				if(result == -1)
 				{
-					std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+					if(errno == EINTR) continue;
+					GD::out.printError("Error: Could not poll CLI sockets: " + std::string(strerror(errno)));
+					std::this_thread::sleep_for(std::chrono::milliseconds(100));
 					continue;
 				}
-				clientFileDescriptor = getClientFileDescriptor();
-				if(!clientFileDescriptor || clientFileDescriptor->descriptor == -1) continue;
-			}
-			catch(const std::exception& ex)
-			{
-				GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-				continue;
-			}
-			catch(BaseLib::Exception& ex)
-			{
-				GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-				continue;
-			}
-			catch(...)
-			{
-				GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
-				continue;
-			}
-			try
-			{
-				std::shared_ptr<ClientData> clientData = std::shared_ptr<ClientData>(new ClientData(clientFileDescriptor));
-				std::lock_guard<std::mutex> stateGuard(_stateMutex);
-				clientData->id = _currentClientID++;
-				_clients[clientData->id] = clientData;
-				GD::bl->threadManager.start(clientData->readThread, false, &Server::readClient, this, clientData);
+
+				if(pollFileDescriptors.at(0).revents)
+				{
+					char buffer[100];
+					while(read(_wakeUpPipe[0], buffer, sizeof(buffer)) > 0);
+				}
+				if(pollFileDescriptors.at(1).revents) acceptClient();
+				for(uint32_t i = 2; i < pollFileDescriptors.size(); i++)
+				{
+					if(pollFileDescriptors.at(i).revents) readClient(polledClients.at(i - 2));
+				}
 			}
 			catch(const std::exception& ex)
 			{
@@ -267,39 +275,28 @@ void Server::mainThread()
     }
 }
 
-std::shared_ptr<BaseLib::FileDescriptor> Server::getClientFileDescriptor()
+void Server::acceptClient()
 {
-	std::shared_ptr<BaseLib::FileDescriptor> descriptor;
 	try
 	{
-		timeval timeout;
-		timeout.tv_sec = 1;
-		timeout.tv_usec = 0;
-		fd_set readFileDescriptor;
-		FD_ZERO(&readFileDescriptor);
-		GD::bl->fileDescriptorManager.lock();
-		int32_t nfds = _serverFileDescriptor->descriptor + 1;
-		if(nfds <= 0)
-		{
-			GD::bl->fileDescriptorManager.unlock();
-			GD::out.printError("Error: CLI server socket descriptor is invalid.");
-			return descriptor;
-		}
-		FD_SET(_serverFileDescriptor->descriptor, &readFileDescriptor);
-		GD::bl->fileDescriptorManager.unlock();
-		if(!select(nfds, &readFileDescriptor, NULL, NULL, &timeout))
+		sockaddr_un clientAddress;
+		socklen_t addressSize = sizeof(clientAddress);
+		std::shared_ptr<BaseLib::FileDescriptor> descriptor = GD::bl->fileDescriptorManager.add(accept(_serverFileDescriptor->descriptor, (struct sockaddr *) &clientAddress, &addressSize));
+		if(!descriptor || descriptor->descriptor == -1) return;
+
+		std::shared_ptr<ClientData> clientData = std::shared_ptr<ClientData>(new ClientData(descriptor));
 		{
-			if(GD::bl->hf.getTime() - _lastGargabeCollection > 60000 || _clients.size() > GD::bl->settings.cliServerMaxConnections() * 100 / 112) collectGarbage();
-			return descriptor;
+			std::lock_guard<std::mutex> stateGuard(_stateMutex);
+			if(_clients.size() >= GD::bl->settings.cliServerMaxConnections())
+			{
+				GD::out.printError("Error in CLI server: There are too many clients connected to me. Closing new connection. You can increase the number of allowed connections in main.conf.");
+				GD::bl->fileDescriptorManager.close(descriptor);
+				return;
+			}
+			clientData->id = _currentClientID++;
+			_clients[clientData->id] = clientData;
 		}
-
-		sockaddr_un clientAddress;
-		socklen_t addressSize = sizeof(addressSize);
-		descriptor = GD::bl->fileDescriptorManager.add(accept(_serverFileDescriptor->descriptor, (struct sockaddr *) &clientAddress, &addressSize));
-		if(descriptor->descriptor == -1) return descriptor;
 		GD::out.printInfo("Info: CLI connection accepted. Client number: " + std::to_string(descriptor->id));
-
-		return descriptor;
 	}
     catch(const std::exception& ex)
     {
@@ -313,7 +310,6 @@ std::shared_ptr<BaseLib::FileDescriptor> Server::getClientFileDescriptor()
     {
     	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
     }
-    return descriptor;
 }
 
 void Server::getFileDescriptor(bool deleteOldSocket)
@@ -390,60 +386,63 @@ void Server::readClient(std::shared_ptr<ClientData> clientData)
 {
 	try
 	{
-		std::string unselect = "unselect";
-		GD::familyController->handleCliCommand(unselect);
-		GD::familyController->handleCliCommand(unselect);
-		GD::familyController->handleCliCommand(unselect);
-		GD::familyController->handleCliCommand(unselect);
-
 		int32_t bufferMax = 1024;
 		char buffer[bufferMax + 1];
-		std::shared_ptr<std::vector<char>> packet(new std::vector<char>());
-		int32_t bytesRead;
-		GD::out.printDebug("Listening for incoming commands from client number " + std::to_string(clientData->fileDescriptor->id) + ".");
-		while(!_stopServer)
+		int32_t bytesRead = read(clientData->fileDescriptor->descriptor, buffer, bufferMax);
+		if(bytesRead <= 0)
 		{
-			//Timeout needs to be set every time, so don't put it outside of the while loop
-			timeval timeout;
-			timeout.tv_sec = 2;
-			timeout.tv_usec = 0;
-			fd_set readFileDescriptor;
-			FD_ZERO(&readFileDescriptor);
-			GD::bl->fileDescriptorManager.lock();
-			int32_t nfds = clientData->fileDescriptor->descriptor + 1;
-			if(nfds <= 0)
+			GD::out.printDebug("Connection to client number " + std::to_string(clientData->fileDescriptor->id) + " closed.");
+			closeClientConnection(clientData);
+			return;
+		}
+
+		std::vector<std::pair<std::string, std::string>> commands;
+		if(clientData->firstPacket)
+		{
+			clientData->firstPacket = false;
+			if((unsigned)bytesRead >= channelHandshake.size() && channelHandshake.compare(0, channelHandshake.size(), buffer, channelHandshake.size()) == 0)
 			{
-				GD::bl->fileDescriptorManager.unlock();
-				GD::out.printDebug("Connection to client number " + std::to_string(clientData->fileDescriptor->id) + " closed.");
-				closeClientConnection(clientData);
-				return;
+				GD::out.printDebug("Debug: Client number " + std::to_string(clientData->fileDescriptor->id) + " opened a command channel.");
+				clientData->channel = true;
+				clientData->buffer.insert(clientData->buffer.end(), buffer + channelHandshake.size(), buffer + bytesRead);
 			}
-			FD_SET(clientData->fileDescriptor->descriptor, &readFileDescriptor);
-			GD::bl->fileDescriptorManager.unlock();
-			bytesRead = select(nfds, &readFileDescriptor, NULL, NULL, &timeout);
-			if(bytesRead == 0) continue;
-			if(bytesRead != 1)
+		}
+		else if(clientData->channel) clientData->buffer.insert(clientData->buffer.end(), buffer, buffer + bytesRead);
+
+		//Packets starting with 0 are keep alive packets of the interactive client.
+		if(!clientData->channel && buffer[0] != 0) commands.push_back(std::pair<std::string, std::string>("", std::string(buffer, bytesRead)));
+
+		if(clientData->channel)
+		{
+			std::string::size_type lineStart = 0;
+			std::string::size_type lineEnd = 0;
+			while((lineEnd = clientData->buffer.find('\n', lineStart)) != std::string::npos)
 			{
-				GD::out.printDebug("Connection to client number " + std::to_string(clientData->fileDescriptor->id) + " closed.");
-				closeClientConnection(clientData);
-				return;
+				std::string line = clientData->buffer.substr(lineStart, lineEnd - lineStart);
+				lineStart = lineEnd + 1;
+				std::string::size_type idEnd = line.find(' ');
+				if(idEnd == std::string::npos) commands.push_back(std::pair<std::string, std::string>(line, ""));
+				else commands.push_back(std::pair<std::string, std::string>(line.substr(0, idEnd), line.substr(idEnd + 1)));
 			}
-
-			bytesRead = read(clientData->fileDescriptor->descriptor, buffer, bufferMax);
-			if(bytesRead <= 0)
+			clientData->buffer.erase(0, lineStart);
+			if(clientData->buffer.size() > _maxChannelBufferSize)
 			{
-				GD::out.printDebug("Connection to client number " + std::to_string(clientData->fileDescriptor->id) + " closed.");
+				GD::out.printError("Error: Command received from CLI client number " + std::to_string(clientData->fileDescriptor->id) + " is too long. Closing connection.");
 				closeClientConnection(clientData);
-				//If we close the socket, the socket file gets deleted. We don't want that
-				//GD::bl->fileDescriptorManager.close(_serverFileDescriptor);
 				return;
 			}
+		}
 
-			std::string command;
-			command.insert(command.end(), buffer, buffer + bytesRead);
-			handleCommand(command, clientData);
+		if(commands.empty()) return;
+		clientData->busy = true;
+		std::shared_ptr<BaseLib::IQueueEntry> entry(new QueueEntry(clientData, commands));
+		_queueDepth->increment();
+		if(!enqueue(0, entry))
+		{
+			_queueDepth->decrement();
+			GD::out.printError("Error: Too many CLI commands are queued. Closing connection to client number " + std::to_string(clientData->fileDescriptor->id) + ".");
+			closeClientConnection(clientData);
 		}
-		closeClientConnection(clientData);
 	}
     catch(const std::exception& ex)
     {
@@ -958,6 +957,7 @@ std::string Server::handleGlobalCommand(std::string& command)
 			stringStream << "scriptcount (sc)\t\tReturns the number of currently running scripts" << std::endl;
 			stringStream << "rpcservers (rpc)\t\tLists all active RPC servers" << std::endl;
 			stringStream << "rpcclients (rcl)\t\tLists all active RPC clients" << std::endl;
+			stringStream << "rpcstatistics (rps)\tPrints call counts and latencies of RPC methods and clients" << std::endl;
 			stringStream << "threads\t\tPrints current thread count" << std::endl;
 			stringStream << "users [COMMAND]\t\tExecute user commands. Type \"users help\" for more information." << std::endl;
 			stringStream << "families [COMMAND]\tExecute device family commands. Type \"families help\" for more information." << std::endl;
@@ -1111,6 +1111,88 @@ std::string Server::handleGlobalCommand(std::string& command)
 			stringStream << std::dec << GD::scriptEngineServer->scriptCount() << std::endl;
 			return stringStream.str();
 		}
+		else if(command.compare(0, 13, "rpcstatistics") == 0 || command.compare(0, 3, "rps") == 0)
+		{
+			std::stringstream stream(command);
+			std::string element;
+			bool reset = false;
+
+			int32_t index = 0;
+			while(std::getline(stream, element, ' '))
+			{
+				if(index == 0)
+				{
+					index++;
+					continue;
+				}
+				else if(index == 1)
+				{
+					if(element == "reset") reset = true;
+					else
+					{
+						index = -1;
+						break;
+					}
+				}
+				index++;
+			}
+			if(index == -1)
+			{
+				stringStream << "Description: This command prints the number of calls, the number of errors and the 50th percentile, the 99th percentile and the maximum of the execution time of all RPC methods and RPC clients since start or since the last reset. Times are in microseconds." << std::endl;
+				stringStream << "Usage: rpcstatistics [reset]" << std::endl << std::endl;
+				stringStream << "Parameters:" << std::endl;
+				stringStream << "  reset:\tSets all statistics to zero after printing them." << std::endl;
+				return stringStream.str();
+			}
+
+			BaseLib::PVariable statistics = GD::rpcStatistics.getStatistics();
+			if(reset) GD::rpcStatistics.reset();
+			if(statistics->errorStruct) return "Error reading RPC statistics. See log file for more details.\n";
+
+			int32_t nameWidth = 40;
+			int32_t callsWidth = 10;
+			int32_t errorsWidth = 8;
+			int32_t timeWidth = 10;
+			std::vector<std::pair<std::string, std::string>> sections{ std::pair<std::string, std::string>("METHODS", "Method"), std::pair<std::string, std::string>("CLIENTS", "Client") };
+			for(std::vector<std::pair<std::string, std::string>>::iterator i = sections.begin(); i != sections.end(); ++i)
+			{
+				BaseLib::Struct::iterator sectionIterator = statistics->structValue->find(i->first);
+				if(sectionIterator == statistics->structValue->end()) continue;
+
+				std::string nameCaption(i->second);
+				nameCaption.resize(nameWidth, ' ');
+				stringStream << std::setfill(' ')
+					<< nameCaption << "  "
+					<< std::setw(callsWidth) << "Calls" << "  "
+					<< std::setw(errorsWidth) << "Errors" << "  "
+					<< std::setw(timeWidth) << "P50" << "  "
+					<< std::setw(timeWidth) << "P99" << "  "
+					<< std::setw(timeWidth) << "Max" << "  "
+					<< std::endl;
+
+				for(BaseLib::Struct::iterator j = sectionIterator->second->structValue->begin(); j != sectionIterator->second->structValue->end(); ++j)
+				{
+					std::string name = j->first;
+					if(name.size() > (unsigned)nameWidth)
+					{
+						name.resize(nameWidth - 3);
+						name += "...";
+					}
+					else name.resize(nameWidth, ' ');
+					stringStream
+						<< name << "  "
+						<< std::setw(callsWidth) << j->second->structValue->at("CALLS")->integerValue64 << "  "
+						<< std::setw(errorsWidth) << j->second->structValue->at("ERRORS")->integerValue64 << "  "
+						<< std::setw(timeWidth) << j->second->structValue->at("P50")->integerValue64 << "  "
+						<< std::setw(timeWidth) << j->second->structValue->at("P99")->integerValue64 << "  "
+						<< std::setw(timeWidth) << j->second->structValue->at("MAX")->integerValue64 << "  "
+						<< std::endl;
+				}
+				stringStream << std::endl;
+			}
+			if(reset) stringStream << "Statistics reset." << std::endl;
+			return stringStream.str();
+		}
 		else if(command.compare(0, 10, "rpcclients") == 0 || command.compare(0, 3, "rcl") == 0)
 		{
 			std::stringstream stream(command);
@@ -1404,4 +1486,106 @@ void Server::send(std::shared_ptr<ClientData> client, std::string& data)
     }
 }
 
+void Server::handleChannelCommand(std::string& id, std::string& command, std::shared_ptr<ClientData> clientData)
+{
+	try
+	{
+		std::string response = handleCommand(command);
+		std::string packet = id + ' ' + std::to_string(response.size()) + '\n' + response;
+		send(clientData, packet);
+	}
+    catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+bool Server::isScriptCommand(const std::string& command)
+{
+	return command.compare(0, 9, "runscript") == 0 || command.compare(0, 2, "rs") == 0 || command.compare(0, 10, "runcommand") == 0 || command.compare(0, 2, "rc") == 0 || command.compare(0, 1, "$") == 0;
+}
+
+void Server::processQueueEntry(int32_t index, std::shared_ptr<BaseLib::IQueueEntry>& entry)
+{
+	try
+	{
+		_queueDepth->decrement();
+		std::shared_ptr<QueueEntry> queueEntry = std::dynamic_pointer_cast<QueueEntry>(entry);
+		if(!queueEntry || !queueEntry->clientData) return;
+
+		for(std::vector<std::pair<std::string, std::string>>::iterator i = queueEntry->commands.begin(); i != queueEntry->commands.end(); ++i)
+		{
+			if(!isScriptCommand(i->second)) continue;
+			//Don't block a worker until the script is finished. The previous script thread of the client is finished already, because the client is busy until then.
+			GD::bl->threadManager.join(queueEntry->clientData->scriptThread);
+			if(GD::bl->threadManager.start(queueEntry->clientData->scriptThread, false, &Server::processCommands, this, queueEntry)) return;
+			GD::out.printWarning("Warning: Could not start script thread for CLI client number " + std::to_string(queueEntry->clientData->fileDescriptor->id) + ". Executing commands on worker thread.");
+			break;
+		}
+		processCommands(queueEntry);
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+void Server::processCommands(std::shared_ptr<QueueEntry> queueEntry)
+{
+	std::shared_ptr<ClientData> clientData;
+	try
+	{
+		clientData = queueEntry->clientData;
+		if(!clientData->initialized)
+		{
+			clientData->initialized = true;
+			std::string unselect = "unselect";
+			GD::familyController->handleCliCommand(unselect);
+			GD::familyController->handleCliCommand(unselect);
+			GD::familyController->handleCliCommand(unselect);
+			GD::familyController->handleCliCommand(unselect);
+		}
+
+		for(std::vector<std::pair<std::string, std::string>>::iterator i = queueEntry->commands.begin(); i != queueEntry->commands.end(); ++i)
+		{
+			if(clientData->closed || _stopServer) break;
+			if(clientData->channel) handleChannelCommand(i->first, i->second, clientData);
+			else handleCommand(i->second, clientData);
+		}
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    if(clientData)
+    {
+    	clientData->busy = false;
+    	wakeUp();
+    }
+}
+
 }
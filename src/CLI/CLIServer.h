@@ -34,25 +34,39 @@
 #include "homegear-base/BaseLib.h"
 #include "../User/User.h"
 #include "../Systems/FamilyController.h"
+#include "../Metrics/Metrics.h"
 
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/un.h>
+#include <poll.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <string.h>
 
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <vector>
 #include <iostream>
 #include <string>
 
 namespace CLI {
 
-class Server {
+/**
+ * The CLI server. All connections are watched by one thread using poll(). Received commands are executed by a small pool of worker threads.
+ * Scripts can run for a long time and might connect to the CLI server themselves, so they are executed on a thread of the client instead.
+ *
+ * A client sending "channelHandshake" as its first data switches the connection into channel mode. In channel mode every request is a line
+ * "<ID> <COMMAND>\n" and every response is framed as "<ID> <SIZE>\n" followed by SIZE bytes of output. This allows scripts to send any number of
+ * commands over one connection without waiting for each response first.
+ */
+class Server : public BaseLib::IQueue {
 public:
+	static const std::string channelHandshake;
+
 	Server();
 	virtual ~Server();
 
@@ -63,40 +77,82 @@ private:
 	class ClientData
 	{
 	public:
-		ClientData() { fileDescriptor = std::shared_ptr<BaseLib::FileDescriptor>(new BaseLib::FileDescriptor); }
-		ClientData(std::shared_ptr<BaseLib::FileDescriptor> clientFileDescriptor) { fileDescriptor = clientFileDescriptor; }
+		ClientData() { busy = false; fileDescriptor = std::shared_ptr<BaseLib::FileDescriptor>(new BaseLib::FileDescriptor); }
+		ClientData(std::shared_ptr<BaseLib::FileDescriptor> clientFileDescriptor) { busy = false; fileDescriptor = clientFileDescriptor; }
 		virtual ~ClientData() {}
 
 		int32_t id = 0;
 		bool closed = false;
+		bool initialized = false;
+		bool firstPacket = true;
+		bool channel = false;
+
+		/**
+		 * Set while commands of the client are executed. The client is not polled in the meantime, so the commands of one client are executed in order.
+		 */
+		std::atomic_bool busy;
+		std::string buffer;
 		std::shared_ptr<BaseLib::FileDescriptor> fileDescriptor;
-		std::thread readThread;
 		std::mutex sendMutex;
+
+		/**
+		 * Executes commands running scripts. Only accessed while "busy" is set or by the main thread while "busy" is not set.
+		 */
+		std::thread scriptThread;
+	};
+
+	class QueueEntry : public BaseLib::IQueueEntry
+	{
+	public:
+		QueueEntry() {}
+		QueueEntry(std::shared_ptr<ClientData>& clientData, std::vector<std::pair<std::string, std::string>>& commands) { this->clientData = clientData; this->commands = commands; }
+		virtual ~QueueEntry() {}
+
+		std::shared_ptr<ClientData> clientData;
+
+		/**
+		 * Pairs of command ID and command. The ID is only used in channel mode.
+		 */
+		std::vector<std::pair<std::string, std::string>> commands;
 	};
 
 	std::string _socketPath;
 	bool _stopServer = false;
+	bool _started = false;
 	std::thread _mainThread;
 	int32_t _backlog = 10;
+	int32_t _workerThreads = 5;
+	uint32_t _maxChannelBufferSize = 1048576;
 	std::shared_ptr<BaseLib::FileDescriptor> _serverFileDescriptor;
-	int32_t _maxConnections = 50;
+	int32_t _wakeUpPipe[2];
 	std::mutex _stateMutex;
 	std::map<int32_t, std::shared_ptr<ClientData>> _clients;
 	static int32_t _currentClientID;
-	std::mutex _garbageCollectionMutex;
-	int64_t _lastGargabeCollection = 0;
+	Metrics::PQueueDepth _queueDepth;
 
-	void collectGarbage();
 	void handleCommand(std::string& command, std::shared_ptr<ClientData> clientData);
+	void handleChannelCommand(std::string& id, std::string& command, std::shared_ptr<ClientData> clientData);
 	std::string handleUserCommand(std::string& command);
 	std::string handleModuleCommand(std::string& command);
 	std::string handleGlobalCommand(std::string& command);
 	void getFileDescriptor(bool deleteOldSocket = false);
-	std::shared_ptr<BaseLib::FileDescriptor> getClientFileDescriptor();
+	void acceptClient();
 	void mainThread();
+	void wakeUp();
 	void readClient(std::shared_ptr<ClientData> clientData);
 	void closeClientConnection(std::shared_ptr<ClientData> client);
 	void send(std::shared_ptr<ClientData> client, std::string& data);
+	void processQueueEntry(int32_t index, std::shared_ptr<BaseLib::IQueueEntry>& entry);
+
+	/**
+	 * Checks if a command executes a script and blocks until the script is finished.
+	 */
+	bool isScriptCommand(const std::string& command);
+
+	/**
+	 * Executes the commands of a queue entry and makes the client available for polling again.
+	 */
+	void processCommands(std::shared_ptr<QueueEntry> queueEntry);
 };
 
 }
@@ -36,6 +36,7 @@
 
 EventHandler::EventHandler() : BaseLib::IQueue(GD::bl.get(), 1000)
 {
+	_queueDepth = GD::metrics.queueDepth("eventHandler");
 }
 
 EventHandler::~EventHandler()
@@ -49,6 +50,7 @@ void EventHandler::dispose()
 	_disposing = true;
 	GD::bl->threadManager.join(_mainThread);
 	stopQueue(0);
+	_queueDepth->clear();
 	_timedEvents.clear();
 	_triggeredEvents.clear();
 	_eventsToReset.clear();
@@ -85,7 +87,8 @@ void EventHandler::mainThread()
 				if(event->enabled)
 				{
 					std::shared_ptr<BaseLib::IQueueEntry> queueEntry(new QueueEntry(event->name, event->eventMethod,  event->eventMethodParameters));
-					enqueue(0, queueEntry);
+					_queueDepth->increment();
+					if(!enqueue(0, queueEntry)) _queueDepth->decrement();
 					event->lastRaised = currentTime;
 				}
 				save(event);
@@ -123,7 +126,8 @@ void EventHandler::mainThread()
 
 				GD::out.printInfo("Info: Resetting event " + event->name + ".");
 				std::shared_ptr<BaseLib::IQueueEntry> queueEntry(new QueueEntry(event->name, event->resetMethod, event->resetMethodParameters));
-				enqueue(0, queueEntry);
+				_queueDepth->increment();
+				if(!enqueue(0, queueEntry)) _queueDepth->decrement();
 				event->lastReset = currentTime;
 				removeEventToReset(event->id);
 				save(event);
@@ -660,7 +664,8 @@ void EventHandler::trigger(uint64_t peerID, int32_t channel, std::shared_ptr<std
 	{
 		if(_disposing) return;
 		std::shared_ptr<BaseLib::IQueueEntry> queueEntry(new QueueEntry(peerID, channel, variables, values));
-		enqueue(0, queueEntry);
+		_queueDepth->increment();
+		if(!enqueue(0, queueEntry)) _queueDepth->decrement();
 	}
 	catch(const std::exception& ex)
     {
@@ -707,7 +712,8 @@ void EventHandler::trigger(std::string& variable, BaseLib::PVariable& value)
 	{
 		if(_disposing) return;
 		std::shared_ptr<BaseLib::IQueueEntry> queueEntry(new QueueEntry(0, -1, variable, value));
-		enqueue(0, queueEntry);
+		_queueDepth->increment();
+		if(!enqueue(0, queueEntry)) _queueDepth->decrement();
 	}
 	catch(const std::exception& ex)
     {
@@ -729,7 +735,8 @@ void EventHandler::trigger(uint64_t peerID, int32_t channel, std::string& variab
 	{
 		if(_disposing) return;
 		std::shared_ptr<BaseLib::IQueueEntry> queueEntry(new QueueEntry(peerID, channel, variable, value));
-		enqueue(0, queueEntry);
+		_queueDepth->increment();
+		if(!enqueue(0, queueEntry)) _queueDepth->decrement();
 	}
 	catch(const std::exception& ex)
     {
@@ -1076,6 +1083,7 @@ void EventHandler::processQueueEntry(int32_t index, std::shared_ptr<BaseLib::IQu
 {
 	try
 	{
+		_queueDepth->decrement();
 		std::shared_ptr<QueueEntry> queueEntry;
 		queueEntry = std::dynamic_pointer_cast<QueueEntry>(entry);
 		if(!queueEntry) return;
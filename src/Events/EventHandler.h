@@ -159,6 +159,7 @@ protected:
 	};
 
 	bool _disposing = false;
+	Metrics::PQueueDepth _queueDepth;
 	std::mutex _eventsMutex;
 	std::map<uint64_t, std::shared_ptr<Event>> _timedEvents;
 	std::map<uint64_t, std::map<int32_t, std::map<std::string, std::vector<std::shared_ptr<Event>>>>> _triggeredEvents;
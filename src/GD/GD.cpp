@@ -46,8 +46,16 @@ std::unique_ptr<FamilyController> GD::familyController;
 std::unique_ptr<LicensingController> GD::licensingController;
 std::map<int32_t, RPC::Server> GD::rpcServers;
 std::unique_ptr<RPC::Client> GD::rpcClient;
+std::unique_ptr<RPC::ParallelCallPool> GD::parallelCallPool;
 std::unique_ptr<CLI::Server> GD::cliServer;
 int32_t GD::rpcLogLevel = 1;
+bool GD::peerSnapshot = false;
+int64_t GD::metadataCacheSize = 10485760;
+int32_t GD::multicallParallelism = 1;
+int32_t GD::healthCheckInterval = 10;
+int32_t GD::healthCheckTimeout = 60;
+Metrics GD::metrics;
+RPC::RpcStatistics GD::rpcStatistics;
 BaseLib::Rpc::ServerInfo GD::serverInfo;
 RPC::ClientSettings GD::clientSettings;
 std::map<int32_t, std::unique_ptr<BaseLib::Licensing::Licensing>> GD::licensingModules;
@@ -41,6 +41,9 @@
 #include "homegear-base/BaseLib.h"
 #include "../RPC/Server.h"
 #include "../RPC/Client.h"
+#include "../RPC/ParallelCallPool.h"
+#include "../Metrics/Metrics.h"
+#include "../RPC/RpcStatistics.h"
 
 #include <vector>
 #include <map>
@@ -67,11 +70,19 @@ public:
 	//We can work with rpcServers without Mutex, because elements are never deleted and iterators are not invalidated upon insertion of new elements.
 	static std::map<int32_t, RPC::Server> rpcServers;
 	static std::unique_ptr<RPC::Client> rpcClient;
+	static std::unique_ptr<RPC::ParallelCallPool> parallelCallPool;
 	static std::unique_ptr<ScriptEngine::ScriptEngineServer> scriptEngineServer;
 	static std::unique_ptr<CLI::Server> cliServer;
 	static BaseLib::Rpc::ServerInfo serverInfo;
 	static RPC::ClientSettings clientSettings;
 	static int32_t rpcLogLevel;
+	static bool peerSnapshot;
+	static int64_t metadataCacheSize;
+	static int32_t multicallParallelism;
+	static int32_t healthCheckInterval;
+	static int32_t healthCheckTimeout;
+	static Metrics metrics;
+	static RPC::RpcStatistics rpcStatistics;
 	static std::map<int32_t, std::unique_ptr<BaseLib::Licensing::Licensing>> licensingModules;
 	static std::unique_ptr<UPnP> uPnP;
 	static std::unique_ptr<Mqtt> mqtt;
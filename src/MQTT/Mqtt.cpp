@@ -35,6 +35,7 @@ Mqtt::Mqtt() : BaseLib::IQueue(GD::bl.get(), 1000)
 	try
 	{
 		_socket.reset(new BaseLib::SocketOperations(GD::bl.get()));
+		_queueDepth = GD::metrics.queueDepth("mqtt");
 	}
 	catch(const std::exception& ex)
 	{
@@ -117,6 +118,7 @@ void Mqtt::stop()
 	{
 		_started = false;
 		stopQueue(0);
+		_queueDepth->clear();
 		disconnect();
 		GD::bl->threadManager.join(_pingThread);
 		GD::bl->threadManager.join(_listenThread);
@@ -991,7 +993,12 @@ void Mqtt::queueMessage(std::shared_ptr<std::pair<std::string, std::vector<char>
 	{
 		if(!_started || !message) return;
 		std::shared_ptr<BaseLib::IQueueEntry> entry(new QueueEntry(message));
-		if(!enqueue(0, entry)) _out.printError("Error: Too many packets are queued to be processed. Your packet processing is too slow. Dropping packet.");
+		_queueDepth->increment();
+		if(!enqueue(0, entry))
+		{
+			_queueDepth->decrement();
+			_out.printError("Error: Too many packets are queued to be processed. Your packet processing is too slow. Dropping packet.");
+		}
 	}
 	catch(const std::exception& ex)
 	{
@@ -1081,6 +1088,7 @@ void Mqtt::processQueueEntry(int32_t index, std::shared_ptr<BaseLib::IQueueEntry
 {
 	try
 	{
+		_queueDepth->decrement();
 		std::shared_ptr<QueueEntry> queueEntry;
 		queueEntry = std::dynamic_pointer_cast<QueueEntry>(entry);
 		if(!queueEntry || !queueEntry->message) return;
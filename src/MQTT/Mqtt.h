@@ -34,6 +34,7 @@
 #include "homegear-base/BaseLib.h"
 
 #include "MqttSettings.h"
+#include "../Metrics/Metrics.h"
 
 class Mqtt : public BaseLib::IQueue
 {
@@ -99,6 +100,7 @@ private:
 
 	BaseLib::Output _out;
 	MqttSettings _settings;
+	Metrics::PQueueDepth _queueDepth;
 	std::unique_ptr<BaseLib::RPC::JsonEncoder> _jsonEncoder;
 	std::unique_ptr<BaseLib::RPC::JsonDecoder> _jsonDecoder;
 	std::unique_ptr<BaseLib::SocketOperations> _socket;
@@ -0,0 +1,370 @@
+/* Copyright 2013-2016 Sathya Laufer
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Homegear.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ * 
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "Metrics.h"
+#include "../GD/GD.h"
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+void Metrics::Histogram::record(int64_t microseconds)
+{
+	if(microseconds < 0) microseconds = 0;
+	int32_t index = 0;
+	if(microseconds < subBucketCount) index = (int32_t)microseconds;
+	else
+	{
+		int32_t exponent = 63 - __builtin_clzll((uint64_t)microseconds);
+		int32_t subBucket = (int32_t)((microseconds >> (exponent - subBucketBits)) & (subBucketCount - 1));
+		index = (exponent - subBucketBits + 1) * subBucketCount + subBucket;
+		if(index >= bucketCount) index = bucketCount - 1;
+	}
+	_buckets[index].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add((uint64_t)microseconds, std::memory_order_relaxed);
+	int64_t max = _max.load(std::memory_order_relaxed);
+	while(microseconds > max && !_max.compare_exchange_weak(max, microseconds, std::memory_order_relaxed));
+}
+
+void Metrics::Histogram::reset()
+{
+	for(int32_t i = 0; i < bucketCount; i++) _buckets[i].store(0, std::memory_order_relaxed);
+	_count.store(0, std::memory_order_relaxed);
+	_sum.store(0, std::memory_order_relaxed);
+	_max.store(0, std::memory_order_relaxed);
+}
+
+int64_t Metrics::Histogram::bucketUpperBound(int32_t index)
+{
+	if(index < subBucketCount) return index;
+	int32_t exponent = index / subBucketCount + subBucketBits - 1;
+	int64_t subBucket = index % subBucketCount;
+	return ((subBucketCount + subBucket + 1) << (exponent - subBucketBits)) - 1;
+}
+
+int64_t Metrics::Histogram::quantile(double quantile)
+{
+	uint64_t total = 0;
+	uint64_t counts[bucketCount];
+	for(int32_t i = 0; i < bucketCount; i++)
+	{
+		counts[i] = _buckets[i].load(std::memory_order_relaxed);
+		total += counts[i];
+	}
+	if(total == 0) return 0;
+	uint64_t rank = (uint64_t)(quantile * total);
+	if(rank >= total) rank = total - 1;
+	uint64_t current = 0;
+	for(int32_t i = 0; i < bucketCount; i++)
+	{
+		current += counts[i];
+		if(current > rank) return bucketUpperBound(i);
+	}
+	return bucketUpperBound(bucketCount - 1);
+}
+
+Metrics::Metrics()
+{
+}
+
+Metrics::~Metrics()
+{
+}
+
+int64_t Metrics::getTime()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Metrics::Family& Metrics::getFamily(const std::string& name, const std::string& help, const std::string& type)
+{
+	Family& family = _families[name];
+	if(family.type.empty())
+	{
+		family.help = help;
+		family.type = type;
+	}
+	else if(family.type != type) GD::out.printWarning("Warning: Metric " + name + " is registered with type " + family.type + " and " + type + ".");
+	return family;
+}
+
+std::string Metrics::getLabel(const std::string& labelName, const std::string& labelValue)
+{
+	if(labelName.empty()) return "";
+	std::string label = labelName + "=\"";
+	label.reserve(label.size() + labelValue.size() + 1);
+	for(std::string::const_iterator i = labelValue.begin(); i != labelValue.end(); ++i)
+	{
+		if(*i == '\\') label.append("\\\\");
+		else if(*i == '"') label.append("\\\"");
+		else if(*i == '\n') label.append("\\n");
+		else label.push_back(*i);
+	}
+	label.push_back('"');
+	return label;
+}
+
+std::string Metrics::getSeconds(uint64_t microseconds)
+{
+	std::ostringstream stream;
+	stream << (microseconds / 1000000) << '.' << std::setw(6) << std::setfill('0') << (microseconds % 1000000);
+	return stream.str();
+}
+
+Metrics::PCounter Metrics::counter(const std::string& name, const std::string& help, const std::string& labelName, const std::string& labelValue)
+{
+	try
+	{
+		std::lock_guard<std::mutex> familiesGuard(_familiesMutex);
+		PCounter& counter = getFamily(name, help, "counter").counters[getLabel(labelName, labelValue)];
+		if(!counter) counter.reset(new Counter());
+		return counter;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return PCounter(new Counter());
+}
+
+Metrics::PGauge Metrics::gauge(const std::string& name, const std::string& help, const std::string& labelName, const std::string& labelValue)
+{
+	try
+	{
+		std::lock_guard<std::mutex> familiesGuard(_familiesMutex);
+		PGauge& gauge = getFamily(name, help, "gauge").gauges[getLabel(labelName, labelValue)];
+		if(!gauge) gauge.reset(new Gauge());
+		return gauge;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return PGauge(new Gauge());
+}
+
+Metrics::PQueueDepth Metrics::queueDepth(const std::string& queueName)
+{
+	return PQueueDepth(new QueueDepth(gauge("homegear_queue_depth", "Number of entries waiting in a queue.", "queue", queueName)));
+}
+
+Metrics::PHistogram Metrics::histogram(const std::string& name, const std::string& help, const std::string& labelName, const std::string& labelValue)
+{
+	try
+	{
+		std::lock_guard<std::mutex> familiesGuard(_familiesMutex);
+		PHistogram& histogram = getFamily(name, help, "histogram").histograms[getLabel(labelName, labelValue)];
+		if(!histogram) histogram.reset(new Histogram());
+		return histogram;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return PHistogram(new Histogram());
+}
+
+void Metrics::registerGaugeCallback(const std::string& name, const std::string& help, std::function<int64_t()> callback)
+{
+	try
+	{
+		std::lock_guard<std::mutex> familiesGuard(_familiesMutex);
+		getFamily(name, help, "gauge").callback = callback;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+void Metrics::unregisterGaugeCallback(const std::string& name)
+{
+	try
+	{
+		std::lock_guard<std::mutex> familiesGuard(_familiesMutex);
+		std::map<std::string, Family>::iterator familyIterator = _families.find(name);
+		if(familyIterator == _families.end()) return;
+		familyIterator->second.callback = std::function<int64_t()>();
+		if(familyIterator->second.gauges.empty()) _families.erase(familyIterator);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+std::string Metrics::getPrometheusText()
+{
+	try
+	{
+		std::ostringstream text;
+		std::lock_guard<std::mutex> familiesGuard(_familiesMutex);
+		for(std::map<std::string, Family>::iterator i = _families.begin(); i != _families.end(); ++i)
+		{
+			text << "# HELP " << i->first << ' ' << i->second.help << '\n';
+			text << "# TYPE " << i->first << ' ' << i->second.type << '\n';
+			for(std::map<std::string, PCounter>::iterator j = i->second.counters.begin(); j != i->second.counters.end(); ++j)
+			{
+				text << i->first;
+				if(!j->first.empty()) text << '{' << j->first << '}';
+				text << ' ' << j->second->value() << '\n';
+			}
+			for(std::map<std::string, PGauge>::iterator j = i->second.gauges.begin(); j != i->second.gauges.end(); ++j)
+			{
+				text << i->first;
+				if(!j->first.empty()) text << '{' << j->first << '}';
+				text << ' ' << j->second->value() << '\n';
+			}
+			if(i->second.callback) text << i->first << ' ' << i->second.callback() << '\n';
+			for(std::map<std::string, PHistogram>::iterator j = i->second.histograms.begin(); j != i->second.histograms.end(); ++j)
+			{
+				std::string labelPrefix = j->first.empty() ? "" : j->first + ',';
+				uint64_t cumulativeCount = 0;
+				//Only the power of two boundaries are exported to keep the output small.
+				for(int32_t k = 0; k < Histogram::bucketCount; k++)
+				{
+					cumulativeCount += j->second->bucket(k);
+					if(k % Histogram::subBucketCount != Histogram::subBucketCount - 1 || k == Histogram::bucketCount - 1) continue;
+					text << i->first << "_bucket{" << labelPrefix << "le=\"" << getSeconds(Histogram::bucketUpperBound(k)) << "\"} " << cumulativeCount << '\n';
+				}
+				text << i->first << "_bucket{" << labelPrefix << "le=\"+Inf\"} " << j->second->count() << '\n';
+				text << i->first << "_sum";
+				if(!j->first.empty()) text << '{' << j->first << '}';
+				text << ' ' << getSeconds(j->second->sum()) << '\n';
+				text << i->first << "_count";
+				if(!j->first.empty()) text << '{' << j->first << '}';
+				text << ' ' << j->second->count() << '\n';
+			}
+		}
+		return text.str();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return "";
+}
+
+BaseLib::PVariable Metrics::getMetrics()
+{
+	try
+	{
+		BaseLib::PVariable metrics(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+		std::lock_guard<std::mutex> familiesGuard(_familiesMutex);
+		for(std::map<std::string, Family>::iterator i = _families.begin(); i != _families.end(); ++i)
+		{
+			for(std::map<std::string, PCounter>::iterator j = i->second.counters.begin(); j != i->second.counters.end(); ++j)
+			{
+				std::string name = j->first.empty() ? i->first : i->first + '{' + j->first + '}';
+				metrics->structValue->insert(BaseLib::StructElement(name, BaseLib::PVariable(new BaseLib::Variable((int64_t)j->second->value()))));
+			}
+			for(std::map<std::string, PGauge>::iterator j = i->second.gauges.begin(); j != i->second.gauges.end(); ++j)
+			{
+				std::string name = j->first.empty() ? i->first : i->first + '{' + j->first + '}';
+				metrics->structValue->insert(BaseLib::StructElement(name, BaseLib::PVariable(new BaseLib::Variable(j->second->value()))));
+			}
+			if(i->second.callback) metrics->structValue->insert(BaseLib::StructElement(i->first, BaseLib::PVariable(new BaseLib::Variable(i->second.callback()))));
+			for(std::map<std::string, PHistogram>::iterator j = i->second.histograms.begin(); j != i->second.histograms.end(); ++j)
+			{
+				std::string name = j->first.empty() ? i->first : i->first + '{' + j->first + '}';
+				BaseLib::PVariable histogram(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+				histogram->structValue->insert(BaseLib::StructElement("COUNT", BaseLib::PVariable(new BaseLib::Variable((int64_t)j->second->count()))));
+				histogram->structValue->insert(BaseLib::StructElement("SUM", BaseLib::PVariable(new BaseLib::Variable((int64_t)j->second->sum()))));
+				histogram->structValue->insert(BaseLib::StructElement("P50", BaseLib::PVariable(new BaseLib::Variable(j->second->quantile(0.5)))));
+				histogram->structValue->insert(BaseLib::StructElement("P90", BaseLib::PVariable(new BaseLib::Variable(j->second->quantile(0.9)))));
+				histogram->structValue->insert(BaseLib::StructElement("P99", BaseLib::PVariable(new BaseLib::Variable(j->second->quantile(0.99)))));
+				metrics->structValue->insert(BaseLib::StructElement(name, histogram));
+			}
+		}
+		return metrics;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
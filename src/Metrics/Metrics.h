@@ -0,0 +1,217 @@
+/* Copyright 2013-2016 Sathya Laufer
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Homegear.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ * 
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include "homegear-base/BaseLib.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <string>
+
+/**
+ * Registry of counters, gauges and latency histograms.
+ *
+ * Metrics are registered once (e.g. in a constructor or in init()) and the returned pointers are stored by the caller. Updating a metric only uses relaxed atomic operations, so the hot paths never wait for a lock. The registry's mutex is only used for registration and export.
+ */
+class Metrics
+{
+public:
+	class Counter
+	{
+	public:
+		void increment(uint64_t value = 1) { _value.fetch_add(value, std::memory_order_relaxed); }
+		uint64_t value() { return _value.load(std::memory_order_relaxed); }
+		void reset() { _value.store(0, std::memory_order_relaxed); }
+	private:
+		std::atomic<uint64_t> _value{0};
+	};
+	typedef std::shared_ptr<Counter> PCounter;
+
+	class Gauge
+	{
+	public:
+		void increment(int64_t value = 1) { _value.fetch_add(value, std::memory_order_relaxed); }
+		void decrement(int64_t value = 1) { _value.fetch_sub(value, std::memory_order_relaxed); }
+		void set(int64_t value) { _value.store(value, std::memory_order_relaxed); }
+		int64_t value() { return _value.load(std::memory_order_relaxed); }
+	private:
+		std::atomic<int64_t> _value{0};
+	};
+	typedef std::shared_ptr<Gauge> PGauge;
+
+	/**
+	 * Counts the entries of one queue in the gauge "homegear_queue_depth", which might be shared by several queues. Call increment() before an entry
+	 * is added, so the processing thread never decrements first, and clear() after the queue stopped to subtract the entries that were never processed.
+	 */
+	class QueueDepth
+	{
+	public:
+		QueueDepth(PGauge gauge) : _gauge(gauge) {}
+
+		void increment() { _entries.fetch_add(1, std::memory_order_relaxed); _gauge->increment(); }
+		void decrement() { _entries.fetch_sub(1, std::memory_order_relaxed); _gauge->decrement(); }
+
+		/**
+		 * Returns the number of entries in this queue.
+		 */
+		int64_t value() { return _entries.load(std::memory_order_relaxed); }
+
+		/**
+		 * Removes all remaining entries of this queue from the gauge. Must not be called while the queue is processed.
+		 */
+		void clear() { _gauge->decrement(_entries.exchange(0, std::memory_order_relaxed)); }
+	private:
+		PGauge _gauge;
+		std::atomic<int64_t> _entries{0};
+	};
+	typedef std::shared_ptr<QueueDepth> PQueueDepth;
+
+	/**
+	 * HDR-style histogram of durations in microseconds. Every power of two is split into four linear sub-buckets, so each bucket is at most 25 % wide. The last
+	 * regular bucket ends at 2^41 - 1 microseconds (about 25.4 days), larger values are counted in it as well.
+	 */
+	class Histogram
+	{
+	public:
+		Histogram() { for(int32_t i = 0; i < bucketCount; i++) _buckets[i] = 0; }
+
+		static const int32_t subBucketBits = 2;
+		static const int32_t subBucketCount = 1 << subBucketBits;
+		static const int32_t bucketCount = 40 * subBucketCount;
+
+		void record(int64_t microseconds);
+		uint64_t count() { return _count.load(std::memory_order_relaxed); }
+		uint64_t sum() { return _sum.load(std::memory_order_relaxed); }
+		uint64_t bucket(int32_t index) { return _buckets[index].load(std::memory_order_relaxed); }
+
+		/**
+		 * Returns the largest recorded value in microseconds.
+		 */
+		int64_t max() { return _max.load(std::memory_order_relaxed); }
+
+		/**
+		 * Sets all buckets to zero. Values recorded at the same time might be lost or counted partially.
+		 */
+		void reset();
+
+		/**
+		 * Returns the largest value (in microseconds) counted in a bucket.
+		 */
+		static int64_t bucketUpperBound(int32_t index);
+
+		/**
+		 * Returns the upper bound of the bucket containing the given quantile.
+		 *
+		 * @param quantile A value between 0 and 1.
+		 */
+		int64_t quantile(double quantile);
+	private:
+		std::atomic<uint64_t> _buckets[bucketCount];
+		std::atomic<uint64_t> _count{0};
+		std::atomic<uint64_t> _sum{0};
+		std::atomic<int64_t> _max{0};
+	};
+	typedef std::shared_ptr<Histogram> PHistogram;
+
+	Metrics();
+	virtual ~Metrics();
+
+	/**
+	 * Returns a monotonic time in microseconds to measure durations.
+	 */
+	static int64_t getTime();
+
+	/**
+	 * Returns the counter with the given name and label. It is created when it doesn't exist yet.
+	 *
+	 * @param name The Prometheus metric name.
+	 * @param help The description shown in the Prometheus output.
+	 * @param labelName The optional label name (e.g. "method").
+	 * @param labelValue The label value (e.g. "getValue").
+	 */
+	PCounter counter(const std::string& name, const std::string& help, const std::string& labelName = "", const std::string& labelValue = "");
+
+	/**
+	 * See counter().
+	 */
+	PGauge gauge(const std::string& name, const std::string& help, const std::string& labelName = "", const std::string& labelValue = "");
+
+	/**
+	 * See counter(). The name should end with "_seconds". Values are recorded in microseconds and exported in seconds.
+	 */
+	PHistogram histogram(const std::string& name, const std::string& help, const std::string& labelName = "", const std::string& labelValue = "");
+
+	/**
+	 * Returns a new queue depth counter for the queue with the given name. Queues with the same name share one gauge.
+	 */
+	PQueueDepth queueDepth(const std::string& queueName);
+
+	/**
+	 * Registers a gauge, whose value is read on export. Useful for values which are already known elsewhere, like the size of a ring buffer.
+	 */
+	void registerGaugeCallback(const std::string& name, const std::string& help, std::function<int64_t()> callback);
+	void unregisterGaugeCallback(const std::string& name);
+
+	/**
+	 * Returns all metrics in the Prometheus text format (version 0.0.4).
+	 */
+	std::string getPrometheusText();
+
+	/**
+	 * Returns all metrics as a struct for the RPC method "getMetrics". Histograms contain the count, the sum and the 50th, 90th and 99th percentile in microseconds.
+	 */
+	BaseLib::PVariable getMetrics();
+private:
+	struct Family
+	{
+		std::string help;
+		std::string type;
+		std::map<std::string, PCounter> counters;
+		std::map<std::string, PGauge> gauges;
+		std::map<std::string, PHistogram> histograms;
+		std::function<int64_t()> callback;
+	};
+
+	std::mutex _familiesMutex;
+	std::map<std::string, Family> _families;
+
+	Metrics(const Metrics&);
+	Metrics& operator=(const Metrics&);
+	Family& getFamily(const std::string& name, const std::string& help, const std::string& type);
+	std::string getLabel(const std::string& labelName, const std::string& labelValue);
+	std::string getSeconds(uint64_t microseconds);
+};
+
+#endif
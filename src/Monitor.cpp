@@ -31,6 +31,9 @@
 #include "Monitor.h"
 #include "GD/GD.h"
 
+#include <poll.h>
+#include <sstream>
+
 Monitor::Monitor()
 {
 	signal(SIGPIPE, SIG_IGN);
@@ -83,13 +86,18 @@ void Monitor::init()
 	}
 }
 
-void Monitor::prepareParent()
+void Monitor::prepareParent(pid_t mainProcessId)
 {
 	if(!GD::bl->settings.enableMonitoring()) return;
 	close(_pipeToChild[0]);
 	close(_pipeFromChild[1]);
+	_pipeToChild[0] = -1;
+	_pipeFromChild[1] = -1;
 	_suspendMonitoring = false;
 	_killedProcess = false;
+	_stopCheckHealthThread = false;
+	_responseBuffer.clear();
+	GD::bl->threadManager.start(_checkHealthThread, true, &Monitor::checkHealthThread, this, mainProcessId);
 }
 
 void Monitor::prepareChild()
@@ -97,6 +105,8 @@ void Monitor::prepareChild()
 	if(!GD::bl->settings.enableMonitoring()) return;
 	close(_pipeToChild[1]);
 	close(_pipeFromChild[0]);
+	_pipeToChild[1] = -1;
+	_pipeFromChild[0] = -1;
 	_stopMonitorThread = false;
 	_suspendMonitoring = true;
 	GD::bl->threadManager.start(_monitorThread, true, &Monitor::monitor, this);
@@ -112,14 +122,22 @@ void Monitor::stop()
 	try
 	{
 		_suspendMonitoring = true;
-		_checkHealthMutex.lock();
-		_checkHealthMutex.unlock();
+		{
+			std::lock_guard<std::mutex> waitGuard(_checkHealthWaitMutex);
+			_stopCheckHealthThread = true;
+		}
+		_checkHealthConditionVariable.notify_all();
+		GD::bl->threadManager.join(_checkHealthThread);
 		_stopMonitorThread = true;
 		GD::bl->threadManager.join(_monitorThread);
 		if(_pipeToChild[0] != -1) close(_pipeToChild[0]);
 		if(_pipeToChild[1] != -1) close(_pipeToChild[1]);
 		if(_pipeFromChild[0] != -1) close(_pipeFromChild[0]);
 		if(_pipeFromChild[1] != -1) close(_pipeFromChild[1]);
+		_pipeToChild[0] = -1;
+		_pipeToChild[1] = -1;
+		_pipeFromChild[0] = -1;
+		_pipeFromChild[1] = -1;
 	}
 	catch(const std::exception& ex)
 	{
@@ -153,15 +171,35 @@ void Monitor::killChild(pid_t mainProcessId)
 	}
 }
 
-void Monitor::checkHealth(pid_t mainProcessId)
+void Monitor::killChildDelayed(pid_t mainProcessId)
+{
+	for(int32_t i = 0; i < 30; i++)
+	{
+		if(_suspendMonitoring || _stopCheckHealthThread) return;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+	}
+	killChild(mainProcessId); //In case the pipe didn't close because of an ordered shutdown and the process hangs, kill it
+}
+
+void Monitor::checkHealthThread(pid_t mainProcessId)
 {
 	try
 	{
-		if(!GD::bl->settings.enableMonitoring() || _suspendMonitoring) return;
-		// We need to start the method in a new thread, so that stop() called by the sigchld_handler works. Otherwise stop() runs in the same thread as checkHealth => Deadlock
-		GD::bl->threadManager.start(_checkHealthThread, true, &Monitor::checkHealthThread, this, mainProcessId);
-		// Wait
-		GD::bl->threadManager.join(_checkHealthThread);
+		//sigchld_handler calls exit() which calls stop(). When the signal is delivered to this thread, stop() would wait for the thread it runs in => Deadlock
+		sigset_t signalSet;
+		sigemptyset(&signalSet);
+		sigaddset(&signalSet, SIGCHLD);
+		pthread_sigmask(SIG_BLOCK, &signalSet, nullptr);
+
+		while(!_stopCheckHealthThread && !_suspendMonitoring)
+		{
+			{
+				std::unique_lock<std::mutex> waitLock(_checkHealthWaitMutex);
+				_checkHealthConditionVariable.wait_for(waitLock, std::chrono::seconds(GD::healthCheckInterval), [&] { return _stopCheckHealthThread; });
+			}
+			if(_stopCheckHealthThread || _suspendMonitoring || !GD::bl->settings.enableMonitoring()) break;
+			if(!checkHealth(mainProcessId)) break;
+		}
 	}
 	catch(const std::exception& ex)
 	{
@@ -177,90 +215,86 @@ void Monitor::checkHealth(pid_t mainProcessId)
 	}
 }
 
-void Monitor::checkHealthThread(pid_t mainProcessId)
+bool Monitor::checkHealth(pid_t mainProcessId)
 {
 	try
 	{
-		std::lock_guard<std::mutex> checkHealthGuard(_checkHealthMutex);
-		if(!GD::bl->settings.enableMonitoring() || _suspendMonitoring) return;
-		for(int32_t i = 0; i < 6; i++)
+		char command = 'l';
+		if(write(_pipeToChild[1], &command, 1) != 1)
 		{
-			uint32_t totalBytesWritten = 0;
-			std::string command("l");
-			while(totalBytesWritten < command.size())
+			if(_suspendMonitoring || _stopCheckHealthThread) return false;
+			GD::out.printError(std::string("Error writing to child process pipe: ") + strerror(errno));
+			killChildDelayed(mainProcessId);
+			_suspendMonitoring = true;
+			return false;
+		}
+
+		int64_t timeout = (int64_t)GD::healthCheckTimeout * 1000;
+		int64_t startTime = BaseLib::HelperFunctions::getTime();
+		char buffer[100];
+		while(true)
+		{
+			// {{{ Process the last complete response. Older ones are answers to requests which timed out.
+			std::string::size_type responseEnd = _responseBuffer.rfind('\n');
+			if(responseEnd != std::string::npos)
 			{
-				ssize_t bytesWritten = write(_pipeToChild[1], command.c_str() + totalBytesWritten, command.size() - totalBytesWritten);
-				if(bytesWritten == -1)
-				{
-					if(_suspendMonitoring) return;
-					GD::out.printError(std::string("Error writing to child process pipe: ") + strerror(errno));
-					for(int32_t i = 0; i < 30; i++)
-					{
-						if(_suspendMonitoring) return;
-						std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-					}
-					killChild(mainProcessId); //In case the pipe didn't close because of an ordered shutdown and the process hangs, kill it
-					_suspendMonitoring = true;
-					return;
-				}
-				totalBytesWritten += bytesWritten;
+				std::string::size_type responseStart = (responseEnd == 0) ? std::string::npos : _responseBuffer.rfind('\n', responseEnd - 1);
+				responseStart = (responseStart == std::string::npos) ? 0 : responseStart + 1;
+				std::string response = _responseBuffer.substr(responseStart, responseEnd - responseStart);
+				_responseBuffer.erase(0, responseEnd + 1);
+				return processResponse(mainProcessId, response);
 			}
+			// }}}
 
-			for(int32_t i = 0; i < 100; i++)
+			if(_suspendMonitoring || _stopCheckHealthThread) return false;
+			int64_t waitTime = timeout - (BaseLib::HelperFunctions::getTime() - startTime);
+			if(waitTime <= 0)
 			{
-				char buffer = 0;
-				int32_t bytesRead = read(_pipeFromChild[0], &buffer, 1);
-				if(bytesRead <= 0 || (unsigned)bytesRead > 1)
-				{
-					if(bytesRead == -1)
-					{
-						if(errno != EAGAIN && errno != EWOULDBLOCK)
-						{
-							if(_suspendMonitoring) return;
-							GD::out.printError(std::string("Error reading from child's process pipe: ") + strerror(errno));
-							_suspendMonitoring = true;
-							return;
-						}
-					}
-					else
-					{
-						if(_suspendMonitoring) return;
-						GD::out.printWarning("Warning: Pipe to child process closed.");
-						for(int32_t i = 0; i < 30; i++)
-						{
-							if(_suspendMonitoring) return;
-							std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-						}
-						killChild(mainProcessId); //In case the pipe didn't close because of an ordered shutdown and the process hangs, kill it
-						_suspendMonitoring = true;
-						return;
-					}
-					std::this_thread::sleep_for(std::chrono::milliseconds(100));
-					continue;
-				}
+				GD::out.printWarning("Warning: Homegear did not respond to the health check within " + std::to_string(GD::healthCheckTimeout) + " seconds.");
+				return true;
+			}
 
-				if(bytesRead != 1)
-				{
-					if(_suspendMonitoring) return;
-					GD::out.printError("Error reading from child's process pipe: Too much data.");
-					killChild(mainProcessId);
-					return;
-				}
+			//Wake up at least every second to react to stop().
+			pollfd pollInfo;
+			pollInfo.fd = _pipeFromChild[0];
+			pollInfo.events = POLLIN;
+			pollInfo.revents = 0;
+			int32_t result = poll(&pollInfo, 1, waitTime > 1000 ? 1000 : waitTime);
+			if(result == 0) continue;
+			if(result == -1)
+			{
+				if(errno == EINTR) continue;
+				if(_suspendMonitoring || _stopCheckHealthThread) return false;
+				GD::out.printError(std::string("Error polling child's process pipe: ") + strerror(errno));
+				_suspendMonitoring = true;
+				return false;
+			}
 
-				switch(buffer)
-				{
-				case 'a': //Everything ok
-					if(GD::bl->debugLevel >= 6) GD::out.printDebug("Debug: checkHealth returned ok.");
-					break;
-				case 'n':
-					killChild(mainProcessId);
-					break;
-				case 's':
-					GD::out.printInfo("Info: Shutdown detected. Suspending monitoring.");
-					_suspendMonitoring = true;
-					break;
-				}
-				return;
+			int32_t bytesRead = read(_pipeFromChild[0], buffer, sizeof(buffer));
+			if(bytesRead == -1)
+			{
+				if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) continue;
+				if(_suspendMonitoring || _stopCheckHealthThread) return false;
+				GD::out.printError(std::string("Error reading from child's process pipe: ") + strerror(errno));
+				_suspendMonitoring = true;
+				return false;
+			}
+			else if(bytesRead == 0)
+			{
+				if(_suspendMonitoring || _stopCheckHealthThread) return false;
+				GD::out.printWarning("Warning: Pipe to child process closed.");
+				killChildDelayed(mainProcessId);
+				_suspendMonitoring = true;
+				return false;
+			}
+
+			_responseBuffer.append(buffer, bytesRead);
+			if(_responseBuffer.size() > 1024)
+			{
+				if(_suspendMonitoring || _stopCheckHealthThread) return false;
+				GD::out.printError("Error reading from child's process pipe: Too much data.");
+				killChild(mainProcessId);
+				return false;
 			}
 		}
 	}
@@ -276,6 +310,52 @@ void Monitor::checkHealthThread(pid_t mainProcessId)
 	{
 		GD::bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
 	}
+	return true;
+}
+
+bool Monitor::processResponse(pid_t mainProcessId, std::string& response)
+{
+	try
+	{
+		//Format: "STATUS STALL_TIME QUEUE_DEPTH"
+		std::istringstream stream(response);
+		char status = 0;
+		int64_t stallTime = 0;
+		int64_t queueDepth = 0;
+		stream >> status >> stallTime >> queueDepth;
+
+		switch(status)
+		{
+		case 'a': //Everything ok
+			if(GD::bl->debugLevel >= 6) GD::out.printDebug("Debug: checkHealth returned ok. Stall time: " + std::to_string(stallTime) + "ms, queued entries: " + std::to_string(queueDepth));
+			if(stallTime >= _stallTimeWarning) GD::out.printWarning("Warning: Homegear is degraded. An operation is running for " + std::to_string(stallTime / 1000) + " seconds.");
+			if(queueDepth >= _queueDepthWarning) GD::out.printWarning("Warning: Homegear is degraded. " + std::to_string(queueDepth) + " entries are queued.");
+			return true;
+		case 'n':
+			killChild(mainProcessId);
+			return false;
+		case 's':
+			GD::out.printInfo("Info: Shutdown detected. Suspending monitoring.");
+			_suspendMonitoring = true;
+			return false;
+		default:
+			GD::out.printError("Error: Invalid response from child process: " + response);
+			return true;
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return true;
 }
 
 void Monitor::monitor()
@@ -284,48 +364,60 @@ void Monitor::monitor()
 	{
 		char buffer = 0;
 		int32_t bytesRead = 0;
-		uint32_t totalBytesWritten = 0;
+		pollfd pollInfo;
 		while(!_stopMonitorThread)
 		{
+			//Wake up at least every second to react to stop().
+			pollInfo.fd = _pipeToChild[0];
+			pollInfo.events = POLLIN;
+			pollInfo.revents = 0;
+			int32_t result = poll(&pollInfo, 1, 1000);
+			if(result == 0) continue;
+			if(result == -1)
+			{
+				if(errno == EINTR) continue;
+				GD::out.printError(std::string("Error polling parent's process pipe: ") + strerror(errno));
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+				continue;
+			}
+
 			bytesRead = read(_pipeToChild[0], &buffer, 1);
-			if(bytesRead <= 0 || (unsigned)bytesRead > 1)
+			if(bytesRead <= 0)
 			{
 				if(bytesRead == -1)
 				{
-					if(errno != EAGAIN && errno != EWOULDBLOCK) GD::out.printError(std::string("Error reading from parent's process pipe: ") + strerror(errno));
+					if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) GD::out.printError(std::string("Error reading from parent's process pipe: ") + strerror(errno));
 				}
 				else
 				{
 					GD::out.printError("Error reading from parent's process pipe.");
 					_stopMonitorThread = true;
 				}
-				std::this_thread::sleep_for(std::chrono::milliseconds(100));
-				continue;
-			}
-			if(bytesRead != 1)
-			{
-				GD::out.printError("Error reading from parent's process pipe: Too much data.");
-				std::this_thread::sleep_for(std::chrono::milliseconds(100));
 				continue;
 			}
 
-			totalBytesWritten = 0;
 			if(buffer == 'l')
 			{
 				std::string response;
+				LifetickInfo info;
 				if(GD::bl->shuttingDown) response = "s";
 				else
 				{
-					if(lifetick()) response = "a";
+					if(lifetick(info)) response = "a";
 					else response = "n";
 				}
-				ssize_t bytesWritten = write(_pipeFromChild[1], response.c_str() + totalBytesWritten, response.size() - totalBytesWritten);
-				if(bytesWritten == -1)
+				response.append(' ' + std::to_string(info.stallTime) + ' ' + std::to_string(info.queueDepth) + '\n');
+				uint32_t totalBytesWritten = 0;
+				while(totalBytesWritten < response.size())
 				{
-					GD::out.printError(std::string("Error writing to child process pipe: ") + strerror(errno));
-					return;
+					ssize_t bytesWritten = write(_pipeFromChild[1], response.c_str() + totalBytesWritten, response.size() - totalBytesWritten);
+					if(bytesWritten == -1)
+					{
+						GD::out.printError(std::string("Error writing to child process pipe: ") + strerror(errno));
+						return;
+					}
+					totalBytesWritten += bytesWritten;
 				}
-				totalBytesWritten += bytesWritten;
 			}
 		}
 	}
@@ -343,17 +435,27 @@ void Monitor::monitor()
 	}
 }
 
-bool Monitor::lifetick()
+bool Monitor::lifetick(LifetickInfo& info)
 {
 	try
 	{
-		if(!GD::rpcClient->lifetick()) return false;
+		bool result = true;
+		LifetickInfo componentInfo;
+		if(!GD::rpcClient->lifetick(componentInfo)) result = false;
+		if(componentInfo.stallTime > info.stallTime) info.stallTime = componentInfo.stallTime;
+		info.queueDepth += componentInfo.queueDepth;
 		for(std::map<int32_t, RPC::Server>::iterator i = GD::rpcServers.begin(); i != GD::rpcServers.end(); ++i)
 		{
-			if(!i->second.lifetick()) return false;
+			componentInfo = LifetickInfo();
+			if(!i->second.lifetick(componentInfo)) result = false;
+			if(componentInfo.stallTime > info.stallTime) info.stallTime = componentInfo.stallTime;
+			info.queueDepth += componentInfo.queueDepth;
 		}
-		if(!GD::familyController->lifetick()) return false;
-		return true;
+		componentInfo = LifetickInfo();
+		if(!GD::familyController->lifetick(componentInfo)) result = false;
+		if(componentInfo.stallTime > info.stallTime) info.stallTime = componentInfo.stallTime;
+		info.queueDepth += componentInfo.queueDepth;
+		return result;
 	}
 	catch(const std::exception& ex)
 	{
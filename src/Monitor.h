@@ -33,6 +33,24 @@
 
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <string>
+
+/**
+ * Health information reported by the lifetick methods of the main process' components.
+ */
+struct LifetickInfo
+{
+	/**
+	 * The time in milliseconds the longest running operation of a component is running. 0 if the component is idle.
+	 */
+	int64_t stallTime = 0;
+
+	/**
+	 * The number of entries waiting in the component's queues.
+	 */
+	int64_t queueDepth = 0;
+};
 
 class Monitor
 {
@@ -45,28 +63,54 @@ public:
 	bool killedProcess();
 
 	/**
-	 * Causes checkHealthThread to exit as soon as possible and prevents starting checkHealthThread.
+	 * Causes checkHealthThread to exit as soon as possible and prevents starting checkHealthThread. Only sets a flag, so it can be called from signal handlers.
 	 */
 	void suspend();
 
-	void prepareParent();
+	/**
+	 * Prepares the monitor process and starts checking the health of the main process every GD::healthCheckInterval seconds.
+	 *
+	 * @param mainProcessId The process ID of the main process.
+	 */
+	void prepareParent(pid_t mainProcessId);
 	void prepareChild();
-	void checkHealth(pid_t mainProcessId);
 private:
 	int _pipeToChild[2];
 	int _pipeFromChild[2];
 	bool _suspendMonitoring = true;
 	bool _stopMonitorThread = false;
+	bool _stopCheckHealthThread = false;
 	std::thread _checkHealthThread;
 	std::thread _monitorThread;
 	bool _killedProcess = false;
 	bool _disposing = false;
-	std::mutex _checkHealthMutex;
+	std::mutex _checkHealthWaitMutex;
+	std::condition_variable _checkHealthConditionVariable;
+	std::string _responseBuffer;
+
+	/**
+	 * Stall time in milliseconds from which on a warning is printed. The main process reports itself as unhealthy after 60 seconds.
+	 */
+	int64_t _stallTimeWarning = 30000;
+
+	/**
+	 * Queue depth from which on a warning is printed. Most queues hold 1000 entries.
+	 */
+	int64_t _queueDepthWarning = 500;
 
 	void monitor();
 	void killChild(pid_t mainProcessId);
-	bool lifetick();
+	void killChildDelayed(pid_t mainProcessId);
+	bool lifetick(LifetickInfo& info);
 	void checkHealthThread(pid_t mainProcessId);
+
+	/**
+	 * Sends one lifetick request to the main process and waits for the response.
+	 *
+	 * @return Returns false when monitoring needs to stop.
+	 */
+	bool checkHealth(pid_t mainProcessId);
+	bool processResponse(pid_t mainProcessId, std::string& response);
 };
 
 #endif
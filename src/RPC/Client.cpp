@@ -39,6 +39,8 @@ Client::Client()
 {
 	_lifetick1.first = 0;
 	_lifetick1.second = true;
+	_broadcastEventDuration = GD::metrics.histogram("homegear_event_fanout_duration_seconds", "Time to queue an event for MQTT and all RPC event servers.");
+	_queueDepth = GD::metrics.gauge("homegear_queue_depth", "Number of entries waiting in a queue.", "queue", "rpcClient");
 }
 
 Client::~Client()
@@ -60,12 +62,14 @@ void Client::init()
 	_jsonEncoder = std::unique_ptr<BaseLib::RPC::JsonEncoder>(new BaseLib::RPC::JsonEncoder(GD::bl.get()));
 }
 
-bool Client::lifetick()
+bool Client::lifetick(LifetickInfo& info)
 {
 	try
 	{
+		info.queueDepth = _queueDepth->value();
 		std::lock_guard<std::mutex> lifetickGuard(_lifetick1Mutex);
-		if(!_lifetick1.second && BaseLib::HelperFunctions::getTime() - _lifetick1.first > 60000)
+		if(!_lifetick1.second) info.stallTime = BaseLib::HelperFunctions::getTime() - _lifetick1.first;
+		if(info.stallTime > 60000)
 		{
 			GD::out.printCritical("Critical: RPC client's lifetick was not updated for more than 60 seconds.");
 			return false;
@@ -130,6 +134,7 @@ void Client::broadcastEvent(uint64_t id, int32_t channel, std::string deviceAddr
 		{
 			return;
 		}
+		int64_t startTime = Metrics::getTime();
 		{
 			std::lock_guard<std::mutex> lifetickGuard(_lifetick1Mutex);
 			_lifetick1.first = BaseLib::HelperFunctions::getTime();
@@ -197,6 +202,7 @@ void Client::broadcastEvent(uint64_t id, int32_t channel, std::string deviceAddr
 				server->second->queueMethod(std::shared_ptr<std::pair<std::string, std::shared_ptr<BaseLib::List>>>(new std::pair<std::string, std::shared_ptr<BaseLib::List>>("system.multicall", parameters)));
 			}
 		}
+		_broadcastEventDuration->record(Metrics::getTime() - startTime);
 		{
 			std::lock_guard<std::mutex> lifetickGuard(_lifetick1Mutex);
 			_lifetick1.second = true;
@@ -306,16 +312,8 @@ void Client::listDevices(std::pair<std::string, std::string> address)
 				if(device == 0) //Client doesn't support ID's
 				{
 					if(serialNumber.empty()) break;
-					std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
-					for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
-					{
-						std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
-						if(central)
-						{
-							device = central->getPeerIdFromSerial(serialNumber);
-							if(device > 0) break;
-						}
-					}
+					std::shared_ptr<BaseLib::Systems::ICentral> central = GD::familyController->getCentral(serialNumber);
+					if(central) device = central->getPeerIdFromSerial(serialNumber);
 				}
 				server->knownDevices->insert(device);
 			}
@@ -38,6 +38,8 @@
 #include <chrono>
 
 #include "RpcClient.h"
+#include "../Metrics/Metrics.h"
+#include "../Monitor.h"
 #include "homegear-base/BaseLib.h"
 
 namespace RPC
@@ -54,7 +56,14 @@ public:
 	virtual ~Client();
 	void dispose();
 	void init();
-	bool lifetick();
+
+	/**
+	 * Checks if event broadcasting hangs.
+	 *
+	 * @param info Is filled with the time the current broadcast is running and the number of entries queued for remote RPC servers.
+	 * @return Returns false when a broadcast is running for more than 60 seconds.
+	 */
+	bool lifetick(LifetickInfo& info);
 
 	void initServerMethods(std::pair<std::string, std::string> address);
 	void broadcastEvent(uint64_t id, int32_t channel, std::string deviceAddress, std::shared_ptr<std::vector<std::string>> valueKeys, std::shared_ptr<std::vector<BaseLib::PVariable>> values);
@@ -85,6 +94,8 @@ private:
 	std::unique_ptr<BaseLib::RPC::JsonEncoder> _jsonEncoder;
 	std::mutex _lifetick1Mutex;
 	std::pair<int64_t, bool> _lifetick1;
+	Metrics::PHistogram _broadcastEventDuration;
+	Metrics::PGauge _queueDepth;
 
 	void collectGarbage();
 };
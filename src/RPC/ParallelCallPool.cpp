@@ -0,0 +1,206 @@
+/* Copyright 2013-2016 Sathya Laufer
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Homegear.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ * 
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "ParallelCallPool.h"
+#include "../GD/GD.h"
+
+#include <algorithm>
+
+namespace RPC
+{
+
+ParallelCallPool::ParallelCallPool() : BaseLib::IQueue(GD::bl.get(), 1000)
+{
+	_started = false;
+	_queueDepth = GD::metrics.queueDepth("rpcParallelCalls");
+}
+
+ParallelCallPool::~ParallelCallPool()
+{
+	stop();
+}
+
+void ParallelCallPool::start()
+{
+	try
+	{
+		if(_started) return;
+		_started = true;
+		startQueue(0, _threadCount, 0, SCHED_OTHER);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+void ParallelCallPool::stop()
+{
+	try
+	{
+		if(!_started) return;
+		_started = false;
+		stopQueue(0);
+		_queueDepth->clear();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+std::vector<BaseLib::PVariable> ParallelCallPool::invoke(size_t count, std::function<BaseLib::PVariable(size_t index)>& method, uint32_t maxParallelCalls)
+{
+	std::vector<BaseLib::PVariable> results;
+	try
+	{
+		PRequest request(new Request());
+		request->results.resize(count);
+		request->method = method;
+
+		if(_started && maxParallelCalls > 1 && count > 1)
+		{
+			size_t helpers = std::min(count, (size_t)maxParallelCalls) - 1;
+			for(size_t i = 0; i < helpers; i++)
+			{
+				std::shared_ptr<BaseLib::IQueueEntry> entry(new QueueEntry(request));
+				_queueDepth->increment();
+				if(!enqueue(0, entry))
+				{
+					//Queue is full. The remaining indexes are processed by the threads already helping.
+					_queueDepth->decrement();
+					break;
+				}
+			}
+		}
+
+		process(request);
+
+		std::unique_lock<std::mutex> requestLock(request->mutex);
+		request->finishedConditionVariable.wait(requestLock, [&]{ return request->nextIndex >= request->results.size() && request->activeCalls == 0; });
+		results.swap(request->results);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return results;
+}
+
+void ParallelCallPool::process(PRequest& request)
+{
+	while(true)
+	{
+		size_t index = 0;
+		{
+			std::lock_guard<std::mutex> requestGuard(request->mutex);
+			//Helpers processed after the request was finished return here without calling the method, which might reference the caller's stack.
+			if(request->nextIndex >= request->results.size()) return;
+			index = request->nextIndex++;
+			request->activeCalls++;
+		}
+
+		BaseLib::PVariable result;
+		try
+		{
+			result = request->method(index);
+		}
+		catch(const std::exception& ex)
+		{
+			GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+		}
+		catch(BaseLib::Exception& ex)
+		{
+			GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+		}
+		catch(...)
+		{
+			GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+		}
+
+		bool finished = false;
+		{
+			std::lock_guard<std::mutex> requestGuard(request->mutex);
+			request->results.at(index) = result;
+			request->activeCalls--;
+			finished = request->nextIndex >= request->results.size() && request->activeCalls == 0;
+		}
+		if(finished) request->finishedConditionVariable.notify_all();
+	}
+}
+
+void ParallelCallPool::processQueueEntry(int32_t index, std::shared_ptr<BaseLib::IQueueEntry>& entry)
+{
+	try
+	{
+		_queueDepth->decrement();
+		std::shared_ptr<QueueEntry> queueEntry = std::dynamic_pointer_cast<QueueEntry>(entry);
+		if(!queueEntry || !queueEntry->request) return;
+		process(queueEntry->request);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+}
@@ -0,0 +1,110 @@
+/* Copyright 2013-2016 Sathya Laufer
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Homegear.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ * 
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#ifndef PARALLELCALLPOOL_H_
+#define PARALLELCALLPOOL_H_
+
+#include "homegear-base/BaseLib.h"
+#include "../Metrics/Metrics.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace RPC
+{
+
+/**
+ * Threads shared by all RPC methods executing calls in parallel (e. g. system.multicall or methods querying all device families). The calling
+ * thread always takes part and threads of the pool only help, so calls never wait for a free thread and nested parallel calls can't deadlock.
+ */
+class ParallelCallPool : public BaseLib::IQueue
+{
+public:
+	ParallelCallPool();
+	virtual ~ParallelCallPool();
+
+	void start();
+	void stop();
+
+	/**
+	 * Calls "method" for every index from 0 to "count" - 1 and returns the results in the order of the indexes. Up to "maxParallelCalls" - 1
+	 * threads of the pool help the calling thread.
+	 *
+	 * @param count The number of indexes.
+	 * @param method The method to call.
+	 * @param maxParallelCalls The maximum number of indexes processed at the same time.
+	 * @return The results in the order of the indexes.
+	 */
+	std::vector<BaseLib::PVariable> invoke(size_t count, std::function<BaseLib::PVariable(size_t index)>& method, uint32_t maxParallelCalls);
+private:
+	struct Request
+	{
+		std::mutex mutex;
+		std::condition_variable finishedConditionVariable;
+		size_t nextIndex = 0;
+
+		/**
+		 * The number of indexes currently processed. The calling thread only waits for these, helpers which didn't start yet are not waited for.
+		 */
+		size_t activeCalls = 0;
+		std::vector<BaseLib::PVariable> results;
+		std::function<BaseLib::PVariable(size_t index)> method;
+	};
+	typedef std::shared_ptr<Request> PRequest;
+
+	class QueueEntry : public BaseLib::IQueueEntry
+	{
+	public:
+		QueueEntry() {}
+		QueueEntry(PRequest& request) { this->request = request; }
+		virtual ~QueueEntry() {}
+
+		PRequest request;
+	};
+
+	/**
+	 * The number of threads of the pool.
+	 */
+	static const int32_t _threadCount = 8;
+
+	std::atomic_bool _started;
+	Metrics::PQueueDepth _queueDepth;
+
+	ParallelCallPool(const ParallelCallPool&);
+	ParallelCallPool& operator=(const ParallelCallPool&);
+	void processQueueEntry(int32_t index, std::shared_ptr<BaseLib::IQueueEntry>& entry);
+	static void process(PRequest& request);
+};
+
+}
+#endif
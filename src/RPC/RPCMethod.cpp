@@ -33,6 +33,7 @@
 
 namespace RPC
 {
+
 BaseLib::PVariable RPCMethod::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
 {
 	return BaseLib::PVariable(new BaseLib::Variable());
@@ -121,4 +122,133 @@ void RPCMethod::addSignature(BaseLib::VariableType returnType, std::vector<BaseL
     }
 }
 
+std::vector<BaseLib::PVariable> RPCMethod::invokeFamilies(std::function<BaseLib::PVariable(std::shared_ptr<BaseLib::Systems::DeviceFamily>& family)> method, uint32_t maxParallelCalls)
+{
+	std::vector<BaseLib::PVariable> results;
+	try
+	{
+		std::shared_ptr<const std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>> familyMap = GD::familyController->getFamiliesSnapshot();
+		std::vector<std::shared_ptr<BaseLib::Systems::DeviceFamily>> families;
+		families.reserve(familyMap->size());
+		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::const_iterator i = familyMap->begin(); i != familyMap->end(); ++i)
+		{
+			families.push_back(i->second);
+		}
+
+		results = invokeParallel(families.size(), [&](size_t index) -> BaseLib::PVariable
+		{
+			return method(families.at(index));
+		}, maxParallelCalls);
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return results;
+}
+
+std::vector<BaseLib::PVariable> RPCMethod::invokeParallel(size_t count, std::function<BaseLib::PVariable(size_t index)> method, uint32_t maxParallelCalls)
+{
+	std::vector<BaseLib::PVariable> results;
+	try
+	{
+		if(GD::parallelCallPool) return GD::parallelCallPool->invoke(count, method, maxParallelCalls);
+
+		results.reserve(count);
+		for(size_t i = 0; i < count; i++)
+		{
+			results.push_back(method(i));
+		}
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return results;
+}
+
+BaseLib::PVariable RPCMethod::mergeArrays(std::vector<BaseLib::PVariable>& arrays, uint32_t offset, uint32_t limit)
+{
+	BaseLib::PVariable result(new BaseLib::Variable(BaseLib::VariableType::tArray));
+	try
+	{
+		for(std::vector<BaseLib::PVariable>::iterator i = arrays.begin(); i != arrays.end(); ++i)
+		{
+			if(!*i || (*i)->arrayValue->empty()) continue;
+			if(offset >= (*i)->arrayValue->size())
+			{
+				offset -= (*i)->arrayValue->size();
+				continue;
+			}
+			BaseLib::Array::iterator begin = (*i)->arrayValue->begin() + offset;
+			BaseLib::Array::iterator end = (*i)->arrayValue->end();
+			offset = 0;
+			if(limit > 0 && (uint32_t)(end - begin) > limit - result->arrayValue->size()) end = begin + (limit - result->arrayValue->size());
+			result->arrayValue->insert(result->arrayValue->end(), begin, end);
+			if(limit > 0 && result->arrayValue->size() >= limit) break;
+		}
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return result;
+}
+
+std::string RPCMethod::getPeerSerializationKey(BaseLib::PVariable& address)
+{
+	try
+	{
+		if(!address) return "";
+		if(address->type != BaseLib::VariableType::tString) return std::to_string((uint64_t)address->integerValue);
+
+		//Calls using the serial number and calls using the ID of the same peer need the same key.
+		std::string serialNumber = address->stringValue.substr(0, address->stringValue.find(':'));
+		std::shared_ptr<BaseLib::Systems::ICentral> central = GD::familyController->getCentral(serialNumber);
+		if(central)
+		{
+			std::shared_ptr<BaseLib::Systems::Peer> peer = central->getPeer(serialNumber);
+			if(peer) return std::to_string(peer->getID());
+		}
+		return serialNumber;
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return "";
+}
+
 } /* namespace RPC */
@@ -33,6 +33,8 @@
 
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <functional>
 
 #include "homegear-base/BaseLib.h"
 
@@ -56,12 +58,71 @@ public:
 	BaseLib::PVariable getError(ParameterError::Enum error);
 	BaseLib::PVariable getSignature() { return _signatures; }
 	BaseLib::PVariable getHelp() { return _help; }
+
+	/**
+	 * Returns true for methods which only read data. Calls of these methods don't depend on each other and may run in parallel.
+	 */
+	bool isReadOnly() { return _readOnly; }
+
+	/**
+	 * Returns true when a call with the provided parameters only reads data. Methods which only read data for some parameters override this.
+	 *
+	 * @param parameters The parameters of the call.
+	 * @param[out] serializationKey Read-only calls with the same non-empty key are executed one after another in the order of the request, e. g. because they communicate with the same device.
+	 * @return Returns isReadOnly() by default.
+	 */
+	virtual bool isReadOnlyCall(std::shared_ptr<std::vector<BaseLib::PVariable>>& parameters, std::string& serializationKey) { return _readOnly; }
 protected:
 	BaseLib::PVariable _signatures;
 	BaseLib::PVariable _help;
 
+	/**
+	 * Set to true in the constructor of methods which never change any state, independent of their parameters.
+	 */
+	bool _readOnly = false;
+
 	void addSignature(BaseLib::VariableType returnType, std::vector<BaseLib::VariableType> parameterTypes);
 	void setHelp(std::string help);
+
+	/**
+	 * Calls "method" for every device family and returns the results in the order of the families. Up to "maxParallelCalls" families are processed
+	 * at the same time, as long as threads of GD::parallelCallPool are available. Otherwise the families are processed by the calling thread only.
+	 *
+	 * @param method The method to call. It may return nullptr to skip a family.
+	 * @param maxParallelCalls The maximum number of families processed at the same time for this request.
+	 * @return The results in the order of the families.
+	 */
+	std::vector<BaseLib::PVariable> invokeFamilies(std::function<BaseLib::PVariable(std::shared_ptr<BaseLib::Systems::DeviceFamily>& family)> method, uint32_t maxParallelCalls = 4);
+
+	/**
+	 * Calls "method" for every index from 0 to "count" - 1 and returns the results in the order of the indexes. Like invokeFamilies(), up to
+	 * "maxParallelCalls" indexes are processed at the same time by threads of GD::parallelCallPool. The calling thread always takes part, so the
+	 * method also works when no thread of the pool is available.
+	 *
+	 * @param count The number of indexes.
+	 * @param method The method to call.
+	 * @param maxParallelCalls The maximum number of indexes processed at the same time for this request.
+	 * @return The results in the order of the indexes.
+	 */
+	std::vector<BaseLib::PVariable> invokeParallel(size_t count, std::function<BaseLib::PVariable(size_t index)> method, uint32_t maxParallelCalls);
+
+	/**
+	 * Merges the arrays returned by invokeFamilies() into one array.
+	 *
+	 * @param arrays The arrays to merge. Empty elements are skipped.
+	 * @param offset The number of elements to skip.
+	 * @param limit The maximum number of elements to return. "0" returns all elements.
+	 * @return The merged array.
+	 */
+	BaseLib::PVariable mergeArrays(std::vector<BaseLib::PVariable>& arrays, uint32_t offset = 0, uint32_t limit = 0);
+
+	/**
+	 * Returns a serialization key for isReadOnlyCall() identifying the peer addressed by a parameter.
+	 *
+	 * @param address Either the peer ID or the serial number optionally followed by ":" and the channel.
+	 * @return The ID of the peer as string. When the peer is unknown, the serial number is returned.
+	 */
+	std::string getPeerSerializationKey(BaseLib::PVariable& address);
 };
 
 }
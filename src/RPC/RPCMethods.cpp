@@ -112,10 +112,11 @@ BaseLib::PVariable RPCSystemListMethods::invoke(BaseLib::PRpcClientInfo clientIn
 		if(!parameters->empty()) return getError(ParameterError::Enum::wrongCount);
 
 		BaseLib::PVariable methodInfo(new BaseLib::Variable(BaseLib::VariableType::tArray));
-		std::shared_ptr<std::map<std::string, std::shared_ptr<RPCMethod>>> methods = _server->getMethods();
-		for(std::map<std::string, std::shared_ptr<RPCMethod>>::iterator i = methods->begin(); i != methods->end(); ++i)
+		std::vector<std::string> methodNames = _server->getMethods()->getNames();
+		methodInfo->arrayValue->reserve(methodNames.size());
+		for(std::vector<std::string>::iterator i = methodNames.begin(); i != methodNames.end(); ++i)
 		{
-			methodInfo->arrayValue->push_back(BaseLib::PVariable(new BaseLib::Variable(i->first)));
+			methodInfo->arrayValue->push_back(BaseLib::PVariable(new BaseLib::Variable(*i)));
 		}
 
 		return methodInfo;
@@ -142,13 +143,13 @@ BaseLib::PVariable RPCSystemMethodHelp::invoke(BaseLib::PRpcClientInfo clientInf
 		ParameterError::Enum error = checkParameters(parameters, std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tString }));
 		if(error != ParameterError::Enum::noError) return getError(error);
 
-		std::shared_ptr<std::map<std::string, std::shared_ptr<RPCMethod>>> methods = _server->getMethods();
-		if(methods->find(parameters->at(0)->stringValue) == methods->end())
+		const RpcMethodTable::Entry* method = _server->getMethods()->find(parameters->at(0)->stringValue);
+		if(!method)
 		{
 			return BaseLib::Variable::createError(-32602, "Method not found.");
 		}
 
-		BaseLib::PVariable help = _server->getMethods()->at(parameters->at(0)->stringValue)->getHelp();
+		BaseLib::PVariable help = method->method->getHelp();
 
 		if(!help) help.reset(new BaseLib::Variable(BaseLib::VariableType::tString));
 
@@ -176,13 +177,13 @@ BaseLib::PVariable RPCSystemMethodSignature::invoke(BaseLib::PRpcClientInfo clie
 		ParameterError::Enum error = checkParameters(parameters, std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tString }));
 		if(error != ParameterError::Enum::noError) return getError(error);
 
-		std::shared_ptr<std::map<std::string, std::shared_ptr<RPCMethod>>> methods = _server->getMethods();
-		if(methods->find(parameters->at(0)->stringValue) == methods->end())
+		const RpcMethodTable::Entry* method = _server->getMethods()->find(parameters->at(0)->stringValue);
+		if(!method)
 		{
 			return BaseLib::Variable::createError(-32602, "Method not found.");
 		}
 
-		BaseLib::PVariable signature = _server->getMethods()->at(parameters->at(0)->stringValue)->getSignature();
+		BaseLib::PVariable signature = method->method->getSignature();
 
 		if(!signature) signature.reset(new BaseLib::Variable(BaseLib::VariableType::tArray));
 
@@ -213,41 +214,124 @@ BaseLib::PVariable RPCSystemMulticall::invoke(BaseLib::PRpcClientInfo clientInfo
 {
 	try
 	{
-		ParameterError::Enum error = checkParameters(parameters, std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tArray }));
+		ParameterError::Enum error = checkParameters(parameters, std::vector<std::vector<BaseLib::VariableType>>({
+			std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tArray }),
+			std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tArray, BaseLib::VariableType::tInteger })
+		}));
 		if(error != ParameterError::Enum::noError) return getError(error);
 
-		std::shared_ptr<std::map<std::string, std::shared_ptr<RPCMethod>>> methods = _server->getMethods();
-		BaseLib::PVariable returns(new BaseLib::Variable(BaseLib::VariableType::tArray));
-		for(std::vector<BaseLib::PVariable>::iterator i = parameters->at(0)->arrayValue->begin(); i != parameters->at(0)->arrayValue->end(); ++i)
+		uint32_t maxParallelCalls = GD::multicallParallelism;
+		if(parameters->size() == 2) maxParallelCalls = parameters->at(1)->integerValue > 1 ? parameters->at(1)->integerValue : 1;
+
+		std::shared_ptr<RpcMethodTable> methods = _server->getMethods();
+		BaseLib::Array& calls = *parameters->at(0)->arrayValue;
+		std::vector<BaseLib::PVariable> results(calls.size());
+		std::vector<const RpcMethodTable::Entry*> callMethods(calls.size(), nullptr);
+		std::vector<std::shared_ptr<std::vector<BaseLib::PVariable>>> callParameters(calls.size());
+		std::vector<bool> readOnlyCalls(calls.size(), false);
+		std::vector<std::string> serializationKeys(calls.size());
+		for(size_t i = 0; i < calls.size(); i++)
 		{
-			if((*i)->type != BaseLib::VariableType::tStruct)
+			if(calls[i]->type != BaseLib::VariableType::tStruct)
 			{
-				returns->arrayValue->push_back(BaseLib::Variable::createError(-32602, "Array element is no struct."));
+				results[i] = BaseLib::Variable::createError(-32602, "Array element is no struct.");
 				continue;
 			}
-			if((*i)->structValue->size() != 2)
+			if(calls[i]->structValue->size() != 2)
 			{
-				returns->arrayValue->push_back(BaseLib::Variable::createError(-32602, "Struct has wrong size."));
+				results[i] = BaseLib::Variable::createError(-32602, "Struct has wrong size.");
 				continue;
 			}
-			if((*i)->structValue->find("methodName") == (*i)->structValue->end() || (*i)->structValue->at("methodName")->type != BaseLib::VariableType::tString)
+			BaseLib::Struct::iterator methodNameIterator = calls[i]->structValue->find("methodName");
+			if(methodNameIterator == calls[i]->structValue->end() || methodNameIterator->second->type != BaseLib::VariableType::tString)
 			{
-				returns->arrayValue->push_back(BaseLib::Variable::createError(-32602, "No method name provided."));
+				results[i] = BaseLib::Variable::createError(-32602, "No method name provided.");
 				continue;
 			}
-			if((*i)->structValue->find("params") == (*i)->structValue->end() || (*i)->structValue->at("params")->type != BaseLib::VariableType::tArray)
+			BaseLib::Struct::iterator parametersIterator = calls[i]->structValue->find("params");
+			if(parametersIterator == calls[i]->structValue->end() || parametersIterator->second->type != BaseLib::VariableType::tArray)
 			{
-				returns->arrayValue->push_back(BaseLib::Variable::createError(-32602, "No parameters provided."));
+				results[i] = BaseLib::Variable::createError(-32602, "No parameters provided.");
 				continue;
 			}
-			std::string methodName = (*i)->structValue->at("methodName")->stringValue;
-			std::shared_ptr<std::vector<BaseLib::PVariable>> parameters = (*i)->structValue->at("params")->arrayValue;
 
-			if(methodName == "system.multicall") returns->arrayValue->push_back(BaseLib::Variable::createError(-32602, "Recursive calls to system.multicall are not allowed."));
-			else if(methods->find(methodName) == methods->end()) returns->arrayValue->push_back(BaseLib::Variable::createError(-32601, "Requested method not found."));
-			else returns->arrayValue->push_back(methods->at(methodName)->invoke(clientInfo, parameters));
+			const RpcMethodTable::Entry* method = methods->find(methodNameIterator->second->stringValue);
+			if(!method) results[i] = BaseLib::Variable::createError(-32601, "Requested method not found.");
+			else if(std::dynamic_pointer_cast<RPCSystemMulticall>(method->method)) results[i] = BaseLib::Variable::createError(-32602, "Recursive calls to system.multicall are not allowed.");
+			else
+			{
+				callMethods[i] = method;
+				callParameters[i] = parametersIterator->second->arrayValue;
+				if(maxParallelCalls > 1) readOnlyCalls[i] = method->method->isReadOnlyCall(callParameters[i], serializationKeys[i]);
+			}
 		}
 
+		std::function<BaseLib::PVariable(size_t index)> invokeCall = [&](size_t index) -> BaseLib::PVariable
+		{
+			int64_t startTime = Metrics::getTime();
+			BaseLib::PVariable result = callMethods[index]->method->invoke(clientInfo, callParameters[index]);
+			callMethods[index]->statistics->record(Metrics::getTime() - startTime, result->errorStruct);
+			return result;
+		};
+
+		//Consecutive read-only calls don't depend on each other and are executed in parallel. All other calls are executed on their own in the order
+		//of the request, so a read after a write always sees the written value. Read-only calls with the same serialization key (e. g. reads from
+		//the same device) are executed one after another in the order of the request.
+		size_t i = 0;
+		while(i < calls.size())
+		{
+			if(!callMethods[i])
+			{
+				i++;
+				continue;
+			}
+			size_t end = i + 1;
+			if(readOnlyCalls[i])
+			{
+				while(end < calls.size() && (!callMethods[end] || readOnlyCalls[end])) end++;
+			}
+
+			if(end - i == 1) results[i] = invokeCall(i);
+			else
+			{
+				std::vector<std::vector<size_t>> groups;
+				std::map<std::string, size_t> groupByKey;
+				for(size_t j = i; j < end; j++)
+				{
+					if(!callMethods[j]) continue;
+					if(serializationKeys[j].empty())
+					{
+						groups.push_back(std::vector<size_t>{ j });
+						continue;
+					}
+					std::map<std::string, size_t>::iterator groupIterator = groupByKey.find(serializationKeys[j]);
+					if(groupIterator != groupByKey.end()) groups.at(groupIterator->second).push_back(j);
+					else
+					{
+						groupByKey[serializationKeys[j]] = groups.size();
+						groups.push_back(std::vector<size_t>{ j });
+					}
+				}
+
+				//Every call belongs to exactly one group, so results can be set without locking.
+				invokeParallel(groups.size(), [&](size_t index) -> BaseLib::PVariable
+				{
+					for(std::vector<size_t>::iterator callIterator = groups.at(index).begin(); callIterator != groups.at(index).end(); ++callIterator)
+					{
+						results[*callIterator] = invokeCall(*callIterator);
+					}
+					return BaseLib::PVariable();
+				}, maxParallelCalls);
+			}
+			i = end;
+		}
+
+		BaseLib::PVariable returns(new BaseLib::Variable(BaseLib::VariableType::tArray));
+		returns->arrayValue->reserve(results.size());
+		for(std::vector<BaseLib::PVariable>::iterator i = results.begin(); i != results.end(); ++i)
+		{
+			returns->arrayValue->push_back(*i ? *i : BaseLib::Variable::createError(-32500, "Unknown application error."));
+		}
 		return returns;
 	}
 	catch(const std::exception& ex)
@@ -879,22 +963,37 @@ BaseLib::PVariable RPCGetAllConfig::invoke(BaseLib::PRpcClientInfo clientInfo, s
 		if(parameters->size() > 0) peerID = parameters->at(0)->integerValue;
 
 		BaseLib::PVariable config(new BaseLib::Variable(BaseLib::VariableType::tArray));
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
-		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
+		if(peerID > 0)
 		{
-			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
-			if(!central) continue;
-			if(peerID > 0 && !central->peerExists(peerID)) continue;
-			std::this_thread::sleep_for(std::chrono::milliseconds(3));
-			BaseLib::PVariable result = central->getAllConfig(clientInfo, peerID);
-			if(result && result->errorStruct)
+			std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
+			for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
 			{
-				if(peerID > 0) return result;
-				else GD::out.printWarning("Warning: Error calling method \"getAllConfig\" on device family " + i->second->getName() + ": " + result->structValue->at("faultString")->stringValue);
-				continue;
+				std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
+				if(!central || !central->peerExists(peerID)) continue;
+				BaseLib::PVariable result = central->getAllConfig(clientInfo, peerID);
+				if(result && result->errorStruct) return result;
+				if(result && !result->arrayValue->empty()) config->arrayValue->insert(config->arrayValue->end(), result->arrayValue->begin(), result->arrayValue->end());
+				break;
+			}
+		}
+		else
+		{
+			std::vector<BaseLib::PVariable> results = invokeFamilies([&](std::shared_ptr<BaseLib::Systems::DeviceFamily>& family) -> BaseLib::PVariable
+			{
+				std::shared_ptr<BaseLib::Systems::ICentral> central = family->getCentral();
+				if(!central) return BaseLib::PVariable();
+				BaseLib::PVariable result = central->getAllConfig(clientInfo, peerID);
+				if(result && result->errorStruct)
+				{
+					GD::out.printWarning("Warning: Error calling method \"getAllConfig\" on device family " + family->getName() + ": " + result->structValue->at("faultString")->stringValue);
+					return BaseLib::PVariable();
+				}
+				return result;
+			});
+			for(std::vector<BaseLib::PVariable>::iterator i = results.begin(); i != results.end(); ++i)
+			{
+				if(*i && !(*i)->arrayValue->empty()) config->arrayValue->insert(config->arrayValue->end(), (*i)->arrayValue->begin(), (*i)->arrayValue->end());
 			}
-			if(result && !result->arrayValue->empty()) config->arrayValue->insert(config->arrayValue->end(), result->arrayValue->begin(), result->arrayValue->end());
-			if(peerID > 0) break;
 		}
 
 		if(config->arrayValue->empty() && peerID > 0) return BaseLib::Variable::createError(-2, "Unknown device.");
@@ -989,9 +1088,13 @@ BaseLib::PVariable RPCGetAllScripts::invoke(BaseLib::PRpcClientInfo clientInfo,
 {
 	try
 	{
-		if(!parameters->empty()) return getError(ParameterError::Enum::wrongCount);
+		ParameterError::Enum error = checkParameters(parameters, std::vector<std::vector<BaseLib::VariableType>>({
+				std::vector<BaseLib::VariableType>(),
+				std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tBoolean })
+		}));
+		if(error != ParameterError::Enum::noError) return getError(error);
 
-		return GD::scriptEngineServer->getAllScripts();
+		return GD::scriptEngineServer->getAllScripts(parameters->empty() ? false : parameters->at(0)->booleanValue);
 	}
 	catch(const std::exception& ex)
     {
@@ -1040,13 +1143,16 @@ BaseLib::PVariable RPCGetAllValues::invoke(BaseLib::PRpcClientInfo clientInfo, s
 			ParameterError::Enum error = checkParameters(parameters, std::vector<std::vector<BaseLib::VariableType>>({
 				std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tBoolean }),
 				std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tInteger }),
-				std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tInteger, BaseLib::VariableType::tBoolean })
+				std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tInteger, BaseLib::VariableType::tBoolean }),
+				std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tBoolean, BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger })
 			}));
 			if(error != ParameterError::Enum::noError) return getError(error);
 		}
 
 		uint64_t peerID = 0;
 		bool returnWriteOnly = false;
+		int32_t offset = 0;
+		int32_t limit = 0;
 		if(parameters->size() == 1 && parameters->at(0)->type == BaseLib::VariableType::tBoolean)
 		{
 			returnWriteOnly = parameters->at(0)->booleanValue;
@@ -1060,24 +1166,40 @@ BaseLib::PVariable RPCGetAllValues::invoke(BaseLib::PRpcClientInfo clientInfo, s
 			peerID = parameters->at(0)->integerValue;
 			returnWriteOnly = parameters->at(1)->booleanValue;
 		}
+		else if(parameters->size() == 3)
+		{
+			returnWriteOnly = parameters->at(0)->booleanValue;
+			offset = parameters->at(1)->integerValue;
+			limit = parameters->at(2)->integerValue;
+			if(offset < 0 || limit < 0) return BaseLib::Variable::createError(-1, "Offset or limit is negative.");
+		}
 
 		BaseLib::PVariable values(new BaseLib::Variable(BaseLib::VariableType::tArray));
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
-		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
+		if(peerID > 0)
 		{
-			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
-			if(!central) continue;
-			if(peerID > 0 && !central->peerExists(peerID)) continue;
-			std::this_thread::sleep_for(std::chrono::milliseconds(3));
-			BaseLib::PVariable result = central->getAllValues(clientInfo, peerID, returnWriteOnly);
-			if(result && result->errorStruct)
+			std::shared_ptr<BaseLib::Systems::ICentral> central = GD::familyController->getCentral(peerID);
+			if(central)
 			{
-				if(peerID > 0) return result;
-				else GD::out.printWarning("Warning: Error calling method \"getAllValues\" on device family " + i->second->getName() + ": " + result->structValue->at("faultString")->stringValue);
-				continue;
+				BaseLib::PVariable result = central->getAllValues(clientInfo, peerID, returnWriteOnly);
+				if(result && result->errorStruct) return result;
+				if(result && !result->arrayValue->empty()) values->arrayValue->insert(values->arrayValue->end(), result->arrayValue->begin(), result->arrayValue->end());
 			}
-			if(result && !result->arrayValue->empty()) values->arrayValue->insert(values->arrayValue->end(), result->arrayValue->begin(), result->arrayValue->end());
-			if(peerID > 0) break;
+		}
+		else
+		{
+			std::vector<BaseLib::PVariable> results = invokeFamilies([&](std::shared_ptr<BaseLib::Systems::DeviceFamily>& family) -> BaseLib::PVariable
+			{
+				std::shared_ptr<BaseLib::Systems::ICentral> central = family->getCentral();
+				if(!central) return BaseLib::PVariable();
+				BaseLib::PVariable result = central->getAllValues(clientInfo, peerID, returnWriteOnly);
+				if(result && result->errorStruct)
+				{
+					GD::out.printWarning("Warning: Error calling method \"getAllValues\" on device family " + family->getName() + ": " + result->structValue->at("faultString")->stringValue);
+					return BaseLib::PVariable();
+				}
+				return result;
+			});
+			values = mergeArrays(results, offset, limit);
 		}
 
 		if(values->arrayValue->empty() && peerID > 0) return BaseLib::Variable::createError(-2, "Unknown device.");
@@ -1260,30 +1382,31 @@ BaseLib::PVariable RPCGetDeviceInfo::invoke(BaseLib::PRpcClientInfo clientInfo,
 		}
 
 		BaseLib::PVariable deviceInfo(new BaseLib::Variable(BaseLib::VariableType::tArray));
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
-		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
+		if(peerID > 0)
 		{
-			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
-			if(!central) continue;
-			if(peerID > 0)
-			{
-				if(central->peerExists(peerID)) return central->getDeviceInfo(clientInfo, peerID, fields);
-			}
-			else
+			std::shared_ptr<BaseLib::Systems::ICentral> central = GD::familyController->getCentral(peerID);
+			if(central) return central->getDeviceInfo(clientInfo, peerID, fields);
+			return BaseLib::Variable::createError(-2, "Device not found.");
+		}
+
+		std::vector<BaseLib::PVariable> results = invokeFamilies([&](std::shared_ptr<BaseLib::Systems::DeviceFamily>& family) -> BaseLib::PVariable
+		{
+			std::shared_ptr<BaseLib::Systems::ICentral> central = family->getCentral();
+			if(!central) return BaseLib::PVariable();
+			BaseLib::PVariable result = central->getDeviceInfo(clientInfo, peerID, fields);
+			if(result && result->errorStruct)
 			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(3));
-				BaseLib::PVariable result = central->getDeviceInfo(clientInfo, peerID, fields);
-				if(result && result->errorStruct)
-				{
-					GD::out.printWarning("Warning: Error calling method \"listDevices\" on device family " + i->second->getName() + ": " + result->structValue->at("faultString")->stringValue);
-					continue;
-				}
-				if(result && !result->arrayValue->empty()) deviceInfo->arrayValue->insert(deviceInfo->arrayValue->end(), result->arrayValue->begin(), result->arrayValue->end());
+				GD::out.printWarning("Warning: Error calling method \"listDevices\" on device family " + family->getName() + ": " + result->structValue->at("faultString")->stringValue);
+				return BaseLib::PVariable();
 			}
+			return result;
+		});
+		for(std::vector<BaseLib::PVariable>::iterator i = results.begin(); i != results.end(); ++i)
+		{
+			if(*i && !(*i)->arrayValue->empty()) deviceInfo->arrayValue->insert(deviceInfo->arrayValue->end(), (*i)->arrayValue->begin(), (*i)->arrayValue->end());
 		}
 
-		if(peerID == 0) return deviceInfo;
-		return BaseLib::Variable::createError(-2, "Device not found.");
+		return deviceInfo;
 	}
 	catch(const std::exception& ex)
     {
@@ -1584,32 +1707,37 @@ BaseLib::PVariable RPCGetLinks::invoke(BaseLib::PRpcClientInfo clientInfo, std::
 		}
 
 		BaseLib::PVariable links(new BaseLib::Variable(BaseLib::VariableType::tArray));
+		if(serialNumber.empty() && peerID == 0)
+		{
+			std::vector<BaseLib::PVariable> results = invokeFamilies([&](std::shared_ptr<BaseLib::Systems::DeviceFamily>& family) -> BaseLib::PVariable
+			{
+				std::shared_ptr<BaseLib::Systems::ICentral> central = family->getCentral();
+				if(!central) return BaseLib::PVariable();
+				return central->getLinks(clientInfo, peerID, channel, flags);
+			});
+			for(std::vector<BaseLib::PVariable>::iterator i = results.begin(); i != results.end(); ++i)
+			{
+				if(*i && !(*i)->arrayValue->empty()) links->arrayValue->insert(links->arrayValue->end(), (*i)->arrayValue->begin(), (*i)->arrayValue->end());
+			}
+			return links;
+		}
+
 		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
 		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
 		{
 			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
 			if(!central) continue;
-			std::this_thread::sleep_for(std::chrono::milliseconds(3));
-			if(serialNumber.empty() && peerID == 0)
+			if(useSerialNumber)
 			{
-				BaseLib::PVariable result = central->getLinks(clientInfo, peerID, channel, flags);
-				if(result && !result->arrayValue->empty()) links->arrayValue->insert(links->arrayValue->end(), result->arrayValue->begin(), result->arrayValue->end());
+				if(central->peerExists(serialNumber)) return central->getLinks(clientInfo, serialNumber, channel, flags);
 			}
 			else
 			{
-				if(useSerialNumber)
-				{
-					if(central->peerExists(serialNumber)) return central->getLinks(clientInfo, serialNumber, channel, flags);
-				}
-				else
-				{
-					if(central->peerExists(peerID)) return central->getLinks(clientInfo, peerID, channel, flags);
-				}
+				if(central->peerExists(peerID)) return central->getLinks(clientInfo, peerID, channel, flags);
 			}
 		}
 
-		if(serialNumber.empty() && peerID == 0) return links;
-		else return BaseLib::Variable::createError(-2, "Device not found.");
+		return BaseLib::Variable::createError(-2, "Device not found.");
 	}
 	catch(const std::exception& ex)
     {
@@ -1698,6 +1826,30 @@ BaseLib::PVariable RPCGetMetadata::invoke(BaseLib::PRpcClientInfo clientInfo, st
     return BaseLib::Variable::createError(-32500, "Unknown application error.");
 }
 
+BaseLib::PVariable RPCGetMetrics::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
+{
+	try
+	{
+		ParameterError::Enum error = checkParameters(parameters, std::vector<BaseLib::VariableType>());
+		if(error != ParameterError::Enum::noError) return getError(error);
+
+		return GD::metrics.getMetrics();
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
+
 BaseLib::PVariable RPCGetName::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
 {
 	try
@@ -2006,22 +2158,10 @@ BaseLib::PVariable RPCGetParamset::invoke(BaseLib::PRpcClientInfo clientInfo, st
 			remoteChannel = parameters->at(3)->integerValue;
 		}
 
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
-		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
-		{
-			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
-			if(!central) continue;
-			if(useSerialNumber)
-			{
-				if(central->peerExists(serialNumber)) return central->getParamset(clientInfo, serialNumber, channel, type, remoteSerialNumber, remoteChannel);
-			}
-			else
-			{
-				if(central->peerExists((uint64_t)parameters->at(0)->integerValue)) return central->getParamset(clientInfo, parameters->at(0)->integerValue, parameters->at(1)->integerValue, type, remoteID, remoteChannel);
-			}
-		}
-
-		return BaseLib::Variable::createError(-2, "Device not found.");
+		std::shared_ptr<BaseLib::Systems::ICentral> central = useSerialNumber ? GD::familyController->getCentral(serialNumber) : GD::familyController->getCentral((uint64_t)parameters->at(0)->integerValue);
+		if(!central) return BaseLib::Variable::createError(-2, "Device not found.");
+		if(useSerialNumber) return central->getParamset(clientInfo, serialNumber, channel, type, remoteSerialNumber, remoteChannel);
+		return central->getParamset(clientInfo, parameters->at(0)->integerValue, parameters->at(1)->integerValue, type, remoteID, remoteChannel);
 	}
 	catch(const std::exception& ex)
     {
@@ -2038,6 +2178,29 @@ BaseLib::PVariable RPCGetParamset::invoke(BaseLib::PRpcClientInfo clientInfo, st
     return BaseLib::Variable::createError(-32500, "Unknown application error. Check the address format.");
 }
 
+bool RPCGetParamset::isReadOnlyCall(std::shared_ptr<std::vector<BaseLib::PVariable>>& parameters, std::string& serializationKey)
+{
+	try
+	{
+		if(!parameters || parameters->empty()) return true; //Invalid calls only return an error
+		serializationKey = getPeerSerializationKey(parameters->at(0));
+		return true;
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return false;
+}
+
 BaseLib::PVariable RPCGetPeerId::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
 {
 	try
@@ -2079,6 +2242,35 @@ BaseLib::PVariable RPCGetPeerId::invoke(BaseLib::PRpcClientInfo clientInfo, std:
     return BaseLib::Variable::createError(-32500, "Unknown application error. Check the address format.");
 }
 
+BaseLib::PVariable RPCGetRpcStatistics::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
+{
+	try
+	{
+		ParameterError::Enum error = checkParameters(parameters, std::vector<std::vector<BaseLib::VariableType>>({
+			std::vector<BaseLib::VariableType>(),
+			std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tBoolean })
+		}));
+		if(error != ParameterError::Enum::noError) return getError(error);
+
+		BaseLib::PVariable statistics = GD::rpcStatistics.getStatistics();
+		if(parameters->size() == 1 && parameters->at(0)->booleanValue) GD::rpcStatistics.reset();
+		return statistics;
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
+
 BaseLib::PVariable RPCGetServiceMessages::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
 {
 	try
@@ -2093,15 +2285,16 @@ BaseLib::PVariable RPCGetServiceMessages::invoke(BaseLib::PRpcClientInfo clientI
 		if(parameters->size() == 1) id = parameters->at(0)->booleanValue;
 
 		BaseLib::PVariable serviceMessages(new BaseLib::Variable(BaseLib::VariableType::tArray));
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
-		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
+		//getServiceMessages really needs a lot of ressources, so only two centrals are queried at the same time.
+		std::vector<BaseLib::PVariable> results = invokeFamilies([&](std::shared_ptr<BaseLib::Systems::DeviceFamily>& family) -> BaseLib::PVariable
 		{
-			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
-			if(!central) continue;
-			//getServiceMessages really needs a lot of ressources, so wait a little bit after each central
-			std::this_thread::sleep_for(std::chrono::milliseconds(3));
-			BaseLib::PVariable messages = central->getServiceMessages(clientInfo, id);
-			if(!messages->arrayValue->empty()) serviceMessages->arrayValue->insert(serviceMessages->arrayValue->end(), messages->arrayValue->begin(), messages->arrayValue->end());
+			std::shared_ptr<BaseLib::Systems::ICentral> central = family->getCentral();
+			if(!central) return BaseLib::PVariable();
+			return central->getServiceMessages(clientInfo, id);
+		}, 2);
+		for(std::vector<BaseLib::PVariable>::iterator i = results.begin(); i != results.end(); ++i)
+		{
+			if(*i && !(*i)->arrayValue->empty()) serviceMessages->arrayValue->insert(serviceMessages->arrayValue->end(), (*i)->arrayValue->begin(), (*i)->arrayValue->end());
 		}
 
 		return serviceMessages;
@@ -2145,6 +2338,32 @@ BaseLib::PVariable RPCGetSystemVariable::invoke(BaseLib::PRpcClientInfo clientIn
     return BaseLib::Variable::createError(-32500, "Unknown application error.");
 }
 
+BaseLib::PVariable RPCGetSystemVariables::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
+{
+	try
+	{
+		ParameterError::Enum error = checkParameters(parameters, std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tArray }));
+		if(error != ParameterError::Enum::noError) return getError(error);
+
+		DatabaseController* db = static_cast<DatabaseController*>(GD::bl->db.get());
+		if(!db) return BaseLib::Variable::createError(-32500, "Database controller is not available.");
+		return db->getSystemVariables(parameters->at(0)->arrayValue);
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
+
 BaseLib::PVariable RPCGetUpdateStatus::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
 {
 	try
@@ -2223,20 +2442,146 @@ BaseLib::PVariable RPCGetValue::invoke(BaseLib::PRpcClientInfo clientInfo, std::
 			if(parameters->size() >= 5) asynchronously = parameters->at(4)->booleanValue;
 		}
 
+		std::shared_ptr<BaseLib::Systems::ICentral> central = useSerialNumber ? GD::familyController->getCentral(serialNumber) : GD::familyController->getCentral((uint64_t)parameters->at(0)->integerValue);
+		if(!central) return BaseLib::Variable::createError(-2, "Device not found.");
+		if(useSerialNumber) return central->getValue(clientInfo, serialNumber, channel, parameters->at(1)->stringValue, requestFromDevice, asynchronously);
+		return central->getValue(clientInfo, parameters->at(0)->integerValue, parameters->at(1)->integerValue, parameters->at(2)->stringValue, requestFromDevice, asynchronously);
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return BaseLib::Variable::createError(-32500, "Unknown application error. Check the address format.");
+}
+
+bool RPCGetValue::isReadOnlyCall(std::shared_ptr<std::vector<BaseLib::PVariable>>& parameters, std::string& serializationKey)
+{
+	try
+	{
+		if(!parameters || parameters->size() < 2) return true; //Invalid calls only return an error
+		size_t requestFromDeviceIndex = parameters->at(0)->type == BaseLib::VariableType::tString ? 2 : 3;
+		if(parameters->size() > requestFromDeviceIndex && parameters->at(requestFromDeviceIndex)->booleanValue) serializationKey = getPeerSerializationKey(parameters->at(0));
+		return true;
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return false;
+}
+
+BaseLib::PVariable RPCGetValues::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
+{
+	try
+	{
+		ParameterError::Enum error = checkParameters(parameters, std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tArray }));
+		if(error != ParameterError::Enum::noError) return getError(error);
+
+		std::map<uint64_t, std::shared_ptr<BaseLib::Systems::ICentral>> centrals;
+
+		BaseLib::PVariable values(new BaseLib::Variable(BaseLib::VariableType::tArray));
+		values->arrayValue->reserve(parameters->at(0)->arrayValue->size());
+		for(BaseLib::Array::iterator i = parameters->at(0)->arrayValue->begin(); i != parameters->at(0)->arrayValue->end(); ++i)
+		{
+			//Each element is an array containing peer ID, channel and variable name.
+			if((*i)->type != BaseLib::VariableType::tArray || (*i)->arrayValue->size() < 3 || (*i)->arrayValue->at(0)->type != BaseLib::VariableType::tInteger || (*i)->arrayValue->at(1)->type != BaseLib::VariableType::tInteger || (*i)->arrayValue->at(2)->type != BaseLib::VariableType::tString)
+			{
+				values->arrayValue->push_back(BaseLib::Variable::createError(-1, "Invalid element. Expected array with peer ID, channel and variable name."));
+				continue;
+			}
+			uint64_t peerId = (*i)->arrayValue->at(0)->integerValue;
+
+			std::shared_ptr<BaseLib::Systems::ICentral> central;
+			std::map<uint64_t, std::shared_ptr<BaseLib::Systems::ICentral>>::iterator centralIterator = centrals.find(peerId);
+			if(centralIterator != centrals.end()) central = centralIterator->second;
+			else
+			{
+				central = GD::familyController->getCentral(peerId);
+				centrals[peerId] = central;
+			}
+
+			if(!central) values->arrayValue->push_back(BaseLib::Variable::createError(-2, "Device not found."));
+			else values->arrayValue->push_back(central->getValue(clientInfo, peerId, (*i)->arrayValue->at(1)->integerValue, (*i)->arrayValue->at(2)->stringValue, false, false));
+		}
+
+		return values;
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
+
+BaseLib::PVariable RPCGetValuesChangedSince::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
+{
+	try
+	{
+		ParameterError::Enum error = checkParameters(parameters, std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger }));
+		if(error != ParameterError::Enum::noError) return getError(error);
+
+		return GD::familyController->getValuesChangedSince(parameters->at(0)->integerValue, parameters->at(1)->integerValue);
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
+
+BaseLib::PVariable RPCGetValuesSnapshot::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
+{
+	try
+	{
+		ParameterError::Enum error = checkParameters(parameters, std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger }));
+		if(error != ParameterError::Enum::noError) return getError(error);
+
+		//All values of the channel are read by the peer in one call instead of one request per value.
 		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
 		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
 		{
 			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
-			if(central)
+			if(central && central->peerExists((uint64_t)parameters->at(0)->integerValue))
 			{
-				if(useSerialNumber)
-				{
-					if(central->peerExists(serialNumber)) return central->getValue(clientInfo, serialNumber, channel, parameters->at(1)->stringValue, requestFromDevice, asynchronously);
-				}
-				else
-				{
-					if(central->peerExists((uint64_t)parameters->at(0)->integerValue)) return central->getValue(clientInfo, parameters->at(0)->integerValue, parameters->at(1)->integerValue, parameters->at(2)->stringValue, requestFromDevice, asynchronously);
-				}
+				BaseLib::PVariable values = central->getParamset(clientInfo, parameters->at(0)->integerValue, parameters->at(1)->integerValue, BaseLib::DeviceDescription::ParameterGroup::Type::Enum::variables, 0, -1);
+				if(values->errorStruct) return values;
+
+				BaseLib::PVariable snapshot(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+				snapshot->structValue->insert(BaseLib::StructElement("TIME", BaseLib::PVariable(new BaseLib::Variable(BaseLib::HelperFunctions::getTimeSeconds()))));
+				snapshot->structValue->insert(BaseLib::StructElement("VALUES", values));
+				return snapshot;
 			}
 		}
 
@@ -2254,7 +2599,7 @@ BaseLib::PVariable RPCGetValue::invoke(BaseLib::PRpcClientInfo clientInfo, std::
     {
     	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
     }
-    return BaseLib::Variable::createError(-32500, "Unknown application error. Check the address format.");
+    return BaseLib::Variable::createError(-32500, "Unknown application error.");
 }
 
 BaseLib::PVariable RPCGetVersion::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
@@ -2490,12 +2835,21 @@ BaseLib::PVariable RPCListDevices::invoke(BaseLib::PRpcClientInfo clientInfo, st
 					std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tBoolean }),
 					std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tString }),
 					std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tBoolean, BaseLib::VariableType::tArray }),
+					std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tBoolean, BaseLib::VariableType::tArray, BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger }),
 			}));
 			if(error != ParameterError::Enum::noError) return getError(error);
 		}
 		bool channels = true;
 		std::map<std::string, bool> fields;
-		if(parameters->size() == 2)
+		int32_t offset = 0;
+		int32_t limit = 0;
+		if(parameters->size() == 4)
+		{
+			offset = parameters->at(2)->integerValue;
+			limit = parameters->at(3)->integerValue;
+			if(offset < 0 || limit < 0) return BaseLib::Variable::createError(-1, "Offset or limit is negative.");
+		}
+		if(parameters->size() >= 2)
 		{
 			channels = parameters->at(0)->booleanValue;
 			for(std::vector<BaseLib::PVariable>::iterator i = parameters->at(1)->arrayValue->begin(); i != parameters->at(1)->arrayValue->end(); ++i)
@@ -2505,23 +2859,20 @@ BaseLib::PVariable RPCListDevices::invoke(BaseLib::PRpcClientInfo clientInfo, st
 			}
 		}
 
-		BaseLib::PVariable devices(new BaseLib::Variable(BaseLib::VariableType::tArray));
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
-		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
+		std::vector<BaseLib::PVariable> results = invokeFamilies([&](std::shared_ptr<BaseLib::Systems::DeviceFamily>& family) -> BaseLib::PVariable
 		{
-			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
-			if(!central) continue;
-			std::this_thread::sleep_for(std::chrono::milliseconds(3));
+			std::shared_ptr<BaseLib::Systems::ICentral> central = family->getCentral();
+			if(!central) return BaseLib::PVariable();
 			BaseLib::PVariable result = central->listDevices(clientInfo, channels, fields);
 			if(result && result->errorStruct)
 			{
-				GD::out.printWarning("Warning: Error calling method \"listDevices\" on device family " + i->second->getName() + ": " + result->structValue->at("faultString")->stringValue);
-				continue;
+				GD::out.printWarning("Warning: Error calling method \"listDevices\" on device family " + family->getName() + ": " + result->structValue->at("faultString")->stringValue);
+				return BaseLib::PVariable();
 			}
-			if(result && !result->arrayValue->empty()) devices->arrayValue->insert(devices->arrayValue->end(), result->arrayValue->begin(), result->arrayValue->end());
-		}
+			return result;
+		});
 
-		return devices;
+		return mergeArrays(results, offset, limit);
 	}
 	catch(const std::exception& ex)
     {
@@ -2667,17 +3018,19 @@ BaseLib::PVariable RPCListKnownDeviceTypes::invoke(BaseLib::PRpcClientInfo clien
 		}
 
 		BaseLib::PVariable devices(new BaseLib::Variable(BaseLib::VariableType::tArray));
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
-		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
+		std::vector<BaseLib::PVariable> results = invokeFamilies([&](std::shared_ptr<BaseLib::Systems::DeviceFamily>& family) -> BaseLib::PVariable
 		{
-			std::this_thread::sleep_for(std::chrono::milliseconds(3));
-			BaseLib::PVariable result = i->second->listKnownDeviceTypes(clientInfo, channels, fields);
+			BaseLib::PVariable result = family->listKnownDeviceTypes(clientInfo, channels, fields);
 			if(result && result->errorStruct)
 			{
-				GD::out.printWarning("Warning: Error calling method \"listKnownDeviceTypes\" on device family " + i->second->getName() + ": " + result->structValue->at("faultString")->stringValue);
-				continue;
+				GD::out.printWarning("Warning: Error calling method \"listKnownDeviceTypes\" on device family " + family->getName() + ": " + result->structValue->at("faultString")->stringValue);
+				return BaseLib::PVariable();
 			}
-			if(result && !result->arrayValue->empty()) devices->arrayValue->insert(devices->arrayValue->end(), result->arrayValue->begin(), result->arrayValue->end());
+			return result;
+		});
+		for(std::vector<BaseLib::PVariable>::iterator i = results.begin(); i != results.end(); ++i)
+		{
+			if(*i && !(*i)->arrayValue->empty()) devices->arrayValue->insert(devices->arrayValue->end(), (*i)->arrayValue->begin(), (*i)->arrayValue->end());
 		}
 
 		return devices;
@@ -2704,14 +3057,15 @@ BaseLib::PVariable RPCListTeams::invoke(BaseLib::PRpcClientInfo clientInfo, std:
 		if(!parameters->empty()) return getError(ParameterError::Enum::wrongCount);
 
 		BaseLib::PVariable teams(new BaseLib::Variable(BaseLib::VariableType::tArray));
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
-		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
+		std::vector<BaseLib::PVariable> results = invokeFamilies([&](std::shared_ptr<BaseLib::Systems::DeviceFamily>& family) -> BaseLib::PVariable
 		{
-			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
-			if(!central) continue;
-			std::this_thread::sleep_for(std::chrono::milliseconds(3));
-			BaseLib::PVariable result = central->listTeams(clientInfo);
-			if(!result->arrayValue->empty()) teams->arrayValue->insert(teams->arrayValue->end(), result->arrayValue->begin(), result->arrayValue->end());
+			std::shared_ptr<BaseLib::Systems::ICentral> central = family->getCentral();
+			if(!central) return BaseLib::PVariable();
+			return central->listTeams(clientInfo);
+		});
+		for(std::vector<BaseLib::PVariable>::iterator i = results.begin(); i != results.end(); ++i)
+		{
+			if(*i && !(*i)->arrayValue->empty()) teams->arrayValue->insert(teams->arrayValue->end(), (*i)->arrayValue->begin(), (*i)->arrayValue->end());
 		}
 
 		return teams;
@@ -2820,22 +3174,10 @@ BaseLib::PVariable RPCPutParamset::invoke(BaseLib::PRpcClientInfo clientInfo, st
 			remoteChannel = parameters->at(3)->integerValue;
 		}
 
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
-		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
-		{
-			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
-			if(!central)continue;
-			if(useSerialNumber)
-			{
-				if(central->peerExists(serialNumber)) return central->putParamset(clientInfo, serialNumber, channel, type, remoteSerialNumber, remoteChannel, parameters->back());
-			}
-			else
-			{
-				if(central->peerExists((uint64_t)parameters->at(0)->integerValue)) return central->putParamset(clientInfo, parameters->at(0)->integerValue, parameters->at(1)->integerValue, type, remoteID, remoteChannel, parameters->back());
-			}
-		}
-
-		return BaseLib::Variable::createError(-2, "Device not found.");
+		std::shared_ptr<BaseLib::Systems::ICentral> central = useSerialNumber ? GD::familyController->getCentral(serialNumber) : GD::familyController->getCentral((uint64_t)parameters->at(0)->integerValue);
+		if(!central) return BaseLib::Variable::createError(-2, "Device not found.");
+		if(useSerialNumber) return central->putParamset(clientInfo, serialNumber, channel, type, remoteSerialNumber, remoteChannel, parameters->back());
+		return central->putParamset(clientInfo, parameters->at(0)->integerValue, parameters->at(1)->integerValue, type, remoteID, remoteChannel, parameters->back());
 	}
 	catch(const std::exception& ex)
     {
@@ -2998,19 +3340,21 @@ BaseLib::PVariable RPCRssiInfo::invoke(BaseLib::PRpcClientInfo clientInfo, std::
 		if(parameters->size() > 0) return getError(ParameterError::Enum::wrongCount);
 
 		BaseLib::PVariable response(new BaseLib::Variable(BaseLib::VariableType::tStruct));
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
-		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
+		std::vector<BaseLib::PVariable> results = invokeFamilies([&](std::shared_ptr<BaseLib::Systems::DeviceFamily>& family) -> BaseLib::PVariable
 		{
-			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
-			if(!central) continue;
-			std::this_thread::sleep_for(std::chrono::milliseconds(3));
+			std::shared_ptr<BaseLib::Systems::ICentral> central = family->getCentral();
+			if(!central) return BaseLib::PVariable();
 			BaseLib::PVariable result = central->rssiInfo(clientInfo);
 			if(result && result->errorStruct)
 			{
-				GD::out.printWarning("Warning: Error calling method \"rssiInfo\" on device family " + i->second->getName() + ": " + result->structValue->at("faultString")->stringValue);
-				continue;
+				GD::out.printWarning("Warning: Error calling method \"rssiInfo\" on device family " + family->getName() + ": " + result->structValue->at("faultString")->stringValue);
+				return BaseLib::PVariable();
 			}
-			if(result && !result->structValue->empty()) response->structValue->insert(result->structValue->begin(), result->structValue->end());
+			return result;
+		});
+		for(std::vector<BaseLib::PVariable>::iterator i = results.begin(); i != results.end(); ++i)
+		{
+			if(*i && !(*i)->structValue->empty()) response->structValue->insert((*i)->structValue->begin(), (*i)->structValue->end());
 		}
 
 		return response;
@@ -3213,7 +3557,9 @@ BaseLib::PVariable RPCSetId::invoke(BaseLib::PRpcClientInfo clientInfo, std::sha
 			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
 			if(central && central->peerExists((uint64_t)parameters->at(0)->integerValue))
 			{
-				return central->setId(clientInfo, parameters->at(0)->integerValue, parameters->at(1)->integerValue);
+				BaseLib::PVariable result = central->setId(clientInfo, parameters->at(0)->integerValue, parameters->at(1)->integerValue);
+				GD::familyController->clearPeerIndexMisses();
+				return result;
 			}
 		}
 
@@ -3525,9 +3871,18 @@ BaseLib::PVariable RPCSetSystemVariable::invoke(BaseLib::PRpcClientInfo clientIn
 {
 	try
 	{
-		ParameterError::Enum error = checkParameters(parameters, std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tString, BaseLib::VariableType::tVariant }));
+		ParameterError::Enum error = checkParameters(parameters, std::vector<std::vector<BaseLib::VariableType>>({
+				std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tString, BaseLib::VariableType::tVariant }),
+				std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tString, BaseLib::VariableType::tVariant, BaseLib::VariableType::tBoolean })
+		}));
 		if(error != ParameterError::Enum::noError) return getError(error);
 
+		if(parameters->size() == 3)
+		{
+			//The caller wants to know, that the events were queued for all subscribers.
+			DatabaseController* db = static_cast<DatabaseController*>(GD::bl->db.get());
+			if(db) return db->setSystemVariable(parameters->at(0)->stringValue, parameters->at(1), parameters->at(2)->booleanValue);
+		}
 		return GD::bl->db->setSystemVariable(parameters->at(0)->stringValue, parameters->at(1));
 	}
 	catch(const std::exception& ex)
@@ -3545,6 +3900,35 @@ BaseLib::PVariable RPCSetSystemVariable::invoke(BaseLib::PRpcClientInfo clientIn
     return BaseLib::Variable::createError(-32500, "Unknown application error.");
 }
 
+BaseLib::PVariable RPCSetSystemVariables::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
+{
+	try
+	{
+		ParameterError::Enum error = checkParameters(parameters, std::vector<std::vector<BaseLib::VariableType>>({
+				std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tStruct }),
+				std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tStruct, BaseLib::VariableType::tBoolean })
+		}));
+		if(error != ParameterError::Enum::noError) return getError(error);
+
+		DatabaseController* db = static_cast<DatabaseController*>(GD::bl->db.get());
+		if(!db) return BaseLib::Variable::createError(-32500, "Database controller is not available.");
+		return db->setSystemVariables(parameters->at(0)->structValue, parameters->size() == 2 && parameters->at(1)->booleanValue);
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
+
 BaseLib::PVariable RPCSetTeam::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
 {
 	try
@@ -3661,24 +4045,62 @@ BaseLib::PVariable RPCSetValue::invoke(BaseLib::PRpcClientInfo clientInfo, std::
 		if(useSerialNumber && parameters->size() == 4) wait = parameters->at(3)->booleanValue;
 		else if(!useSerialNumber && parameters->size() == 5) wait = parameters->at(4)->booleanValue;
 
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = GD::familyController->getFamilies();
-		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
+		std::shared_ptr<BaseLib::Systems::ICentral> central = useSerialNumber ? GD::familyController->getCentral(serialNumber) : GD::familyController->getCentral((uint64_t)parameters->at(0)->integerValue);
+		if(!central) return BaseLib::Variable::createError(-2, "Device not found.");
+		if(useSerialNumber) return central->setValue(clientInfo, serialNumber, channel, parameters->at(1)->stringValue, value, wait);
+		return central->setValue(clientInfo, parameters->at(0)->integerValue, parameters->at(1)->integerValue, parameters->at(2)->stringValue, value, wait);
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return BaseLib::Variable::createError(-32500, "Unknown application error. Check the address format.");
+}
+
+BaseLib::PVariable RPCSetValues::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
+{
+	try
+	{
+		ParameterError::Enum error = checkParameters(parameters, std::vector<BaseLib::VariableType>({ BaseLib::VariableType::tArray }));
+		if(error != ParameterError::Enum::noError) return getError(error);
+
+		std::map<uint64_t, std::shared_ptr<BaseLib::Systems::ICentral>> centrals;
+
+		BaseLib::PVariable results(new BaseLib::Variable(BaseLib::VariableType::tArray));
+		results->arrayValue->reserve(parameters->at(0)->arrayValue->size());
+		for(BaseLib::Array::iterator i = parameters->at(0)->arrayValue->begin(); i != parameters->at(0)->arrayValue->end(); ++i)
 		{
-			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
-			if(central)
+			//Each element is an array containing peer ID, channel, variable name, value and optionally "wait".
+			if((*i)->type != BaseLib::VariableType::tArray || (*i)->arrayValue->size() < 4 || (*i)->arrayValue->at(0)->type != BaseLib::VariableType::tInteger || (*i)->arrayValue->at(1)->type != BaseLib::VariableType::tInteger || (*i)->arrayValue->at(2)->type != BaseLib::VariableType::tString)
 			{
-				if(useSerialNumber)
-				{
-					if(central->peerExists(serialNumber)) return central->setValue(clientInfo, serialNumber, channel, parameters->at(1)->stringValue, value, wait);
-				}
-				else
-				{
-					if(central->peerExists((uint64_t)parameters->at(0)->integerValue)) return central->setValue(clientInfo, parameters->at(0)->integerValue, parameters->at(1)->integerValue, parameters->at(2)->stringValue, value, wait);
-				}
+				results->arrayValue->push_back(BaseLib::Variable::createError(-1, "Invalid element. Expected array with peer ID, channel, variable name and value."));
+				continue;
 			}
+			uint64_t peerId = (*i)->arrayValue->at(0)->integerValue;
+			bool wait = (*i)->arrayValue->size() >= 5 ? (*i)->arrayValue->at(4)->booleanValue : true;
+
+			std::shared_ptr<BaseLib::Systems::ICentral> central;
+			std::map<uint64_t, std::shared_ptr<BaseLib::Systems::ICentral>>::iterator centralIterator = centrals.find(peerId);
+			if(centralIterator != centrals.end()) central = centralIterator->second;
+			else
+			{
+				central = GD::familyController->getCentral(peerId);
+				centrals[peerId] = central;
+			}
+
+			if(!central) results->arrayValue->push_back(BaseLib::Variable::createError(-2, "Device not found."));
+			else results->arrayValue->push_back(central->setValue(clientInfo, peerId, (*i)->arrayValue->at(1)->integerValue, (*i)->arrayValue->at(2)->stringValue, (*i)->arrayValue->at(3), wait));
 		}
 
-		return BaseLib::Variable::createError(-2, "Device not found.");
+		return results;
 	}
 	catch(const std::exception& ex)
     {
@@ -3692,7 +4114,7 @@ BaseLib::PVariable RPCSetValue::invoke(BaseLib::PRpcClientInfo clientInfo, std::
     {
     	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
     }
-    return BaseLib::Variable::createError(-32500, "Unknown application error. Check the address format.");
+    return BaseLib::Variable::createError(-32500, "Unknown application error.");
 }
 
 BaseLib::PVariable RPCSubscribePeers::invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters)
@@ -58,6 +58,7 @@ class RPCSystemGetCapabilities : public RPCMethod
 public:
 	RPCSystemGetCapabilities()
 	{
+		_readOnly = true;
 		setHelp("Lists server's RPC capabilities.");
 		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>());
 	}
@@ -69,6 +70,7 @@ class RPCSystemListMethods : public RPCMethod
 public:
 	RPCSystemListMethods(std::shared_ptr<RPCServer> server)
 	{
+		_readOnly = true;
 		_server = server;
 		setHelp("Lists all RPC methods.");
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>());
@@ -83,6 +85,7 @@ class RPCSystemMethodHelp : public RPCMethod
 public:
 	RPCSystemMethodHelp(std::shared_ptr<RPCServer> server)
 	{
+		_readOnly = true;
 		_server = server;
 		setHelp("Returns a description of a RPC method.");
 		addSignature(BaseLib::VariableType::tString, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString});
@@ -97,6 +100,7 @@ class RPCSystemMethodSignature : public RPCMethod
 public:
 	RPCSystemMethodSignature(std::shared_ptr<RPCServer> server)
 	{
+		_readOnly = true;
 		_server = server;
 		setHelp("Returns the method's signature.");
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString});
@@ -112,8 +116,9 @@ public:
 	RPCSystemMulticall(std::shared_ptr<RPCServer> server)
 	{
 		_server = server;
-		setHelp("Calls multiple RPC methods at once to reduce traffic.");
+		setHelp("Calls multiple RPC methods at once to reduce traffic. The optional second parameter sets the maximum number of read-only calls executed in parallel. \"1\" executes all calls sequentially.");
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tArray});
+		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tArray, BaseLib::VariableType::tInteger});
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
 private:
@@ -259,6 +264,7 @@ class RPCGetAllMetadata : public RPCMethod
 public:
 	RPCGetAllMetadata()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tVariant, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString});
 		addSignature(BaseLib::VariableType::tVariant, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger});
 	}
@@ -270,7 +276,9 @@ class RPCGetAllScripts : public RPCMethod
 public:
 	RPCGetAllScripts()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>());
+		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tBoolean});
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
 };
@@ -280,6 +288,7 @@ class RPCGetAllConfig : public RPCMethod
 public:
 	RPCGetAllConfig()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>());
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger});
 	}
@@ -291,10 +300,12 @@ class RPCGetAllValues : public RPCMethod
 public:
 	RPCGetAllValues()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>());
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tBoolean});
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger});
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger, BaseLib::VariableType::tBoolean});
+		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tBoolean, BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger});
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
 };
@@ -304,6 +315,7 @@ class RPCGetAllSystemVariables : public RPCMethod
 public:
 	RPCGetAllSystemVariables()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tVariant, std::vector<BaseLib::VariableType>());
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
@@ -314,6 +326,7 @@ class RPCGetConfigParameter : public RPCMethod
 public:
 	RPCGetConfigParameter()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tVariant, std::vector<BaseLib::VariableType>{ BaseLib::VariableType::tString, BaseLib::VariableType::tString });
 		addSignature(BaseLib::VariableType::tVariant, std::vector<BaseLib::VariableType>{ BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger, BaseLib::VariableType::tString });
 	}
@@ -325,6 +338,7 @@ class RPCGetDeviceDescription : public RPCMethod
 public:
 	RPCGetDeviceDescription()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString});
 		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger});
 	}
@@ -336,6 +350,7 @@ class RPCGetDeviceInfo : public RPCMethod
 public:
 	RPCGetDeviceInfo()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{});
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tArray});
 		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger});
@@ -349,6 +364,7 @@ class RPCGetEvent : public RPCMethod
 public:
 	RPCGetEvent()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tVoid, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString});
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
@@ -359,6 +375,7 @@ class RPCGetInstallMode : public RPCMethod
 public:
 	RPCGetInstallMode()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tInteger, std::vector<BaseLib::VariableType>());
 		addSignature(BaseLib::VariableType::tInteger, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger});
 	}
@@ -380,6 +397,7 @@ class RPCGetLinkInfo : public RPCMethod
 public:
 	RPCGetLinkInfo()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString, BaseLib::VariableType::tString});
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger});
 	}
@@ -391,6 +409,7 @@ class RPCGetLinkPeers : public RPCMethod
 public:
 	RPCGetLinkPeers()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString});
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger});
 	}
@@ -402,6 +421,7 @@ class RPCGetLinks : public RPCMethod
 public:
 	RPCGetLinks()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>());
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString});
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString, BaseLib::VariableType::tInteger});
@@ -416,17 +436,30 @@ class RPCGetMetadata : public RPCMethod
 public:
 	RPCGetMetadata()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tVariant, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString, BaseLib::VariableType::tString});
 		addSignature(BaseLib::VariableType::tVariant, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger, BaseLib::VariableType::tString});
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
 };
 
+class RPCGetMetrics : public RPCMethod
+{
+public:
+	RPCGetMetrics()
+	{
+		_readOnly = true;
+		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>());
+	}
+	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
+};
+
 class RPCGetName : public RPCMethod
 {
 public:
 	RPCGetName()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tString, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger});
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
@@ -437,6 +470,7 @@ class RPCGetPairingMethods : public RPCMethod
 public:
 	RPCGetPairingMethods()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tString, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger});
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
@@ -447,6 +481,7 @@ class RPCGetParamsetDescription : public RPCMethod
 public:
 	RPCGetParamsetDescription()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString, BaseLib::VariableType::tString});
 		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger, BaseLib::VariableType::tString});
 		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger});
@@ -460,6 +495,7 @@ class RPCGetParamsetId : public RPCMethod
 public:
 	RPCGetParamsetId()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tString, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString, BaseLib::VariableType::tString});
 		addSignature(BaseLib::VariableType::tString, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger, BaseLib::VariableType::tString});
 		addSignature(BaseLib::VariableType::tString, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger});
@@ -477,6 +513,11 @@ public:
 		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger});
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
+
+	/**
+	 * Some families read paramsets from the device, so calls for the same peer are serialized.
+	 */
+	bool isReadOnlyCall(std::shared_ptr<std::vector<BaseLib::PVariable>>& parameters, std::string& serializationKey);
 };
 
 class RPCGetPeerId : public RPCMethod
@@ -484,17 +525,30 @@ class RPCGetPeerId : public RPCMethod
 public:
 	RPCGetPeerId()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tInteger, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger});
 		addSignature(BaseLib::VariableType::tInteger, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger, BaseLib::VariableType::tString});
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
 };
 
+class RPCGetRpcStatistics : public RPCMethod
+{
+public:
+	RPCGetRpcStatistics()
+	{
+		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>());
+		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tBoolean});
+	}
+	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
+};
+
 class RPCGetServiceMessages : public RPCMethod
 {
 public:
 	RPCGetServiceMessages()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>());
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tBoolean});
 	}
@@ -506,16 +560,29 @@ class RPCGetSystemVariable : public RPCMethod
 public:
 	RPCGetSystemVariable()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tVariant, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString});
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
 };
 
+class RPCGetSystemVariables : public RPCMethod
+{
+public:
+	RPCGetSystemVariables()
+	{
+		_readOnly = true;
+		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tArray});
+	}
+	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
+};
+
 class RPCGetUpdateStatus : public RPCMethod
 {
 public:
 	RPCGetUpdateStatus()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tVoid, std::vector<BaseLib::VariableType>());
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
@@ -534,6 +601,44 @@ public:
 		addSignature(BaseLib::VariableType::tVariant, std::vector<BaseLib::VariableType>{ BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger, BaseLib::VariableType::tString, BaseLib::VariableType::tBoolean, BaseLib::VariableType::tBoolean });
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
+
+	/**
+	 * Calls with "requestFromDevice" set communicate with the device, so they are serialized per peer.
+	 */
+	bool isReadOnlyCall(std::shared_ptr<std::vector<BaseLib::PVariable>>& parameters, std::string& serializationKey);
+};
+
+class RPCGetValues : public RPCMethod
+{
+public:
+	RPCGetValues()
+	{
+		_readOnly = true;
+		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{ BaseLib::VariableType::tArray });
+	}
+	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
+};
+
+class RPCGetValuesChangedSince : public RPCMethod
+{
+public:
+	RPCGetValuesChangedSince()
+	{
+		_readOnly = true;
+		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>{ BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger });
+	}
+	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
+};
+
+class RPCGetValuesSnapshot : public RPCMethod
+{
+public:
+	RPCGetValuesSnapshot()
+	{
+		_readOnly = true;
+		addSignature(BaseLib::VariableType::tStruct, std::vector<BaseLib::VariableType>{ BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger });
+	}
+	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
 };
 
 class RPCGetVersion : public RPCMethod
@@ -541,6 +646,7 @@ class RPCGetVersion : public RPCMethod
 public:
 	RPCGetVersion()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tString, std::vector<BaseLib::VariableType>{});
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
@@ -569,6 +675,7 @@ class RPCListBidcosInterfaces : public RPCMethod
 public:
 	RPCListBidcosInterfaces()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>());
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
@@ -579,6 +686,7 @@ class RPCListClientServers : public RPCMethod
 public:
 	RPCListClientServers()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>());
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>({BaseLib::VariableType::tString}));
 	}
@@ -590,8 +698,10 @@ class RPCListDevices : public RPCMethod
 public:
 	RPCListDevices()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>());
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>({BaseLib::VariableType::tBoolean, BaseLib::VariableType::tArray}));
+		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>({BaseLib::VariableType::tBoolean, BaseLib::VariableType::tArray, BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger}));
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
 };
@@ -601,6 +711,7 @@ class RPCListEvents : public RPCMethod
 public:
 	RPCListEvents()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>({BaseLib::VariableType::tInteger}));
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>({BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger}));
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>({BaseLib::VariableType::tInteger, BaseLib::VariableType::tInteger, BaseLib::VariableType::tString}));
@@ -613,6 +724,7 @@ class RPCListFamilies : public RPCMethod
 public:
 	RPCListFamilies()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>());
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
@@ -623,6 +735,7 @@ class RPCListInterfaces : public RPCMethod
 public:
 	RPCListInterfaces()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>());
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tInteger});
 	}
@@ -634,6 +747,7 @@ class RPCListKnownDeviceTypes : public RPCMethod
 public:
 	RPCListKnownDeviceTypes()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>());
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>({BaseLib::VariableType::tBoolean, BaseLib::VariableType::tArray}));
 	}
@@ -645,6 +759,7 @@ class RPCListTeams : public RPCMethod
 public:
 	RPCListTeams()
 	{
+		_readOnly = true;
 		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>());
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
@@ -810,6 +925,18 @@ public:
 	RPCSetSystemVariable()
 	{
 		addSignature(BaseLib::VariableType::tVoid, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString, BaseLib::VariableType::tVariant});
+		addSignature(BaseLib::VariableType::tVoid, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tString, BaseLib::VariableType::tVariant, BaseLib::VariableType::tBoolean});
+	}
+	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
+};
+
+class RPCSetSystemVariables : public RPCMethod
+{
+public:
+	RPCSetSystemVariables()
+	{
+		addSignature(BaseLib::VariableType::tVoid, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tStruct});
+		addSignature(BaseLib::VariableType::tVoid, std::vector<BaseLib::VariableType>{BaseLib::VariableType::tStruct, BaseLib::VariableType::tBoolean});
 	}
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
 };
@@ -842,6 +969,16 @@ public:
 	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
 };
 
+class RPCSetValues : public RPCMethod
+{
+public:
+	RPCSetValues()
+	{
+		addSignature(BaseLib::VariableType::tArray, std::vector<BaseLib::VariableType>{ BaseLib::VariableType::tArray });
+	}
+	BaseLib::PVariable invoke(BaseLib::PRpcClientInfo clientInfo, std::shared_ptr<std::vector<BaseLib::PVariable>> parameters);
+};
+
 class RPCSubscribePeers : public RPCMethod
 {
 public:
@@ -46,6 +46,7 @@ RPCServer::Client::~Client()
 {
 	GD::bl->fileDescriptorManager.shutdown(socketDescriptor);
 	GD::bl->threadManager.join(readThread);
+	if(statistics) GD::rpcStatistics.releaseClientStatistics(address, statistics);
 }
 
 RPCServer::RPCServer()
@@ -61,7 +62,8 @@ RPCServer::RPCServer()
 
 	_info.reset(new BaseLib::Rpc::ServerInfo::Info());
 	_dummyClientInfo.reset(new BaseLib::RpcClientInfo());
-	_rpcMethods.reset(new std::map<std::string, std::shared_ptr<RPCMethod>>);
+	_localStatistics = GD::rpcStatistics.getClientStatistics("local");
+	_rpcMethods.reset(new RpcMethodTable());
 	_serverFileDescriptor.reset(new BaseLib::FileDescriptor);
 	_threadPriority = GD::bl->settings.rpcServerThreadPriority();
 	_threadPolicy = GD::bl->settings.rpcServerThreadPolicy();
@@ -80,16 +82,21 @@ RPCServer::~RPCServer()
 void RPCServer::dispose()
 {
 	stop();
+	_initMethod = nullptr;
 	_rpcMethods->clear();
 	_webServer.reset();
 }
 
-bool RPCServer::lifetick()
+bool RPCServer::lifetick(LifetickInfo& info)
 {
 	try
 	{
+		info.queueDepth = _pendingRequests;
+		int64_t stallTime = 0;
 		_lifetick1Mutex.lock();
-		if(!_lifetick1.second && BaseLib::HelperFunctions::getTime() - _lifetick1.first > 60000)
+		if(!_lifetick1.second) stallTime = BaseLib::HelperFunctions::getTime() - _lifetick1.first;
+		if(stallTime > info.stallTime) info.stallTime = stallTime;
+		if(stallTime > 60000)
 		{
 			GD::out.printCritical("Critical: RPC server's lifetick 1 was not updated for more than 60 seconds.");
 			_lifetick1Mutex.unlock();
@@ -97,8 +104,11 @@ bool RPCServer::lifetick()
 		}
 		_lifetick1Mutex.unlock();
 
+		stallTime = 0;
 		_lifetick2Mutex.lock();
-		if(!_lifetick2.second && BaseLib::HelperFunctions::getTime() - _lifetick2.first > 60000)
+		if(!_lifetick2.second) stallTime = BaseLib::HelperFunctions::getTime() - _lifetick2.first;
+		if(stallTime > info.stallTime) info.stallTime = stallTime;
+		if(stallTime > 60000)
 		{
 			GD::out.printCritical("Critical: RPC server's lifetick 2 was not updated for more than 60 seconds.");
 			_lifetick2Mutex.unlock();
@@ -311,12 +321,12 @@ void RPCServer::registerMethod(std::string methodName, std::shared_ptr<RPCMethod
 {
 	try
 	{
-		if(_rpcMethods->find(methodName) != _rpcMethods->end())
+		if(!_rpcMethods->add(methodName, method))
 		{
 			_out.printWarning("Warning: Could not register RPC method, because a method with this name already exists.");
 			return;
 		}
-		_rpcMethods->insert(std::pair<std::string, std::shared_ptr<RPCMethod>>(methodName, method));
+		if(methodName == "init") _initMethod = _rpcMethods->find(methodName);
 	}
 	catch(const std::exception& ex)
     {
@@ -405,6 +415,7 @@ void RPCServer::mainThread()
 					client->socket = std::shared_ptr<BaseLib::SocketOperations>(new BaseLib::SocketOperations(GD::bl.get(), client->socketDescriptor));
 					client->address = address;
 					client->port = port;
+					client->statistics = GD::rpcStatistics.getClientStatistics(address);
 
 					GD::bl->threadManager.start(client->readThread, false, _threadPriority, _threadPolicy, &RPCServer::readClient, this, client);
 				}
@@ -516,6 +527,99 @@ void RPCServer::sendRPCResponseToClient(std::shared_ptr<Client> client, std::vec
     }
 }
 
+void RPCServer::sendStreamedJsonResponseToClient(std::shared_ptr<Client> client, BaseLib::PVariable& variable, int32_t messageId, bool keepAlive)
+{
+	try
+	{
+		if(_stopped) return;
+		if(!clientValid(client)) return;
+		bool error = false;
+		try
+		{
+			//Keep-alive connections get a chunked body. Otherwise the end of the response is marked by closing the connection. HTTP/1.0 clients never get here.
+			std::string header("HTTP/1.1 200 OK\r\nConnection: ");
+			header.append(keepAlive ? "Keep-Alive\r\nContent-Type: application/json\r\nTransfer-Encoding: chunked\r\n\r\n" : "close\r\nContent-Type: application/json\r\n\r\n");
+			std::vector<char> data(header.begin(), header.end());
+			std::string prefix("{\"jsonrpc\":\"2.0\",\"result\":[");
+			std::vector<char> chunk(prefix.begin(), prefix.end());
+			chunk.reserve(_jsonStreamingChunkSize + 4096);
+			std::vector<char> element;
+
+			std::function<void(bool)> writeChunk = [&](bool last)
+			{
+				if(keepAlive)
+				{
+					std::string chunkHeader = BaseLib::HelperFunctions::getHexString((int32_t)chunk.size()) + "\r\n";
+					data.insert(data.end(), chunkHeader.begin(), chunkHeader.end());
+					data.insert(data.end(), chunk.begin(), chunk.end());
+					data.push_back('\r');
+					data.push_back('\n');
+					if(last)
+					{
+						std::string terminator("0\r\n\r\n");
+						data.insert(data.end(), terminator.begin(), terminator.end());
+					}
+				}
+				else data.insert(data.end(), chunk.begin(), chunk.end());
+				client->socket->proofwrite(data);
+				data.clear();
+				chunk.clear();
+			};
+
+			//Sleep a tiny little bit. Some clients like the linux version of IP-Symcon don't accept responses too fast.
+			std::this_thread::sleep_for(std::chrono::milliseconds(22));
+			for(BaseLib::Array::iterator i = variable->arrayValue->begin(); i != variable->arrayValue->end(); ++i)
+			{
+				if(i != variable->arrayValue->begin()) chunk.push_back(',');
+				if(!*i)
+				{
+					chunk.insert(chunk.end(), {'n', 'u', 'l', 'l'});
+				}
+				else
+				{
+					element.clear();
+					_jsonEncoder->encode(*i, element);
+					if(element.empty()) chunk.insert(chunk.end(), {'n', 'u', 'l', 'l'});
+					else if((*i)->type == BaseLib::VariableType::tArray || (*i)->type == BaseLib::VariableType::tStruct) chunk.insert(chunk.end(), element.begin(), element.end());
+					else if(element.size() >= 2 && element.front() == '[' && element.back() == ']') chunk.insert(chunk.end(), element.begin() + 1, element.end() - 1); //encode() wraps single values in an array
+					else chunk.insert(chunk.end(), element.begin(), element.end());
+				}
+				if(chunk.size() >= _jsonStreamingChunkSize)
+				{
+					if(_stopped) return;
+					writeChunk(false);
+				}
+			}
+			std::string suffix("],\"id\":" + std::to_string(messageId) + "}\r\n");
+			chunk.insert(chunk.end(), suffix.begin(), suffix.end());
+			writeChunk(true);
+		}
+		catch(BaseLib::SocketDataLimitException& ex)
+		{
+			_out.printWarning("Warning: " + ex.what());
+			error = true;
+		}
+		catch(const BaseLib::SocketOperationException& ex)
+		{
+			_out.printError("Error: " + ex.what());
+			error = true;
+		}
+		if(!keepAlive || error) closeClientConnection(client);
+	}
+    catch(const std::exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
 void RPCServer::analyzeRPC(std::shared_ptr<Client> client, std::vector<char>& packet, PacketType::Enum packetType, bool keepAlive)
 {
 	try
@@ -613,6 +717,11 @@ void RPCServer::sendRPCResponseToClient(std::shared_ptr<Client> client, BaseLib:
 		}
 		else if(responseType == PacketType::Enum::jsonResponse)
 		{
+			if(client->http11 && variable && variable->type == BaseLib::VariableType::tArray && !variable->errorStruct && variable->arrayValue->size() > _jsonStreamingThreshold)
+			{
+				sendStreamedJsonResponseToClient(client, variable, messageId, keepAlive);
+				return;
+			}
 			_jsonEncoder->encodeResponse(variable, messageId, data);
 			data.push_back('\r');
 			data.push_back('\n');
@@ -656,7 +765,8 @@ BaseLib::PVariable RPCServer::callMethod(std::string& methodName, BaseLib::PVari
 	{
 		if(!parameters) parameters = BaseLib::PVariable(new BaseLib::Variable(BaseLib::VariableType::tArray));
 		if(_stopped) return BaseLib::Variable::createError(100000, "Server is stopped.");
-		if(_rpcMethods->find(methodName) == _rpcMethods->end())
+		const RpcMethodTable::Entry* method = _rpcMethods->find(methodName);
+		if(!method)
 		{
 			_out.printError("Warning: RPC method not found: " + methodName);
 			return BaseLib::Variable::createError(-32601, ": Requested method not found.");
@@ -673,7 +783,11 @@ BaseLib::PVariable RPCServer::callMethod(std::string& methodName, BaseLib::PVari
 				(*i)->print(true, false);
 			}
 		}
-		BaseLib::PVariable ret = _rpcMethods->at(methodName)->invoke(_dummyClientInfo, parameters->arrayValue);
+		int64_t startTime = Metrics::getTime();
+		BaseLib::PVariable ret = method->method->invoke(_dummyClientInfo, parameters->arrayValue);
+		int64_t duration = Metrics::getTime() - startTime;
+		method->statistics->record(duration, ret->errorStruct);
+		_localStatistics->record(duration, ret->errorStruct);
 		if(GD::bl->debugLevel >= 5)
 		{
 			_out.printDebug("Response: ");
@@ -705,18 +819,26 @@ void RPCServer::callMethod(std::shared_ptr<Client> client, std::string methodNam
 	{
 		if(_stopped) return;
 
-		if(methodName == "setClientType" && parameters->size() > 0)
+		const RpcMethodTable::Entry* method = _rpcMethods->find(methodName);
+		if(!method)
 		{
-			if(parameters->at(0)->integerValue == 1)
+			if(methodName == "setClientType" && parameters->size() > 0)
 			{
-				_out.printInfo("Info: Type of client " + std::to_string(client->id) + " set to addon.");
-				client->addon = true;
-				BaseLib::PVariable ret(new BaseLib::Variable());
-				sendRPCResponseToClient(client, ret, messageId, responseType, keepAlive);
+				if(parameters->at(0)->integerValue == 1)
+				{
+					_out.printInfo("Info: Type of client " + std::to_string(client->id) + " set to addon.");
+					client->addon = true;
+					BaseLib::PVariable ret(new BaseLib::Variable());
+					sendRPCResponseToClient(client, ret, messageId, responseType, keepAlive);
+				}
+				return;
 			}
+
+			_out.printError("Warning: RPC method not found: " + methodName);
+			sendRPCResponseToClient(client, BaseLib::Variable::createError(-32601, ": Requested method not found."), messageId, responseType, keepAlive);
 			return;
 		}
-		else if(methodName == "init" && parameters->size() >= 2)
+		else if(method == _initMethod && parameters->size() >= 2)
 		{
 			client->initUrl = parameters->at(0)->stringValue;
 			client->initInterfaceId = parameters->at(1)->stringValue;
@@ -731,12 +853,6 @@ void RPCServer::callMethod(std::shared_ptr<Client> client, std::string methodNam
 			}
 		}
 
-		if(_rpcMethods->find(methodName) == _rpcMethods->end())
-		{
-			_out.printError("Warning: RPC method not found: " + methodName);
-			sendRPCResponseToClient(client, BaseLib::Variable::createError(-32601, ": Requested method not found."), messageId, responseType, keepAlive);
-			return;
-		}
 		_lifetick2Mutex.lock();
 		_lifetick2.second = false;
 		_lifetick2.first = BaseLib::HelperFunctions::getTime();
@@ -749,7 +865,11 @@ void RPCServer::callMethod(std::shared_ptr<Client> client, std::string methodNam
 				(*i)->print(true, false);
 			}
 		}
-		BaseLib::PVariable ret = _rpcMethods->at(methodName)->invoke(client, parameters);
+		int64_t startTime = Metrics::getTime();
+		BaseLib::PVariable ret = method->method->invoke(client, parameters);
+		int64_t duration = Metrics::getTime() - startTime;
+		method->statistics->record(duration, ret->errorStruct);
+		if(client->statistics) client->statistics->record(duration, ret->errorStruct);
 		if(GD::bl->debugLevel >= 5)
 		{
 			_out.printDebug("Response: ");
@@ -816,9 +936,11 @@ void RPCServer::analyzeRPCResponse(std::shared_ptr<Client> client, std::vector<c
 
 void RPCServer::packetReceived(std::shared_ptr<Client> client, std::vector<char>& packet, PacketType::Enum packetType, bool keepAlive)
 {
+	bool isRequest = packetType == PacketType::Enum::binaryRequest || packetType == PacketType::Enum::xmlRequest || packetType == PacketType::Enum::jsonRequest || packetType == PacketType::Enum::webSocketRequest;
+	if(isRequest) _pendingRequests++;
 	try
 	{
-		if(packetType == PacketType::Enum::binaryRequest || packetType == PacketType::Enum::xmlRequest || packetType == PacketType::Enum::jsonRequest || packetType == PacketType::Enum::webSocketRequest) analyzeRPC(client, packet, packetType, keepAlive);
+		if(isRequest) analyzeRPC(client, packet, packetType, keepAlive);
 		else if(packetType == PacketType::Enum::binaryResponse || packetType == PacketType::Enum::xmlResponse) analyzeRPCResponse(client, packet, packetType, keepAlive);
 	}
     catch(const std::exception& ex)
@@ -833,6 +955,7 @@ void RPCServer::packetReceived(std::shared_ptr<Client> client, std::vector<char>
     {
     	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
     }
+    if(isRequest) _pendingRequests--;
 }
 
 int32_t RPCServer::isAddonClient(int32_t clientID)
@@ -1402,6 +1525,7 @@ void RPCServer::readClient(std::shared_ptr<Client> client)
 				else if(http.getContentSize() > 0 && (_info->xmlrpcServer || _info->jsonrpcServer))
 				{
 					if(http.getHeader().contentType == "application/json" || http.getContent().at(0) == '{') packetType = PacketType::jsonRequest;
+					client->http11 = http.getHeader().protocol == BaseLib::Http::Protocol::Enum::http11;
 					packetReceived(client, http.getContent(), packetType, http.getHeader().connection & BaseLib::Http::Connection::Enum::keepAlive);
 				}
 				http.reset();
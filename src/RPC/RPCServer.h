@@ -35,12 +35,15 @@
 #include "RPCMethod.h"
 #include "Auth.h"
 #include "../WebServer/WebServer.h"
+#include "RpcMethodTable.h"
+#include "../Monitor.h"
 
 #include <thread>
 #include <string>
 #include <vector>
 #include <list>
 #include <mutex>
+#include <atomic>
 #include <memory>
 
 #include <gnutls/gnutls.h>
@@ -58,6 +61,12 @@ namespace RPC
 				std::shared_ptr<BaseLib::FileDescriptor> socketDescriptor;
 				std::shared_ptr<BaseLib::SocketOperations> socket;
 				Auth auth;
+				RpcStatistics::PCallStatistics statistics;
+
+				/**
+				 * True when the last HTTP request of this client was an HTTP/1.1 request. Only HTTP/1.1 clients get streamed responses.
+				 */
+				bool http11 = false;
 
 				Client();
 				virtual ~Client();
@@ -74,12 +83,12 @@ namespace RPC
 			void dispose();
 			const std::vector<BaseLib::PRpcClientInfo> getClientInfo();
 			const BaseLib::Rpc::PServerInfo getInfo() { return _info; }
-			bool lifetick();
+			bool lifetick(LifetickInfo& info);
 			bool isRunning() { return !_stopped; }
 			void start(BaseLib::Rpc::PServerInfo& settings);
 			void stop();
 			void registerMethod(std::string methodName, std::shared_ptr<RPCMethod> method);
-			std::shared_ptr<std::map<std::string, std::shared_ptr<RPCMethod>>> getMethods() { return _rpcMethods; }
+			std::shared_ptr<RpcMethodTable> getMethods() { return _rpcMethods; }
 			uint32_t connectionCount();
 			BaseLib::PVariable callMethod(std::string& methodName, BaseLib::PVariable& parameters);
 
@@ -119,7 +128,13 @@ namespace RPC
 			std::shared_ptr<BaseLib::FileDescriptor> _serverFileDescriptor;
 			std::mutex _stateMutex;
 			std::map<int32_t, std::shared_ptr<Client>> _clients;
-			std::shared_ptr<std::map<std::string, std::shared_ptr<RPCMethod>>> _rpcMethods;
+			std::shared_ptr<RpcMethodTable> _rpcMethods;
+
+			/**
+			 * Entry of "init" in _rpcMethods. "init" also stores the callback information in the client object.
+			 */
+			const RpcMethodTable::Entry* _initMethod = nullptr;
+			RpcStatistics::PCallStatistics _localStatistics;
 			std::unique_ptr<BaseLib::RPC::RPCDecoder> _rpcDecoder;
 			std::unique_ptr<BaseLib::RPC::RPCEncoder> _rpcEncoder;
 			std::unique_ptr<BaseLib::RPC::XMLRPCDecoder> _xmlRpcDecoder;
@@ -131,8 +146,23 @@ namespace RPC
 			std::pair<int64_t, bool> _lifetick1;
 			std::mutex _lifetick2Mutex;
 			std::pair<int64_t, bool> _lifetick2;
+
+			/**
+			 * The number of requests received by this server that are still being processed. Reported as the queue depth by lifetick().
+			 */
+			std::atomic<int64_t> _pendingRequests{0};
 			std::shared_ptr<BaseLib::RpcClientInfo> _dummyClientInfo;
 
+			/**
+			 * JSON-RPC responses containing arrays with more elements than this are encoded and sent element by element.
+			 */
+			static const uint32_t _jsonStreamingThreshold = 100;
+
+			/**
+			 * The number of bytes collected before a part of a streamed response is written to the socket.
+			 */
+			static const uint32_t _jsonStreamingChunkSize = 65536;
+
 			void collectGarbage();
 			void getSocketDescriptor();
 			std::shared_ptr<BaseLib::FileDescriptor> getClientSocketDescriptor(std::string& address, int32_t& port);
@@ -141,6 +171,7 @@ namespace RPC
 			void readClient(std::shared_ptr<Client> client);
 			void sendRPCResponseToClient(std::shared_ptr<Client> client, BaseLib::PVariable variable, int32_t messageId, PacketType::Enum packetType, bool keepAlive);
 			void sendRPCResponseToClient(std::shared_ptr<Client> client, std::vector<char>& data, bool keepAlive);
+			void sendStreamedJsonResponseToClient(std::shared_ptr<Client> client, BaseLib::PVariable& variable, int32_t messageId, bool keepAlive);
 			void packetReceived(std::shared_ptr<Client> client, std::vector<char>& packet, PacketType::Enum packetType, bool keepAlive);
 			void handleConnectionUpgrade(std::shared_ptr<Client> client, BaseLib::Http& http);
 			void analyzeRPC(std::shared_ptr<Client> client, std::vector<char>& packet, PacketType::Enum packetType, bool keepAlive);
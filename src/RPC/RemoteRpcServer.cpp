@@ -47,6 +47,7 @@ RemoteRpcServer::RemoteRpcServer(std::shared_ptr<RpcClient> client)
 	_methodProcessingMessageAvailable = false;
 	_methodBufferHead = 0;
 	_methodBufferTail = 0;
+	_queueDepth = GD::metrics.queueDepth("rpcClient");
 	if(!GD::bl->threadManager.start(_methodProcessingThread, false, GD::bl->settings.rpcClientThreadPriority(), GD::bl->settings.rpcClientThreadPolicy(), &RemoteRpcServer::processMethods, this))
 	{
 		removed = true;
@@ -62,6 +63,7 @@ RemoteRpcServer::~RemoteRpcServer()
 	_methodProcessingConditionVariable.notify_one();
 	GD::bl->threadManager.join(_methodProcessingThread);
 	_client.reset();
+	_queueDepth->clear();
 }
 
 void RemoteRpcServer::queueMethod(std::shared_ptr<std::pair<std::string, std::shared_ptr<std::list<BaseLib::PVariable>>>> method)
@@ -69,11 +71,13 @@ void RemoteRpcServer::queueMethod(std::shared_ptr<std::pair<std::string, std::sh
 	try
 	{
 		if(removed) return;
+		_queueDepth->increment();
 		_methodBufferMutex.lock();
 		int32_t tempHead = _methodBufferHead + 1;
 		if(tempHead >= _methodBufferSize) tempHead = 0;
 		if(tempHead == _methodBufferTail)
 		{
+			_queueDepth->decrement();
 			GD::out.printError("Error: More than " + std::to_string(_methodBufferSize) + " methods are queued to be sent to server " + address.first + ". Your packet processing is too slow. Dropping method.");
 			_methodBufferMutex.unlock();
 			return;
@@ -136,6 +140,7 @@ void RemoteRpcServer::processMethods()
 				if(_methodBufferTail >= _methodBufferSize) _methodBufferTail = 0;
 				if(_methodBufferHead == _methodBufferTail) _methodProcessingMessageAvailable = false; //Set here, because otherwise it might be set to "true" in publish and then set to false again after the while loop
 				_methodBufferMutex.unlock();
+				_queueDepth->decrement();
 				if(!removed) _client->invokeBroadcast(this, message->first, message->second);
 			}
 		}
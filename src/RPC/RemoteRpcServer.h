@@ -34,6 +34,7 @@
 #include "homegear-base/BaseLib.h"
 #include "Auth.h"
 #include "ClientSettings.h"
+#include "../Metrics/Metrics.h"
 
 #include <string>
 #include <memory>
@@ -96,6 +97,11 @@ private:
 	int32_t _methodBufferHead = 0;
 	int32_t _methodBufferTail = 0;
 	std::shared_ptr<std::pair<std::string, std::shared_ptr<std::list<BaseLib::PVariable>>>> _methodBuffer[_methodBufferSize];
+
+	/**
+	 * Shared by all event servers.
+	 */
+	Metrics::PQueueDepth _queueDepth;
 	std::mutex _methodProcessingThreadMutex;
 	std::thread _methodProcessingThread;
 	bool _methodProcessingMessageAvailable = false;
@@ -0,0 +1,86 @@
+/* Copyright 2013-2016 Sathya Laufer
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Homegear.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ * 
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "RpcMethodTable.h"
+#include "../GD/GD.h"
+
+#include <algorithm>
+
+namespace RPC
+{
+
+RpcMethodTable::RpcMethodTable()
+{
+	_methods.reserve(256);
+}
+
+RpcMethodTable::~RpcMethodTable()
+{
+}
+
+bool RpcMethodTable::add(const std::string& name, std::shared_ptr<RPCMethod> method)
+{
+	try
+	{
+		if(!method || _methods.find(name) != _methods.end()) return false;
+		Entry& entry = _methods[name];
+		entry.name = name;
+		entry.method = method;
+		entry.statistics = GD::rpcStatistics.getMethodStatistics(name);
+		return true;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return false;
+}
+
+std::vector<std::string> RpcMethodTable::getNames() const
+{
+	std::vector<std::string> names;
+	names.reserve(_methods.size());
+	for(std::unordered_map<std::string, Entry>::const_iterator i = _methods.begin(); i != _methods.end(); ++i)
+	{
+		names.push_back(i->first);
+	}
+	std::sort(names.begin(), names.end());
+	return names;
+}
+
+}
@@ -0,0 +1,92 @@
+/* Copyright 2013-2016 Sathya Laufer
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Homegear.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ * 
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#ifndef RPCMETHODTABLE_H_
+#define RPCMETHODTABLE_H_
+
+#include "RPCMethod.h"
+#include "RpcStatistics.h"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+namespace RPC
+{
+
+/**
+ * Maps method names to RPC methods. Used by RPCServer and ScriptEngineServer.
+ *
+ * A call only needs one hash lookup, which returns the method together with its statistics. Methods are added before the server starts, so lookups don't need a lock.
+ */
+class RpcMethodTable
+{
+public:
+	struct Entry
+	{
+		std::string name;
+		std::shared_ptr<RPCMethod> method;
+		RpcStatistics::PCallStatistics statistics;
+	};
+
+	RpcMethodTable();
+	virtual ~RpcMethodTable();
+
+	/**
+	 * Adds a method.
+	 *
+	 * @return Returns false when a method with the same name already exists.
+	 */
+	bool add(const std::string& name, std::shared_ptr<RPCMethod> method);
+
+	/**
+	 * Returns the entry of a method or nullptr, when the method is unknown. The pointer stays valid until clear() is called.
+	 */
+	const Entry* find(const std::string& name) const
+	{
+		std::unordered_map<std::string, Entry>::const_iterator methodIterator = _methods.find(name);
+		return methodIterator == _methods.end() ? nullptr : &methodIterator->second;
+	}
+
+	/**
+	 * Returns the names of all methods sorted alphabetically.
+	 */
+	std::vector<std::string> getNames() const;
+
+	size_t size() const { return _methods.size(); }
+	void clear() { _methods.clear(); }
+private:
+	std::unordered_map<std::string, Entry> _methods;
+};
+
+}
+
+#endif
@@ -0,0 +1,196 @@
+/* Copyright 2013-2016 Sathya Laufer
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Homegear.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ * 
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "RpcStatistics.h"
+#include "../GD/GD.h"
+
+namespace RPC
+{
+
+RpcStatistics::RpcStatistics()
+{
+}
+
+RpcStatistics::~RpcStatistics()
+{
+}
+
+RpcStatistics::PCallStatistics RpcStatistics::getMethodStatistics(const std::string& methodName)
+{
+	try
+	{
+		std::lock_guard<std::mutex> statisticsGuard(_statisticsMutex);
+		PCallStatistics& statistics = _methods[methodName];
+		if(!statistics) statistics.reset(new CallStatistics(GD::metrics.histogram("homegear_rpc_method_duration_seconds", "Execution time of RPC methods.", "method", methodName), GD::metrics.counter("homegear_rpc_method_errors_total", "Number of RPC method calls returning an error.", "method", methodName)));
+		return statistics;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return PCallStatistics(new CallStatistics(Metrics::PHistogram(new Metrics::Histogram()), Metrics::PCounter(new Metrics::Counter())));
+}
+
+RpcStatistics::PCallStatistics RpcStatistics::getClientStatistics(const std::string& address)
+{
+	try
+	{
+		std::lock_guard<std::mutex> statisticsGuard(_statisticsMutex);
+		PCallStatistics& statistics = _clients[address];
+		if(!statistics) statistics.reset(new CallStatistics());
+		else if(statistics.use_count() == 1) _inactiveClients.remove(address);
+		return statistics;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return PCallStatistics(new CallStatistics());
+}
+
+void RpcStatistics::releaseClientStatistics(const std::string& address, PCallStatistics& statistics)
+{
+	try
+	{
+		std::lock_guard<std::mutex> statisticsGuard(_statisticsMutex);
+		statistics.reset();
+		std::map<std::string, PCallStatistics>::iterator clientIterator = _clients.find(address);
+		if(clientIterator == _clients.end() || clientIterator->second.use_count() > 1) return;
+		_inactiveClients.push_back(address);
+		while(_inactiveClients.size() > _maxInactiveClients)
+		{
+			_clients.erase(_inactiveClients.front());
+			_inactiveClients.pop_front();
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+BaseLib::PVariable RpcStatistics::getStatistics(std::map<std::string, PCallStatistics>& statistics)
+{
+	BaseLib::PVariable result(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+	for(std::map<std::string, PCallStatistics>::iterator i = statistics.begin(); i != statistics.end(); ++i)
+	{
+		uint64_t calls = i->second->duration.count();
+		if(calls == 0) continue;
+		BaseLib::PVariable entry(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+		entry->structValue->insert(BaseLib::StructElement("CALLS", BaseLib::PVariable(new BaseLib::Variable((int64_t)calls))));
+		entry->structValue->insert(BaseLib::StructElement("ERRORS", BaseLib::PVariable(new BaseLib::Variable((int64_t)i->second->errors.value()))));
+		entry->structValue->insert(BaseLib::StructElement("P50", BaseLib::PVariable(new BaseLib::Variable(i->second->duration.quantile(0.5)))));
+		entry->structValue->insert(BaseLib::StructElement("P99", BaseLib::PVariable(new BaseLib::Variable(i->second->duration.quantile(0.99)))));
+		entry->structValue->insert(BaseLib::StructElement("MAX", BaseLib::PVariable(new BaseLib::Variable(i->second->duration.max()))));
+		result->structValue->insert(BaseLib::StructElement(i->first, entry));
+	}
+	return result;
+}
+
+BaseLib::PVariable RpcStatistics::getStatistics()
+{
+	try
+	{
+		BaseLib::PVariable statistics(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+		std::lock_guard<std::mutex> statisticsGuard(_statisticsMutex);
+		statistics->structValue->insert(BaseLib::StructElement("METHODS", getStatistics(_methods)));
+		statistics->structValue->insert(BaseLib::StructElement("CLIENTS", getStatistics(_clients)));
+		return statistics;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
+
+void RpcStatistics::reset()
+{
+	try
+	{
+		std::lock_guard<std::mutex> statisticsGuard(_statisticsMutex);
+		for(std::map<std::string, PCallStatistics>::iterator i = _methods.begin(); i != _methods.end(); ++i)
+		{
+			i->second->duration.reset();
+			i->second->errors.reset();
+		}
+		for(std::map<std::string, PCallStatistics>::iterator i = _clients.begin(); i != _clients.end(); ++i)
+		{
+			i->second->duration.reset();
+			i->second->errors.reset();
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+}
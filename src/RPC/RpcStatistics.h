@@ -0,0 +1,129 @@
+/* Copyright 2013-2016 Sathya Laufer
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Homegear.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ * 
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#ifndef RPCSTATISTICS_H_
+#define RPCSTATISTICS_H_
+
+#include "homegear-base/BaseLib.h"
+#include "../Metrics/Metrics.h"
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <list>
+
+namespace RPC
+{
+
+/**
+ * Call counts, errors and latencies of RPC methods per method and per client address.
+ *
+ * The method statistics are also exported through GD::metrics. The client statistics are not, because the number of client addresses is not bounded. Statistics of
+ * disconnected clients are kept for the last _maxInactiveClients addresses only.
+ */
+class RpcStatistics
+{
+public:
+	class CallStatistics
+	{
+	public:
+		/**
+		 * Calls since the last reset. These are returned by getStatistics().
+		 */
+		Metrics::Histogram duration;
+		Metrics::Counter errors;
+
+		CallStatistics() {}
+		CallStatistics(Metrics::PHistogram exportedDuration, Metrics::PCounter exportedErrors) : _exportedDuration(exportedDuration), _exportedErrors(exportedErrors) {}
+
+		void record(int64_t microseconds, bool error)
+		{
+			duration.record(microseconds);
+			if(error) errors.increment();
+			if(_exportedDuration) _exportedDuration->record(microseconds);
+			if(error && _exportedErrors) _exportedErrors->increment();
+		}
+	private:
+		/**
+		 * Exported through GD::metrics. These are never reset, because Prometheus counters must not decrease.
+		 */
+		Metrics::PHistogram _exportedDuration;
+		Metrics::PCounter _exportedErrors;
+	};
+	typedef std::shared_ptr<CallStatistics> PCallStatistics;
+
+	RpcStatistics();
+	virtual ~RpcStatistics();
+
+	/**
+	 * Returns the statistics object of a method. It is created when it doesn't exist yet. Call this once per method and store the returned pointer.
+	 */
+	PCallStatistics getMethodStatistics(const std::string& methodName);
+
+	/**
+	 * Returns the statistics object of a client address. It is created when it doesn't exist yet. Call this once per connection and store the returned pointer.
+	 */
+	PCallStatistics getClientStatistics(const std::string& address);
+
+	/**
+	 * Needs to be called when a connection closes. Resets "statistics". When no other connection of the address is open, the address' statistics become inactive.
+	 */
+	void releaseClientStatistics(const std::string& address, PCallStatistics& statistics);
+
+	/**
+	 * Returns a struct with the keys "METHODS" and "CLIENTS". Each entry contains "CALLS", "ERRORS", "P50", "P99" and "MAX". Times are in microseconds. Entries without calls are skipped.
+	 */
+	BaseLib::PVariable getStatistics();
+
+	/**
+	 * Sets all counters returned by getStatistics() to zero. The metrics exported through GD::metrics are not changed.
+	 */
+	void reset();
+private:
+	static const size_t _maxInactiveClients = 100;
+
+	std::mutex _statisticsMutex;
+	std::map<std::string, PCallStatistics> _methods;
+	std::map<std::string, PCallStatistics> _clients;
+
+	/**
+	 * Addresses in _clients without open connections, oldest first.
+	 */
+	std::list<std::string> _inactiveClients;
+
+	RpcStatistics(const RpcStatistics&);
+	RpcStatistics& operator=(const RpcStatistics&);
+	BaseLib::PVariable getStatistics(std::map<std::string, PCallStatistics>& statistics);
+};
+
+}
+
+#endif
@@ -87,16 +87,22 @@ void Server::registerMethods()
 		_server->registerMethod("getLinkPeers", std::shared_ptr<RPCMethod>(new RPCGetLinkPeers()));
 		_server->registerMethod("getLinks", std::shared_ptr<RPCMethod>(new RPCGetLinks()));
 		_server->registerMethod("getMetadata", std::shared_ptr<RPCMethod>(new RPCGetMetadata()));
+		_server->registerMethod("getMetrics", std::shared_ptr<RPCMethod>(new RPCGetMetrics()));
 		_server->registerMethod("getName", std::shared_ptr<RPCMethod>(new RPCGetName()));
 		_server->registerMethod("getPairingMethods", std::shared_ptr<RPCMethod>(new RPCGetPairingMethods()));
 		_server->registerMethod("getParamset", std::shared_ptr<RPCMethod>(new RPCGetParamset()));
 		_server->registerMethod("getParamsetDescription", std::shared_ptr<RPCMethod>(new RPCGetParamsetDescription()));
 		_server->registerMethod("getParamsetId", std::shared_ptr<RPCMethod>(new RPCGetParamsetId()));
 		_server->registerMethod("getPeerId", std::shared_ptr<RPCMethod>(new RPCGetPeerId()));
+		_server->registerMethod("getRpcStatistics", std::shared_ptr<RPCMethod>(new RPCGetRpcStatistics()));
 		_server->registerMethod("getServiceMessages", std::shared_ptr<RPCMethod>(new RPCGetServiceMessages()));
 		_server->registerMethod("getSystemVariable", std::shared_ptr<RPCMethod>(new RPCGetSystemVariable()));
+		_server->registerMethod("getSystemVariables", std::shared_ptr<RPCMethod>(new RPCGetSystemVariables()));
 		_server->registerMethod("getUpdateStatus", std::shared_ptr<RPCMethod>(new RPCGetUpdateStatus()));
 		_server->registerMethod("getValue", std::shared_ptr<RPCMethod>(new RPCGetValue()));
+		_server->registerMethod("getValues", std::shared_ptr<RPCMethod>(new RPCGetValues()));
+		_server->registerMethod("getValuesChangedSince", std::shared_ptr<RPCMethod>(new RPCGetValuesChangedSince()));
+		_server->registerMethod("getValuesSnapshot", std::shared_ptr<RPCMethod>(new RPCGetValuesSnapshot()));
 		_server->registerMethod("getVersion", std::shared_ptr<RPCMethod>(new RPCGetVersion()));
 		_server->registerMethod("init", std::shared_ptr<RPCMethod>(new RPCInit()));
 		_server->registerMethod("listBidcosInterfaces", std::shared_ptr<RPCMethod>(new RPCListBidcosInterfaces()));
@@ -122,8 +128,10 @@ void Server::registerMethods()
 		_server->registerMethod("setMetadata", std::shared_ptr<RPCMethod>(new RPCSetMetadata()));
 		_server->registerMethod("setName", std::shared_ptr<RPCMethod>(new RPCSetName()));
 		_server->registerMethod("setSystemVariable", std::shared_ptr<RPCMethod>(new RPCSetSystemVariable()));
+		_server->registerMethod("setSystemVariables", std::shared_ptr<RPCMethod>(new RPCSetSystemVariables()));
 		_server->registerMethod("setTeam", std::shared_ptr<RPCMethod>(new RPCSetTeam()));
 		_server->registerMethod("setValue", std::shared_ptr<RPCMethod>(new RPCSetValue()));
+		_server->registerMethod("setValues", std::shared_ptr<RPCMethod>(new RPCSetValues()));
 		_server->registerMethod("subscribePeers", std::shared_ptr<RPCMethod>(new RPCSubscribePeers()));
 		_server->registerMethod("triggerEvent", std::shared_ptr<RPCMethod>(new RPCTriggerEvent()));
 		_server->registerMethod("triggerRpcEvent", std::shared_ptr<RPCMethod>(new RPCTriggerRpcEvent()));
@@ -167,9 +175,9 @@ void Server::stop()
 	if(_server) _server->stop();
 }
 
-bool Server::lifetick()
+bool Server::lifetick(LifetickInfo& info)
 {
-	if(!_server) return true; return _server->lifetick();
+	if(!_server) return true; return _server->lifetick(info);
 }
 
 bool Server::isRunning()
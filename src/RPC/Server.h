@@ -48,7 +48,7 @@ public:
 	void registerMethods();
 	void start(BaseLib::Rpc::PServerInfo& serverInfo);
 	void stop();
-	bool lifetick();
+	bool lifetick(LifetickInfo& info);
 	bool isRunning();
 	const std::vector<std::shared_ptr<BaseLib::RpcClientInfo>> getClientInfo();
 	const std::shared_ptr<RPCServer> getServer();
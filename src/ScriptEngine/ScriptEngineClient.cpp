@@ -59,6 +59,7 @@ ScriptEngineClient::ScriptEngineClient() : IQueue(GD::bl.get(), 1000)
 	_localRpcMethods.insert(std::pair<std::string, std::function<BaseLib::PVariable(BaseLib::PArray& parameters)>>("shutdown", std::bind(&ScriptEngineClient::shutdown, this, std::placeholders::_1)));
 	_localRpcMethods.insert(std::pair<std::string, std::function<BaseLib::PVariable(BaseLib::PArray& parameters)>>("executeScript", std::bind(&ScriptEngineClient::executeScript, this, std::placeholders::_1)));
 	_localRpcMethods.insert(std::pair<std::string, std::function<BaseLib::PVariable(BaseLib::PArray& parameters)>>("scriptCount", std::bind(&ScriptEngineClient::scriptCount, this, std::placeholders::_1)));
+	_localRpcMethods.insert(std::pair<std::string, std::function<BaseLib::PVariable(BaseLib::PArray& parameters)>>("getScriptCacheStatistics", std::bind(&ScriptEngineClient::getScriptCacheStatistics, this, std::placeholders::_1)));
 	_localRpcMethods.insert(std::pair<std::string, std::function<BaseLib::PVariable(BaseLib::PArray& parameters)>>("broadcastEvent", std::bind(&ScriptEngineClient::broadcastEvent, this, std::placeholders::_1)));
 	_localRpcMethods.insert(std::pair<std::string, std::function<BaseLib::PVariable(BaseLib::PArray& parameters)>>("broadcastNewDevices", std::bind(&ScriptEngineClient::broadcastNewDevices, this, std::placeholders::_1)));
 	_localRpcMethods.insert(std::pair<std::string, std::function<BaseLib::PVariable(BaseLib::PArray& parameters)>>("broadcastDeleteDevices", std::bind(&ScriptEngineClient::broadcastDeleteDevices, this, std::placeholders::_1)));
@@ -112,7 +113,12 @@ void ScriptEngineClient::dispose()
 		stopEventThreads();
 		stopQueue(0);
 		php_homegear_shutdown();
-		_scriptCache.clear();
+		{
+			std::lock_guard<std::mutex> scriptCacheGuard(_scriptCacheMutex);
+			_scriptCache.clear();
+			_scriptCacheLru.clear();
+			_scriptCacheSize = 0;
+		}
 		_rpcResponses.clear();
 	}
     catch(const std::exception& ex)
@@ -411,9 +417,121 @@ void ScriptEngineClient::sendOutput(std::string& output)
 	try
 	{
 		zend_homegear_globals* globals = php_homegear_get_globals();
-		std::string methodName("scriptOutput");
+		int32_t scriptId = globals->id;
+		PRequestInfo requestInfo;
+		{
+			std::lock_guard<std::mutex> requestInfoGuard(_requestInfoMutex);
+			std::map<int32_t, PRequestInfo>::iterator requestIterator = _requestInfo.find(scriptId);
+			if(requestIterator != _requestInfo.end()) requestInfo = requestIterator->second;
+		}
+		if(!requestInfo)
+		{
+			std::string methodName("scriptOutput");
+			BaseLib::PArray parameters(new BaseLib::Array{BaseLib::PVariable(new BaseLib::Variable(output))});
+			sendRequest(scriptId, methodName, parameters);
+			return;
+		}
+
+		//Only wait for the response to the previous output frame, not for this one. This way output is still processed in order.
+		std::lock_guard<std::mutex> outputGuard(requestInfo->outputMutex);
+		waitForOutputResponse(scriptId, requestInfo);
+
+		int32_t packetId;
+		{
+			std::lock_guard<std::mutex> packetIdGuard(_packetIdMutex);
+			packetId = _currentPacketId++;
+		}
 		BaseLib::PArray parameters(new BaseLib::Array{BaseLib::PVariable(new BaseLib::Variable(output))});
-		sendRequest(globals->id, methodName, parameters);
+		BaseLib::PArray array(new BaseLib::Array{ BaseLib::PVariable(new BaseLib::Variable(scriptId)), BaseLib::PVariable(new BaseLib::Variable(packetId)), BaseLib::PVariable(new BaseLib::Variable(parameters)) });
+		std::vector<char> data;
+		_rpcEncoder->encodeRequest("scriptOutput", array, data);
+
+		BaseLib::PPVariable response;
+		{
+			std::lock_guard<std::mutex> responseGuard(_rpcResponsesMutex);
+			BaseLib::PPVariable* element = &_rpcResponses[scriptId][packetId];
+			element->reset(new BaseLib::PVariable());
+			response = *element;
+		}
+		response->reset(new BaseLib::Variable());
+
+		BaseLib::PVariable result = send(data);
+		if(result->errorStruct)
+		{
+			std::lock_guard<std::mutex> responseGuard(_rpcResponsesMutex);
+			_rpcResponses[scriptId].erase(packetId);
+			return;
+		}
+
+		requestInfo->outputPacketId = packetId;
+		requestInfo->outputResponse = response;
+	}
+	catch(const std::exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+void ScriptEngineClient::waitForOutputResponse(int32_t scriptId, PRequestInfo& requestInfo)
+{
+	try
+	{
+		if(requestInfo->outputPacketId == -1 || !requestInfo->outputResponse) return;
+		int32_t packetId = requestInfo->outputPacketId;
+		BaseLib::PPVariable response = requestInfo->outputResponse;
+		requestInfo->outputPacketId = -1;
+		requestInfo->outputResponse.reset();
+
+		{
+			std::unique_lock<std::mutex> waitLock(requestInfo->waitMutex);
+			while(!requestInfo->conditionVariable.wait_for(waitLock, std::chrono::milliseconds(10000), [&]{
+				return ((bool)(*response) && (*response)->arrayValue->size() == 3 && (*response)->arrayValue->at(1)->integerValue == packetId) || _disposing;
+			}));
+		}
+
+		if(!(*response) || (*response)->arrayValue->size() != 3 || (*response)->arrayValue->at(1)->integerValue != packetId)
+		{
+			_out.printError("Error: No response received to RPC request. Method: scriptOutput");
+		}
+
+		std::lock_guard<std::mutex> responseGuard(_rpcResponsesMutex);
+		_rpcResponses[scriptId].erase(packetId);
+	}
+	catch(const std::exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+void ScriptEngineClient::waitForOutput(int32_t scriptId)
+{
+	try
+	{
+		PRequestInfo requestInfo;
+		{
+			std::lock_guard<std::mutex> requestInfoGuard(_requestInfoMutex);
+			std::map<int32_t, PRequestInfo>::iterator requestIterator = _requestInfo.find(scriptId);
+			if(requestIterator == _requestInfo.end() || !requestIterator->second) return;
+			requestInfo = requestIterator->second;
+		}
+		std::lock_guard<std::mutex> outputGuard(requestInfo->outputMutex);
+		waitForOutputResponse(scriptId, requestInfo);
 	}
 	catch(const std::exception& ex)
     {
@@ -765,17 +883,19 @@ ScriptEngineClient::ScriptGuard::~ScriptGuard()
 		if(globals && globals->executionStarted)
 		{
 			php_request_shutdown(NULL);
+			php_homegear_flush_output(); //Send remaining buffered output before the globals are freed.
 
 			ts_free_thread();
 		}
 	}
+	_client->waitForOutput(_scriptId);
 	_client->sendScriptFinished(_scriptInfo->exitCode);
 	if(_scriptInfo->peerId > 0) GD::out.printInfo("Info: PHP script of peer " + std::to_string(_scriptInfo->peerId) + " exited with code " + std::to_string(_scriptInfo->exitCode) + ".");
 	else GD::out.printInfo("Info: Script " + std::to_string(_scriptId) + " exited with code " + std::to_string(_scriptInfo->exitCode) + ".");
 	_client->setThreadNotRunning(_scriptId);
 }
 
-void ScriptEngineClient::runScript(int32_t id, PScriptInfo scriptInfo)
+void ScriptEngineClient::runScript(int32_t id, PScriptInfo scriptInfo, std::shared_ptr<CacheInfo> cacheInfo)
 {
 	ts_resource_ex(0, NULL); //Replaces TSRMLS_FETCH()
 	BaseLib::Rpc::PServerInfo serverInfo(new BaseLib::Rpc::ServerInfo::Info());
@@ -784,14 +904,16 @@ void ScriptEngineClient::runScript(int32_t id, PScriptInfo scriptInfo)
 	{
 		zend_file_handle zendHandle;
 		ScriptInfo::ScriptType type = scriptInfo->getType();
-		if(!scriptInfo->script.empty())
+		//Scripts read from a file are executed from the cached source. "cacheInfo" keeps the source alive until the script is finished.
+		const std::string& script = (scriptInfo->script.empty() && cacheInfo) ? cacheInfo->script : scriptInfo->script;
+		if(!script.empty())
 		{
 			zendHandle.type = ZEND_HANDLE_MAPPED;
 			zendHandle.handle.fp = nullptr;
 			zendHandle.handle.stream.handle = nullptr;
 			zendHandle.handle.stream.closer = nullptr;
-			zendHandle.handle.stream.mmap.buf = (char*)scriptInfo->script.c_str(); //String is not modified
-			zendHandle.handle.stream.mmap.len = scriptInfo->script.size();
+			zendHandle.handle.stream.mmap.buf = (char*)script.c_str(); //String is not modified
+			zendHandle.handle.stream.mmap.len = (scriptInfo->script.empty() && cacheInfo) ? cacheInfo->size : script.size();
 			zendHandle.filename = scriptInfo->fullPath.c_str();
 			zendHandle.opened_path = nullptr;
 			zendHandle.free_filename = 0;
@@ -926,49 +1048,111 @@ void ScriptEngineClient::scriptThread(int32_t id, PScriptInfo scriptInfo, bool s
 		}
 		ScriptGuard scriptGuard(this, globals, id, scriptInfo);
 
-		if(scriptInfo->script.empty() && scriptInfo->fullPath.size() > 3 && scriptInfo->fullPath.compare(scriptInfo->fullPath.size() - 4, 4, ".hgs") == 0)
+		std::shared_ptr<CacheInfo> cacheInfo;
+		if(scriptInfo->script.empty())
 		{
-			std::map<std::string, std::shared_ptr<CacheInfo>>::iterator scriptIterator = _scriptCache.find(scriptInfo->fullPath);
-			if(scriptIterator != _scriptCache.end() && scriptIterator->second->lastModified == BaseLib::Io::getFileLastModifiedTime(scriptInfo->fullPath)) scriptInfo->script = scriptIterator->second->script;
-			else
+			cacheInfo = getCachedScript(scriptInfo->fullPath);
+			if(scriptInfo->fullPath.size() > 3 && scriptInfo->fullPath.compare(scriptInfo->fullPath.size() - 4, 4, ".hgs") == 0)
 			{
-				std::vector<char> data = BaseLib::Io::getBinaryFileContent(scriptInfo->fullPath);
-				int32_t pos = -1;
-				for(uint32_t i = 0; i < 11 && i < data.size(); i++)
-				{
-					if(data[i] == ' ')
-					{
-						pos = (int32_t)i;
-						break;
-					}
-				}
-				if(pos == -1)
-				{
-					GD::bl->out.printError("Error: License module id is missing in encrypted script file \"" + scriptInfo->fullPath + "\"");
-					return;
-				}
-				std::string moduleIdString(&data.at(0), pos);
-				int32_t moduleId = BaseLib::Math::getNumber(moduleIdString);
-				std::vector<char> input(&data.at(pos + 1), &data.at(data.size() - 1) + 1);
-				if(input.empty()) return;
-				std::map<int32_t, std::unique_ptr<BaseLib::Licensing::Licensing>>::iterator i = GD::licensingModules.find(moduleId);
-				if(i == GD::licensingModules.end() || !i->second)
-				{
-					GD::out.printError("Error: Could not decrypt script file. Licensing module with id 0x" + BaseLib::HelperFunctions::getHexString(moduleId) + " not found");
-					return;
-				}
-				std::shared_ptr<CacheInfo> cacheInfo(new CacheInfo());
-				i->second->decryptScript(input, cacheInfo->script);
-				cacheInfo->lastModified = BaseLib::Io::getFileLastModifiedTime(scriptInfo->fullPath);
-				if(!cacheInfo->script.empty())
+				if(!cacheInfo) return;
+				scriptInfo->script = cacheInfo->script.substr(0, cacheInfo->size);
+				cacheInfo.reset();
+			}
+		}
+
+		runScript(id, scriptInfo, cacheInfo);
+	}
+	catch(const std::exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+std::shared_ptr<ScriptEngineClient::CacheInfo> ScriptEngineClient::getCachedScript(const std::string& path)
+{
+	try
+	{
+		struct stat fileInfo;
+		if(stat(path.c_str(), &fileInfo) == -1 || !S_ISREG(fileInfo.st_mode))
+		{
+			std::lock_guard<std::mutex> scriptCacheGuard(_scriptCacheMutex);
+			std::map<std::string, std::shared_ptr<CacheInfo>>::iterator scriptIterator = _scriptCache.find(path);
+			if(scriptIterator != _scriptCache.end()) removeCachedScript(scriptIterator);
+			return std::shared_ptr<CacheInfo>();
+		}
+		{
+			std::lock_guard<std::mutex> scriptCacheGuard(_scriptCacheMutex);
+			std::map<std::string, std::shared_ptr<CacheInfo>>::iterator scriptIterator = _scriptCache.find(path);
+			if(scriptIterator != _scriptCache.end() && scriptIterator->second->lastModified.tv_sec == fileInfo.st_mtim.tv_sec && scriptIterator->second->lastModified.tv_nsec == fileInfo.st_mtim.tv_nsec && scriptIterator->second->fileSize == fileInfo.st_size)
+			{
+				_scriptCacheHits++;
+				_scriptCacheLru.splice(_scriptCacheLru.begin(), _scriptCacheLru, scriptIterator->second->lruIterator);
+				return scriptIterator->second;
+			}
+			_scriptCacheMisses++;
+		}
+
+		std::shared_ptr<CacheInfo> cacheInfo(new CacheInfo());
+		cacheInfo->lastModified = fileInfo.st_mtim;
+		cacheInfo->fileSize = fileInfo.st_size;
+		if(path.size() > 3 && path.compare(path.size() - 4, 4, ".hgs") == 0)
+		{
+			std::vector<char> data = BaseLib::Io::getBinaryFileContent(path);
+			int32_t pos = -1;
+			for(uint32_t i = 0; i < 11 && i < data.size(); i++)
+			{
+				if(data[i] == ' ')
 				{
-					_scriptCache[scriptInfo->fullPath] = cacheInfo;
-					scriptInfo->script = cacheInfo->script;
+					pos = (int32_t)i;
+					break;
 				}
 			}
+			if(pos == -1)
+			{
+				GD::bl->out.printError("Error: License module id is missing in encrypted script file \"" + path + "\"");
+				return std::shared_ptr<CacheInfo>();
+			}
+			std::string moduleIdString(&data.at(0), pos);
+			int32_t moduleId = BaseLib::Math::getNumber(moduleIdString);
+			std::vector<char> input(&data.at(pos + 1), &data.at(data.size() - 1) + 1);
+			if(input.empty()) return std::shared_ptr<CacheInfo>();
+			std::map<int32_t, std::unique_ptr<BaseLib::Licensing::Licensing>>::iterator i = GD::licensingModules.find(moduleId);
+			if(i == GD::licensingModules.end() || !i->second)
+			{
+				GD::out.printError("Error: Could not decrypt script file. Licensing module with id 0x" + BaseLib::HelperFunctions::getHexString(moduleId) + " not found");
+				return std::shared_ptr<CacheInfo>();
+			}
+			i->second->decryptScript(input, cacheInfo->script);
 		}
-
-		runScript(id, scriptInfo);
+		else cacheInfo->script = GD::bl->io.getFileContent(path);
+		if(cacheInfo->script.empty()) return std::shared_ptr<CacheInfo>();
+		cacheInfo->size = cacheInfo->script.size();
+		cacheInfo->script.append(ZEND_MMAP_AHEAD, '\0');
+
+		std::lock_guard<std::mutex> scriptCacheGuard(_scriptCacheMutex);
+		std::map<std::string, std::shared_ptr<CacheInfo>>::iterator scriptIterator = _scriptCache.find(path);
+		if(scriptIterator != _scriptCache.end()) removeCachedScript(scriptIterator);
+		if((int64_t)cacheInfo->script.size() > _scriptCacheMaxSize) return cacheInfo; //Too large to be cached
+		//Evict the least recently used scripts.
+		while(!_scriptCacheLru.empty() && (_scriptCacheSize + (int64_t)cacheInfo->script.size() > _scriptCacheMaxSize || _scriptCache.size() >= _scriptCacheMaxEntries))
+		{
+			scriptIterator = _scriptCache.find(_scriptCacheLru.back());
+			if(scriptIterator == _scriptCache.end()) _scriptCacheLru.pop_back();
+			else removeCachedScript(scriptIterator);
+		}
+		_scriptCacheLru.push_front(path);
+		cacheInfo->lruIterator = _scriptCacheLru.begin();
+		_scriptCacheSize += cacheInfo->script.size();
+		_scriptCache[path] = cacheInfo;
+		return cacheInfo;
 	}
 	catch(const std::exception& ex)
     {
@@ -982,6 +1166,14 @@ void ScriptEngineClient::scriptThread(int32_t id, PScriptInfo scriptInfo, bool s
     {
     	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
     }
+    return std::shared_ptr<CacheInfo>();
+}
+
+std::map<std::string, std::shared_ptr<ScriptEngineClient::CacheInfo>>::iterator ScriptEngineClient::removeCachedScript(std::map<std::string, std::shared_ptr<CacheInfo>>::iterator entry)
+{
+	_scriptCacheSize -= entry->second->script.size();
+	_scriptCacheLru.erase(entry->second->lruIterator);
+	return _scriptCache.erase(entry);
 }
 
 // {{{ RPC methods
@@ -1134,6 +1326,57 @@ BaseLib::PVariable ScriptEngineClient::scriptCount(BaseLib::PArray& parameters)
     return BaseLib::Variable::createError(-32500, "Unknown application error.");
 }
 
+BaseLib::PVariable ScriptEngineClient::getScriptCacheStatistics(BaseLib::PArray& parameters)
+{
+	try
+	{
+		if(_disposing) return BaseLib::Variable::createError(-1, "Client is disposing.");
+
+		BaseLib::PVariable statistics(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+
+		//Evict scripts deleted since they were last executed, so they are neither kept in memory nor counted. Files are checked without holding the lock.
+		std::vector<std::string> paths;
+		{
+			std::lock_guard<std::mutex> scriptCacheGuard(_scriptCacheMutex);
+			paths.reserve(_scriptCache.size());
+			for(std::map<std::string, std::shared_ptr<CacheInfo>>::iterator i = _scriptCache.begin(); i != _scriptCache.end(); ++i)
+			{
+				paths.push_back(i->first);
+			}
+		}
+		std::vector<std::string> deletedPaths;
+		for(std::vector<std::string>::iterator i = paths.begin(); i != paths.end(); ++i)
+		{
+			if(!GD::bl->io.fileExists(*i)) deletedPaths.push_back(*i);
+		}
+
+		std::lock_guard<std::mutex> scriptCacheGuard(_scriptCacheMutex);
+		for(std::vector<std::string>::iterator i = deletedPaths.begin(); i != deletedPaths.end(); ++i)
+		{
+			std::map<std::string, std::shared_ptr<CacheInfo>>::iterator scriptIterator = _scriptCache.find(*i);
+			if(scriptIterator != _scriptCache.end()) removeCachedScript(scriptIterator);
+		}
+		statistics->structValue->insert(BaseLib::StructElement("HITS", BaseLib::PVariable(new BaseLib::Variable(_scriptCacheHits))));
+		statistics->structValue->insert(BaseLib::StructElement("MISSES", BaseLib::PVariable(new BaseLib::Variable(_scriptCacheMisses))));
+		statistics->structValue->insert(BaseLib::StructElement("ENTRIES", BaseLib::PVariable(new BaseLib::Variable((int32_t)_scriptCache.size()))));
+		statistics->structValue->insert(BaseLib::StructElement("SIZE", BaseLib::PVariable(new BaseLib::Variable(_scriptCacheSize))));
+		return statistics;
+	}
+    catch(const std::exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
+
 BaseLib::PVariable ScriptEngineClient::broadcastEvent(BaseLib::PArray& parameters)
 {
 	try
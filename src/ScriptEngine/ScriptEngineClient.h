@@ -38,6 +38,9 @@
 #include <thread>
 #include <mutex>
 #include <string>
+#include <list>
+
+#include <sys/stat.h>
 
 using namespace BaseLib::ScriptEngine;
 
@@ -56,14 +59,40 @@ public:
 private:
 	struct CacheInfo
 	{
-		int32_t lastModified;
+		/**
+		 * Modification time and size of the file when it was read. Both are compared, so a file rewritten within the same second is read again.
+		 */
+		struct timespec lastModified{0, 0};
+		off_t fileSize = 0;
+
+		/**
+		 * The source followed by ZEND_MMAP_AHEAD zero bytes, because PHP's scanner may read up to ZEND_MMAP_AHEAD bytes past the end of a mapped buffer.
+		 */
 		std::string script;
+
+		/**
+		 * Size of the source without the padding.
+		 */
+		size_t size = 0;
+
+		/**
+		 * Position in _scriptCacheLru.
+		 */
+		std::list<std::string>::iterator lruIterator;
 	};
 
 	struct RequestInfo
 	{
 		std::mutex waitMutex;
 		std::condition_variable conditionVariable;
+
+		/**
+		 * Serializes the output frames of a script. Only one output frame per script is unacknowledged at any time, so output can't be reordered by the
+		 * server's processing threads.
+		 */
+		std::mutex outputMutex;
+		int32_t outputPacketId = -1;
+		BaseLib::PPVariable outputResponse;
 	};
 	typedef std::shared_ptr<RequestInfo> PRequestInfo;
 
@@ -109,7 +138,18 @@ private:
 	std::map<int32_t, std::pair<std::thread, bool>> _scriptThreads;
 	std::mutex _requestInfoMutex;
 	std::map<int32_t, PRequestInfo> _requestInfo;
+	std::mutex _scriptCacheMutex;
 	std::map<std::string, std::shared_ptr<CacheInfo>> _scriptCache;
+
+	/**
+	 * Paths of the cached scripts. The most recently used script is first.
+	 */
+	std::list<std::string> _scriptCacheLru;
+	int64_t _scriptCacheSize = 0;
+	const int64_t _scriptCacheMaxSize = 16777216;
+	const size_t _scriptCacheMaxEntries = 1000;
+	int64_t _scriptCacheHits = 0;
+	int64_t _scriptCacheMisses = 0;
 	std::mutex _packetIdMutex;
 	int32_t _currentPacketId = 0;
 
@@ -121,6 +161,16 @@ private:
 	std::vector<std::string> getArgs(const std::string& path, const std::string& args);
 	void registerClient();
 	void sendOutput(std::string& output);
+
+	/**
+	 * Waits until the last output frame sent by sendOutput() is acknowledged by the server. "outputMutex" of requestInfo needs to be locked.
+	 */
+	void waitForOutputResponse(int32_t scriptId, PRequestInfo& requestInfo);
+
+	/**
+	 * Waits until all output of a script is processed by the server.
+	 */
+	void waitForOutput(int32_t scriptId);
 	void sendHeaders(BaseLib::PVariable& headers);
 	BaseLib::PVariable callMethod(std::string& methodName, BaseLib::PVariable& parameters);
 	BaseLib::PVariable sendRequest(int32_t scriptId, std::string methodName, BaseLib::PArray& parameters);
@@ -132,7 +182,25 @@ private:
 
 	void processQueueEntry(int32_t index, std::shared_ptr<BaseLib::IQueueEntry>& entry);
 	void scriptThread(int32_t id, PScriptInfo scriptInfo, bool sendOutput);
-	void runScript(int32_t id, PScriptInfo scriptInfo);
+	void runScript(int32_t id, PScriptInfo scriptInfo, std::shared_ptr<CacheInfo> cacheInfo);
+
+	/**
+	 * Returns the source of a script file from the script cache. The file is read (and decrypted for ".hgs" files) when it is not cached yet or when
+	 * it was modified since it was cached. Only the source is cached, scripts are still compiled on every execution: PHP allocates opcodes per
+	 * request and frees them on request shutdown.
+	 *
+	 * @param path The full path to the script file.
+	 * @return Returns the cache entry or an empty pointer when the file could not be read.
+	 */
+	std::shared_ptr<CacheInfo> getCachedScript(const std::string& path);
+
+	/**
+	 * Removes an entry from the script cache. _scriptCacheMutex needs to be locked.
+	 *
+	 * @return Returns the iterator following the removed entry.
+	 */
+	std::map<std::string, std::shared_ptr<CacheInfo>>::iterator removeCachedScript(std::map<std::string, std::shared_ptr<CacheInfo>>::iterator entry);
+
 	BaseLib::PVariable send(std::vector<char>& data);
 
 	// {{{ RPC methods
@@ -160,6 +228,13 @@ private:
 		 * @return Returns the number of running scripts.
 		 */
 		BaseLib::PVariable scriptCount(BaseLib::PArray& parameters);
+
+		/**
+		 * Returns the hit and miss counters of the script cache.
+		 * @param parameters Irrelevant for this method.
+		 * @return Returns a struct with the elements "HITS", "MISSES", "ENTRIES" and "SIZE".
+		 */
+		BaseLib::PVariable getScriptCacheStatistics(BaseLib::PArray& parameters);
 		BaseLib::PVariable broadcastEvent(BaseLib::PArray& parameters);
 		BaseLib::PVariable broadcastNewDevices(BaseLib::PArray& parameters);
 		BaseLib::PVariable broadcastDeleteDevices(BaseLib::PArray& parameters);
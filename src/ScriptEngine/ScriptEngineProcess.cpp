@@ -36,7 +36,7 @@ namespace ScriptEngine
 
 ScriptEngineProcess::ScriptEngineProcess()
 {
-
+	_scriptDuration = GD::metrics.histogram("homegear_script_duration_seconds", "Execution time of scripts run by the script engine.");
 }
 
 ScriptEngineProcess::~ScriptEngineProcess()
@@ -181,6 +181,7 @@ void ScriptEngineProcess::invokeScriptFinished(int32_t id, int32_t exitCode)
 		std::map<int32_t, PScriptFinishedInfo>::iterator scriptFinishedIterator = _scriptFinishedInfo.find(id);
 		if(scriptFinishedIterator != _scriptFinishedInfo.end())
 		{
+			if(!scriptFinishedIterator->second->finished) _scriptDuration->record(Metrics::getTime() - scriptFinishedIterator->second->startTime);
 			scriptFinishedIterator->second->finished = true;
 			scriptFinishedIterator->second->conditionVariable.notify_all();
 		}
@@ -259,6 +260,7 @@ void ScriptEngineProcess::registerScript(int32_t id, PScriptInfo& scriptInfo)
 		std::lock_guard<std::mutex> scriptsGuard(_scriptsMutex);
 		_scripts[id] = scriptInfo;
 		_scriptFinishedInfo[id] = PScriptFinishedInfo(new ScriptFinishedInfo());
+		_scriptFinishedInfo[id]->startTime = Metrics::getTime();
 	}
 	catch(const std::exception& ex)
     {
@@ -33,6 +33,7 @@
 
 #include "ScriptEngineClientData.h"
 #include "homegear-base/BaseLib.h"
+#include "../Metrics/Metrics.h"
 
 using namespace BaseLib::ScriptEngine;
 
@@ -42,6 +43,7 @@ namespace ScriptEngine
 struct ScriptFinishedInfo
 {
 	bool finished = false;
+	int64_t startTime = 0;
 	std::mutex mutex;
 	std::condition_variable conditionVariable;
 };
@@ -55,6 +57,7 @@ private:
 	std::map<int32_t, PScriptInfo> _scripts;
 	std::map<int32_t, PScriptFinishedInfo> _scriptFinishedInfo;
 	PScriptEngineClientData _clientData;
+	Metrics::PHistogram _scriptDuration;
 public:
 	ScriptEngineProcess();
 	virtual ~ScriptEngineProcess();
@@ -40,87 +40,97 @@ ScriptEngineServer::ScriptEngineServer() : IQueue(GD::bl.get(), 1000)
 {
 	_out.init(GD::bl.get());
 	_out.setPrefix("Script Engine Server: ");
+	_statistics = GD::rpcStatistics.getClientStatistics("scriptEngine");
+	_queueDepth = GD::metrics.queueDepth("scriptEngineServer");
 
 	_rpcDecoder = std::unique_ptr<BaseLib::RPC::RPCDecoder>(new BaseLib::RPC::RPCDecoder(GD::bl.get()));
 	_rpcEncoder = std::unique_ptr<BaseLib::RPC::RPCEncoder>(new BaseLib::RPC::RPCEncoder(GD::bl.get()));
 	_dummyClientInfo.reset(new BaseLib::RpcClientInfo());
 
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("devTest", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCDevTest())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("system.getCapabilities", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSystemGetCapabilities())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("system.listMethods", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSystemListMethods(GD::rpcServers[0].getServer()))));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("system.methodHelp", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSystemMethodHelp(GD::rpcServers[0].getServer()))));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("system.methodSignature", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSystemMethodSignature(GD::rpcServers[0].getServer()))));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("system.multicall", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSystemMulticall(GD::rpcServers[0].getServer()))));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("activateLinkParamset", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCActivateLinkParamset())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("abortEventReset", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCTriggerEvent())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("addDevice", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCAddDevice())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("addEvent", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCAddEvent())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("addLink", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCAddLink())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("copyConfig", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCCopyConfig())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("clientServerInitialized", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCClientServerInitialized())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("createDevice", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCCreateDevice())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("deleteDevice", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCDeleteDevice())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("deleteMetadata", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCDeleteMetadata())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("deleteSystemVariable", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCDeleteSystemVariable())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("enableEvent", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCEnableEvent())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getAllConfig", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetAllConfig())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getAllMetadata", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetAllMetadata())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getAllScripts", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetAllScripts())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getAllSystemVariables", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetAllSystemVariables())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getAllValues", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetAllValues())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getConfigParameter", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetConfigParameter())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getDeviceDescription", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetDeviceDescription())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getDeviceInfo", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetDeviceInfo())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getEvent", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetEvent())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getInstallMode", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetInstallMode())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getKeyMismatchDevice", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetKeyMismatchDevice())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getLinkInfo", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetLinkInfo())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getLinkPeers", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetLinkPeers())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getLinks", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetLinks())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getMetadata", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetMetadata())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getName", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetName())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getPairingMethods", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetPairingMethods())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getParamset", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetParamset())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getParamsetDescription", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetParamsetDescription())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getParamsetId", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetParamsetId())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getPeerId", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetPeerId())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getServiceMessages", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetServiceMessages())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getSystemVariable", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetSystemVariable())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getUpdateStatus", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetUpdateStatus())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getValue", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetValue())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("getVersion", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetVersion())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("init", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCInit())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("listBidcosInterfaces", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListBidcosInterfaces())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("listClientServers", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListClientServers())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("listDevices", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListDevices())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("listEvents", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListEvents())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("listFamilies", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListFamilies())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("listInterfaces", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListInterfaces())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("listKnownDeviceTypes", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListKnownDeviceTypes())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("listTeams", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListTeams())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("logLevel", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCLogLevel())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("putParamset", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCPutParamset())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("removeEvent", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCRemoveEvent())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("removeLink", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCRemoveLink())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("reportValueUsage", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCReportValueUsage())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("rssiInfo", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCRssiInfo())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("runScript", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCRunScript())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("searchDevices", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSearchDevices())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("setId", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetId())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("setInstallMode", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetInstallMode())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("setInterface", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetInterface())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("setLinkInfo", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetLinkInfo())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("setMetadata", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetMetadata())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("setName", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetName())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("setSystemVariable", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetSystemVariable())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("setTeam", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetTeam())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("setValue", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetValue())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("subscribePeers", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSubscribePeers())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("triggerEvent", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCTriggerEvent())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("triggerRpcEvent", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCTriggerRpcEvent())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("unsubscribePeers", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCUnsubscribePeers())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("updateFirmware", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCUpdateFirmware())));
-	_rpcMethods.insert(std::pair<std::string, std::shared_ptr<RPC::RPCMethod>>("writeLog", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCWriteLog())));
+	_rpcMethods.add("devTest", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCDevTest()));
+	_rpcMethods.add("system.getCapabilities", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSystemGetCapabilities()));
+	_rpcMethods.add("system.listMethods", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSystemListMethods(GD::rpcServers[0].getServer())));
+	_rpcMethods.add("system.methodHelp", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSystemMethodHelp(GD::rpcServers[0].getServer())));
+	_rpcMethods.add("system.methodSignature", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSystemMethodSignature(GD::rpcServers[0].getServer())));
+	_rpcMethods.add("system.multicall", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSystemMulticall(GD::rpcServers[0].getServer())));
+	_rpcMethods.add("activateLinkParamset", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCActivateLinkParamset()));
+	_rpcMethods.add("abortEventReset", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCTriggerEvent()));
+	_rpcMethods.add("addDevice", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCAddDevice()));
+	_rpcMethods.add("addEvent", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCAddEvent()));
+	_rpcMethods.add("addLink", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCAddLink()));
+	_rpcMethods.add("copyConfig", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCCopyConfig()));
+	_rpcMethods.add("clientServerInitialized", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCClientServerInitialized()));
+	_rpcMethods.add("createDevice", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCCreateDevice()));
+	_rpcMethods.add("deleteDevice", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCDeleteDevice()));
+	_rpcMethods.add("deleteMetadata", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCDeleteMetadata()));
+	_rpcMethods.add("deleteSystemVariable", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCDeleteSystemVariable()));
+	_rpcMethods.add("enableEvent", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCEnableEvent()));
+	_rpcMethods.add("getAllConfig", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetAllConfig()));
+	_rpcMethods.add("getAllMetadata", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetAllMetadata()));
+	_rpcMethods.add("getAllScripts", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetAllScripts()));
+	_rpcMethods.add("getAllSystemVariables", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetAllSystemVariables()));
+	_rpcMethods.add("getAllValues", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetAllValues()));
+	_rpcMethods.add("getConfigParameter", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetConfigParameter()));
+	_rpcMethods.add("getDeviceDescription", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetDeviceDescription()));
+	_rpcMethods.add("getDeviceInfo", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetDeviceInfo()));
+	_rpcMethods.add("getEvent", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetEvent()));
+	_rpcMethods.add("getInstallMode", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetInstallMode()));
+	_rpcMethods.add("getKeyMismatchDevice", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetKeyMismatchDevice()));
+	_rpcMethods.add("getLinkInfo", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetLinkInfo()));
+	_rpcMethods.add("getLinkPeers", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetLinkPeers()));
+	_rpcMethods.add("getLinks", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetLinks()));
+	_rpcMethods.add("getMetadata", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetMetadata()));
+	_rpcMethods.add("getMetrics", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetMetrics()));
+	_rpcMethods.add("getName", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetName()));
+	_rpcMethods.add("getPairingMethods", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetPairingMethods()));
+	_rpcMethods.add("getParamset", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetParamset()));
+	_rpcMethods.add("getParamsetDescription", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetParamsetDescription()));
+	_rpcMethods.add("getParamsetId", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetParamsetId()));
+	_rpcMethods.add("getPeerId", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetPeerId()));
+	_rpcMethods.add("getRpcStatistics", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetRpcStatistics()));
+	_rpcMethods.add("getServiceMessages", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetServiceMessages()));
+	_rpcMethods.add("getSystemVariable", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetSystemVariable()));
+	_rpcMethods.add("getSystemVariables", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetSystemVariables()));
+	_rpcMethods.add("getUpdateStatus", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetUpdateStatus()));
+	_rpcMethods.add("getValue", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetValue()));
+	_rpcMethods.add("getValues", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetValues()));
+	_rpcMethods.add("getValuesChangedSince", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetValuesChangedSince()));
+	_rpcMethods.add("getValuesSnapshot", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetValuesSnapshot()));
+	_rpcMethods.add("getVersion", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCGetVersion()));
+	_rpcMethods.add("init", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCInit()));
+	_rpcMethods.add("listBidcosInterfaces", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListBidcosInterfaces()));
+	_rpcMethods.add("listClientServers", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListClientServers()));
+	_rpcMethods.add("listDevices", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListDevices()));
+	_rpcMethods.add("listEvents", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListEvents()));
+	_rpcMethods.add("listFamilies", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListFamilies()));
+	_rpcMethods.add("listInterfaces", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListInterfaces()));
+	_rpcMethods.add("listKnownDeviceTypes", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListKnownDeviceTypes()));
+	_rpcMethods.add("listTeams", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCListTeams()));
+	_rpcMethods.add("logLevel", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCLogLevel()));
+	_rpcMethods.add("putParamset", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCPutParamset()));
+	_rpcMethods.add("removeEvent", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCRemoveEvent()));
+	_rpcMethods.add("removeLink", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCRemoveLink()));
+	_rpcMethods.add("reportValueUsage", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCReportValueUsage()));
+	_rpcMethods.add("rssiInfo", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCRssiInfo()));
+	_rpcMethods.add("runScript", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCRunScript()));
+	_rpcMethods.add("searchDevices", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSearchDevices()));
+	_rpcMethods.add("setId", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetId()));
+	_rpcMethods.add("setInstallMode", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetInstallMode()));
+	_rpcMethods.add("setInterface", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetInterface()));
+	_rpcMethods.add("setLinkInfo", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetLinkInfo()));
+	_rpcMethods.add("setMetadata", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetMetadata()));
+	_rpcMethods.add("setName", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetName()));
+	_rpcMethods.add("setSystemVariable", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetSystemVariable()));
+	_rpcMethods.add("setSystemVariables", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetSystemVariables()));
+	_rpcMethods.add("setTeam", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetTeam()));
+	_rpcMethods.add("setValue", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetValue()));
+	_rpcMethods.add("setValues", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSetValues()));
+	_rpcMethods.add("subscribePeers", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCSubscribePeers()));
+	_rpcMethods.add("triggerEvent", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCTriggerEvent()));
+	_rpcMethods.add("triggerRpcEvent", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCTriggerRpcEvent()));
+	_rpcMethods.add("unsubscribePeers", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCUnsubscribePeers()));
+	_rpcMethods.add("updateFirmware", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCUpdateFirmware()));
+	_rpcMethods.add("writeLog", std::shared_ptr<RPC::RPCMethod>(new RPC::RPCWriteLog()));
 
 	_localRpcMethods.insert(std::pair<std::string, std::function<BaseLib::PVariable(PScriptEngineClientData& clientData, int32_t scriptId, BaseLib::PArray& parameters)>>("registerScriptEngineClient", std::bind(&ScriptEngineServer::registerScriptEngineClient, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)));
 	_localRpcMethods.insert(std::pair<std::string, std::function<BaseLib::PVariable(PScriptEngineClientData& clientData, int32_t scriptId, BaseLib::PArray& parameters)>>("scriptFinished", std::bind(&ScriptEngineServer::scriptFinished, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)));
@@ -152,7 +162,6 @@ ScriptEngineServer::ScriptEngineServer() : IQueue(GD::bl.get(), 1000)
 ScriptEngineServer::~ScriptEngineServer()
 {
 	if(!_stopServer) stop();
-	GD::bl->threadManager.join(_checkSessionIdThread);
 	php_homegear_shutdown();
 }
 
@@ -280,6 +289,7 @@ void ScriptEngineServer::stop()
 			if(_clients.size() > 0) std::this_thread::sleep_for(std::chrono::milliseconds(100));
 		}
 		stopQueue(0);
+		_queueDepth->clear();
 		unlink(_socketPath.c_str());
 	}
 	catch(const std::exception& ex)
@@ -632,6 +642,7 @@ void ScriptEngineServer::processQueueEntry(int32_t index, std::shared_ptr<BaseLi
 {
 	try
 	{
+		_queueDepth->decrement();
 		std::shared_ptr<QueueEntry> queueEntry;
 		queueEntry = std::dynamic_pointer_cast<QueueEntry>(entry);
 		if(!queueEntry || queueEntry->clientData->closed) return;
@@ -672,8 +683,8 @@ void ScriptEngineServer::processQueueEntry(int32_t index, std::shared_ptr<BaseLi
 				return;
 			}
 
-			std::map<std::string, std::shared_ptr<RPC::RPCMethod>>::iterator methodIterator = _rpcMethods.find(methodName);
-			if(methodIterator == _rpcMethods.end())
+			const RPC::RpcMethodTable::Entry* method = _rpcMethods.find(methodName);
+			if(!method)
 			{
 				_out.printError("Error: RPC method not found: " + methodName);
 				BaseLib::PVariable error = BaseLib::Variable::createError(-32601, ": Requested method not found.");
@@ -689,7 +700,11 @@ void ScriptEngineServer::processQueueEntry(int32_t index, std::shared_ptr<BaseLi
 					(*i)->print(true, false);
 				}
 			}
-			BaseLib::PVariable result = _rpcMethods.at(methodName)->invoke(_dummyClientInfo, parameters->at(2)->arrayValue);
+			int64_t startTime = Metrics::getTime();
+			BaseLib::PVariable result = method->method->invoke(_dummyClientInfo, parameters->at(2)->arrayValue);
+			int64_t duration = Metrics::getTime() - startTime;
+			method->statistics->record(duration, result->errorStruct);
+			_statistics->record(duration, result->errorStruct);
 			if(GD::bl->debugLevel >= 5)
 			{
 				_out.printDebug("Response: ");
@@ -1038,7 +1053,8 @@ void ScriptEngineServer::readClient(PScriptEngineClientData& clientData)
 				if(clientData->binaryRpc->isFinished())
 				{
 					std::shared_ptr<BaseLib::IQueueEntry> queueEntry(new QueueEntry(clientData, clientData->binaryRpc->getData(), clientData->binaryRpc->getType() == BaseLib::Rpc::BinaryRpc::Type::request));
-					enqueue(0, queueEntry);
+					_queueDepth->increment();
+					if(!enqueue(0, queueEntry)) _queueDepth->decrement();
 					clientData->binaryRpc->reset();
 				}
 			}
@@ -1148,12 +1164,57 @@ bool ScriptEngineServer::checkSessionId(const std::string& sessionId)
 {
 	try
 	{
+		if(sessionId.empty() || sessionId.size() > 128) return false;
+		for(std::string::const_iterator i = sessionId.begin(); i != sessionId.end(); ++i)
+		{
+			//Only characters allowed by PHP in session IDs. This also prevents injection of additional cookies.
+			if(!std::isalnum((unsigned char)*i) && *i != ',' && *i != '-') return false;
+		}
+
+		PSessionIdInfo sessionIdInfo;
+		{
+			std::lock_guard<std::mutex> sessionIdCacheGuard(_sessionIdCacheMutex);
+			PSessionIdInfo& element = _sessionIdCache[sessionId];
+			if(!element) element.reset(new SessionIdInfo());
+			sessionIdInfo = element;
+		}
+
+		//Concurrent checks of the same session ID wait here and use the result of the first check.
+		std::lock_guard<std::mutex> sessionIdInfoGuard(sessionIdInfo->mutex);
+		int64_t time = BaseLib::HelperFunctions::getTime();
+		if(time < sessionIdInfo->expirationTime) return sessionIdInfo->authorized;
+
 		bool result = false;
-		std::lock_guard<std::mutex> checkSessionIdGuard(_checkSessionIdMutex);
-		GD::bl->threadManager.join(_checkSessionIdThread);
-		_checkSessionIdThread = std::thread();
-		GD::bl->threadManager.start(_checkSessionIdThread, false, &ScriptEngineServer::checkSessionIdThread, this, sessionId, &result);
-		GD::bl->threadManager.join(_checkSessionIdThread);
+		std::thread checkSessionIdThread;
+		GD::bl->threadManager.start(checkSessionIdThread, false, &ScriptEngineServer::checkSessionIdThread, this, sessionId, &result);
+		GD::bl->threadManager.join(checkSessionIdThread);
+
+		time = BaseLib::HelperFunctions::getTime();
+		sessionIdInfo->authorized = result;
+		sessionIdInfo->expirationTime = time + (result ? _sessionIdAuthorizedTtl : _sessionIdUnauthorizedTtl);
+
+		{
+			std::lock_guard<std::mutex> sessionIdCacheGuard(_sessionIdCacheMutex);
+			if(_sessionIdCache.size() > _sessionIdCacheMaxEntries)
+			{
+				for(std::map<std::string, PSessionIdInfo>::iterator i = _sessionIdCache.begin(); i != _sessionIdCache.end();)
+				{
+					if(i->second == sessionIdInfo)
+					{
+						++i;
+						continue;
+					}
+					//Don't block on entries currently being checked.
+					std::unique_lock<std::mutex> expiredEntryLock(i->second->mutex, std::try_to_lock);
+					if(expiredEntryLock.owns_lock() && i->second->expirationTime <= time)
+					{
+						expiredEntryLock.unlock();
+						i = _sessionIdCache.erase(i);
+					}
+					else ++i;
+				}
+			}
+		}
 
 		return result;
 	}
@@ -1353,7 +1414,7 @@ void ScriptEngineServer::executeScript(PScriptInfo& scriptInfo, bool wait)
     }
 }
 
-BaseLib::PVariable ScriptEngineServer::getAllScripts()
+BaseLib::PVariable ScriptEngineServer::getAllScripts(bool returnStatistics)
 {
 	try
 	{
@@ -1365,7 +1426,52 @@ BaseLib::PVariable ScriptEngineServer::getAllScripts()
 			array->arrayValue->push_back(BaseLib::PVariable(new BaseLib::Variable(*i)));
 		}
 
-		return array;
+		if(!returnStatistics) return array;
+
+		std::vector<PScriptEngineClientData> clients;
+		{
+			std::lock_guard<std::mutex> stateGuard(_stateMutex);
+			for(std::map<int32_t, PScriptEngineClientData>::iterator i = _clients.begin(); i != _clients.end(); ++i)
+			{
+				if(i->second->closed) continue;
+				clients.push_back(i->second);
+			}
+		}
+
+		int64_t hits = 0;
+		int64_t misses = 0;
+		int32_t entries = 0;
+		int64_t size = 0;
+		if(!_shuttingDown)
+		{
+			for(std::vector<PScriptEngineClientData>::iterator i = clients.begin(); i != clients.end(); ++i)
+			{
+				BaseLib::PArray parameters(new BaseLib::Array());
+				BaseLib::PVariable response = sendRequest(*i, "getScriptCacheStatistics", parameters);
+				if(response->errorStruct) continue;
+				BaseLib::Struct::iterator element = response->structValue->find("HITS");
+				if(element != response->structValue->end()) hits += element->second->integerValue64;
+				element = response->structValue->find("MISSES");
+				if(element != response->structValue->end()) misses += element->second->integerValue64;
+				element = response->structValue->find("ENTRIES");
+				if(element != response->structValue->end()) entries += element->second->integerValue;
+				element = response->structValue->find("SIZE");
+				if(element != response->structValue->end()) size += element->second->integerValue64;
+			}
+		}
+
+		BaseLib::PVariable cache(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+		cache->structValue->insert(BaseLib::StructElement("PROCESSES", BaseLib::PVariable(new BaseLib::Variable((int32_t)clients.size()))));
+		cache->structValue->insert(BaseLib::StructElement("HITS", BaseLib::PVariable(new BaseLib::Variable(hits))));
+		cache->structValue->insert(BaseLib::StructElement("MISSES", BaseLib::PVariable(new BaseLib::Variable(misses))));
+		cache->structValue->insert(BaseLib::StructElement("HIT_RATE", BaseLib::PVariable(new BaseLib::Variable(hits + misses > 0 ? (double)hits / (double)(hits + misses) : 0.0))));
+		cache->structValue->insert(BaseLib::StructElement("ENTRIES", BaseLib::PVariable(new BaseLib::Variable(entries))));
+		cache->structValue->insert(BaseLib::StructElement("SIZE", BaseLib::PVariable(new BaseLib::Variable(size))));
+
+		BaseLib::PVariable result(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+		result->structValue->insert(BaseLib::StructElement("SCRIPTS", array));
+		result->structValue->insert(BaseLib::StructElement("SCRIPT_CACHE", cache));
+		return result;
 	}
 	catch(const std::exception& ex)
 	{
@@ -34,6 +34,7 @@
 #include "php_config_fixes.h"
 #include "ScriptEngineProcess.h"
 #include "../RPC/RPCMethod.h"
+#include "../RPC/RpcMethodTable.h"
 #include "homegear-base/BaseLib.h"
 
 #include <sys/types.h>
@@ -72,7 +73,7 @@ public:
 	void broadcastDeleteDevices(BaseLib::PVariable deviceInfo);
 	void broadcastUpdateDevice(uint64_t id, int32_t channel, int32_t hint);
 
-	BaseLib::PVariable getAllScripts();
+	BaseLib::PVariable getAllScripts(bool returnStatistics = false);
 private:
 	class QueueEntry : public BaseLib::IQueueEntry
 	{
@@ -87,6 +88,7 @@ private:
 	};
 
 	BaseLib::Output _out;
+	Metrics::PQueueDepth _queueDepth;
 	std::string _socketPath;
 	bool _shuttingDown = false;
 	bool _stopServer = false;
@@ -103,12 +105,29 @@ private:
 	int32_t _currentClientId = 0;
 	int64_t _lastGargabeCollection = 0;
 	std::shared_ptr<BaseLib::RpcClientInfo> _dummyClientInfo;
-	std::map<std::string, std::shared_ptr<RPC::RPCMethod>> _rpcMethods;
+	RPC::RpcMethodTable _rpcMethods;
+	RPC::RpcStatistics::PCallStatistics _statistics;
 	std::map<std::string, std::function<BaseLib::PVariable(PScriptEngineClientData& clientData, int32_t scriptId, BaseLib::PArray& parameters)>> _localRpcMethods;
 	std::mutex _packetIdMutex;
 	int32_t _currentPacketId = 0;
-	std::mutex _checkSessionIdMutex;
-	std::thread _checkSessionIdThread;
+
+	/**
+	 * Result of a session ID verification. Verifications of the same session ID are serialized on "mutex", different session IDs are verified
+	 * concurrently.
+	 */
+	struct SessionIdInfo
+	{
+		std::mutex mutex;
+		bool authorized = false;
+		int64_t expirationTime = 0;
+	};
+	typedef std::shared_ptr<SessionIdInfo> PSessionIdInfo;
+
+	const int64_t _sessionIdAuthorizedTtl = 10000;
+	const int64_t _sessionIdUnauthorizedTtl = 1000;
+	const size_t _sessionIdCacheMaxEntries = 1000;
+	std::mutex _sessionIdCacheMutex;
+	std::map<std::string, PSessionIdInfo> _sessionIdCache;
 
 	std::unique_ptr<BaseLib::RPC::RPCDecoder> _rpcDecoder;
 	std::unique_ptr<BaseLib::RPC::RPCEncoder> _rpcEncoder;
@@ -50,6 +50,7 @@ static zend_class_entry* homegear_serial_class_entry = nullptr;
 static zend_class_entry* homegear_i2c_class_entry = nullptr;
 #endif
 static zend_class_entry* homegear_exception_class_entry = nullptr;
+static size_t _outputBufferSize = 4096;
 static char* ini_path_override = nullptr;
 static char* ini_entries = nullptr;
 static const char HARDCODED_INI[] =
@@ -83,9 +84,11 @@ ZEND_FUNCTION(hg_invoke);
 ZEND_FUNCTION(hg_get_meta);
 ZEND_FUNCTION(hg_get_system);
 ZEND_FUNCTION(hg_get_value);
+ZEND_FUNCTION(hg_get_values);
 ZEND_FUNCTION(hg_set_meta);
 ZEND_FUNCTION(hg_set_system);
 ZEND_FUNCTION(hg_set_value);
+ZEND_FUNCTION(hg_set_values);
 ZEND_FUNCTION(hg_list_modules);
 ZEND_FUNCTION(hg_load_module);
 ZEND_FUNCTION(hg_unload_module);
@@ -135,9 +138,11 @@ static const zend_function_entry homegear_functions[] = {
 	ZEND_FE(hg_get_meta, NULL)
 	ZEND_FE(hg_get_system, NULL)
 	ZEND_FE(hg_get_value, NULL)
+	ZEND_FE(hg_get_values, NULL)
 	ZEND_FE(hg_set_meta, NULL)
 	ZEND_FE(hg_set_system, NULL)
 	ZEND_FE(hg_set_value, NULL)
+	ZEND_FE(hg_set_values, NULL)
 	ZEND_FE(hg_list_modules, NULL)
 	ZEND_FE(hg_load_module, NULL)
 	ZEND_FE(hg_unload_module, NULL)
@@ -185,6 +190,17 @@ static const zend_function_entry homegear_functions[] = {
 	ZVAL_NEW_STR(&tmp, zend_string_init(value, sizeof(value)-1, 1));\
 	zend_hash_str_update(configuration_hash, name, sizeof(name)-1, &tmp);\
 
+static ZEND_INI_MH(php_homegear_on_update_output_buffer_size)
+{
+	long outputBufferSize = ZEND_STRTOL(ZSTR_VAL(new_value), NULL, 10);
+	_outputBufferSize = outputBufferSize > 0 ? (size_t)outputBufferSize : 0;
+	return SUCCESS;
+}
+
+PHP_INI_BEGIN()
+	PHP_INI_ENTRY("homegear.output_buffer_size", "4096", PHP_INI_SYSTEM, php_homegear_on_update_output_buffer_size)
+PHP_INI_END()
+
 static void homegear_ini_defaults(HashTable *configuration_hash)
 {
 	zval tmp;
@@ -317,34 +333,49 @@ static char* php_homegear_read_cookies()
 
 static size_t php_homegear_ub_write_string(std::string& string)
 {
-	if(string.empty() || _disposed) return 0;
-	zend_homegear_globals* globals = php_homegear_get_globals();
-	if(globals->outputCallback) globals->outputCallback(string);
-	else
-	{
-		if(SEG(peerId) != 0) GD::out.printMessage("Script output (peer id: " + std::to_string(SEG(peerId)) + "): " + string);
-		else GD::out.printMessage("Script output: " + string);
-	}
-	return string.size();
+	return php_homegear_ub_write(string.c_str(), string.size());
 }
 
 static size_t php_homegear_ub_write(const char* str, size_t length)
 {
 	if(length == 0 || _disposed) return 0;
-	std::string output(str, length);
 	zend_homegear_globals* globals = php_homegear_get_globals();
-	if(globals->outputCallback) globals->outputCallback(output);
+	if(globals->outputCallback)
+	{
+		//Output of web requests is collected and sent in larger frames to reduce the number of packets sent to the main process.
+		if(globals->webRequest && _outputBufferSize > 0)
+		{
+			globals->outputBuffer.append(str, length);
+			if(globals->outputBuffer.size() >= _outputBufferSize) php_homegear_flush_output();
+		}
+		else
+		{
+			std::string output(str, length);
+			globals->outputCallback(output);
+		}
+	}
 	else
 	{
+		std::string output(str, length);
 		if(SEG(peerId) != 0) GD::out.printMessage("Script output (peer id: " + std::to_string(SEG(peerId)) + "): " + output);
 		else GD::out.printMessage("Script output: " + output);
 	}
 	return length;
 }
 
+void php_homegear_flush_output()
+{
+	zend_homegear_globals* globals = php_homegear_get_globals();
+	if(!globals || globals->outputBuffer.empty()) return;
+	std::string output;
+	output.swap(globals->outputBuffer);
+	if(globals->outputCallback) globals->outputCallback(output);
+}
+
 static void php_homegear_flush(void *server_context)
 {
-	//We are storing all data, so no flush is needed.
+	if(_disposed) return;
+	php_homegear_flush_output();
 }
 
 static int php_homegear_send_headers(sapi_headers_struct* sapi_headers)
@@ -652,6 +683,18 @@ ZEND_FUNCTION(hg_get_value)
 	php_homegear_invoke_rpc(methodName, parameters, return_value);
 }
 
+ZEND_FUNCTION(hg_get_values)
+{
+	if(_disposed) RETURN_NULL();
+	zval* requests = nullptr;
+	if (zend_parse_parameters(ZEND_NUM_ARGS(), "a", &requests) != SUCCESS) RETURN_NULL();
+	std::string methodName("getValues");
+	BaseLib::PVariable parameters(new BaseLib::Variable(BaseLib::VariableType::tArray));
+	BaseLib::PVariable parameter = PhpVariableConverter::getVariable(requests);
+	if(parameter) parameters->arrayValue->push_back(parameter);
+	php_homegear_invoke_rpc(methodName, parameters, return_value);
+}
+
 ZEND_FUNCTION(hg_set_meta)
 {
 	if(_disposed) RETURN_NULL();
@@ -706,6 +749,18 @@ ZEND_FUNCTION(hg_set_value)
 	php_homegear_invoke_rpc(methodName, parameters, return_value);
 }
 
+ZEND_FUNCTION(hg_set_values)
+{
+	if(_disposed) RETURN_NULL();
+	zval* requests = nullptr;
+	if (zend_parse_parameters(ZEND_NUM_ARGS(), "a", &requests) != SUCCESS) RETURN_NULL();
+	std::string methodName("setValues");
+	BaseLib::PVariable parameters(new BaseLib::Variable(BaseLib::VariableType::tArray));
+	BaseLib::PVariable parameter = PhpVariableConverter::getVariable(requests);
+	if(parameter) parameters->arrayValue->push_back(parameter);
+	php_homegear_invoke_rpc(methodName, parameters, return_value);
+}
+
 // {{{ Module functions
 	ZEND_FUNCTION(hg_list_modules)
 	{
@@ -1695,11 +1750,14 @@ static PHP_MINIT_FUNCTION(homegear)
 	homegear_i2c_class_entry = zend_register_internal_class(&homegearI2cCe);
 #endif
 
+	REGISTER_INI_ENTRIES();
+
     return SUCCESS;
 }
 
 static PHP_MSHUTDOWN_FUNCTION(homegear)
 {
+	UNREGISTER_INI_ENTRIES();
     return SUCCESS;
 }
 
@@ -74,6 +74,10 @@ typedef struct _zend_homegear_globals
 	std::string token;
 	bool executionStarted = false;
 	// }}}
+
+	// {{{ Output buffering of web requests
+	std::string outputBuffer;
+	// }}}
 } zend_homegear_globals;
 
 typedef struct _zend_homegear_superglobals
@@ -86,6 +90,7 @@ typedef struct _zend_homegear_superglobals
 
 zend_homegear_globals* php_homegear_get_globals();
 void php_homegear_build_argv(std::vector<std::string>& arguments);
+void php_homegear_flush_output();
 int php_homegear_init();
 void php_homegear_shutdown();
 
@@ -32,6 +32,13 @@
 #include "../User/User.h"
 #include "../GD/GD.h"
 
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 DatabaseController::DatabaseController()
 {
 
@@ -46,6 +53,8 @@ void DatabaseController::dispose()
 {
 	if(_disposing) return;
 	_disposing = true;
+	GD::metrics.unregisterGaugeCallback("homegear_database_queue_depth");
+	_systemVariableNotifier.stop();
 	_queueMutex.lock();
 	//Make sure, bufferedWrite is finished
 	_queueMutex.unlock();
@@ -54,9 +63,19 @@ void DatabaseController::dispose()
 	_queueConditionVariable.notify_one();
 	GD::bl->threadManager.join(_queueProcessingThread);
 	for(int32_t i = 0; i < _queueSize; ++i) _queue[i].reset(); //Just to make sure there are no valid shared pointers anymore
+	//All queued writes are finished now, so the snapshot matches the database.
+	if(GD::peerSnapshot && _db.isOpen()) writePeerSnapshot();
 	_db.dispose();
-	_systemVariables.clear();
+	for(int32_t i = 0; i < _systemVariableShardCount; i++)
+	{
+		std::lock_guard<std::mutex> shardGuard(_systemVariableShards[i].mutex);
+		_systemVariableShards[i].variables.clear();
+	}
+	_systemVariableCount = 0;
+	_queuedSystemVariables.clear();
 	_metadata.clear();
+	_metadataPreloaded = false;
+	_metadataCacheSize = 0;
 }
 
 void DatabaseController::init()
@@ -73,7 +92,15 @@ void DatabaseController::init()
 	_queueEntryAvailable = false;
 	_queueHead = 0;
 	_queueTail = 0;
+	_writeDuration = GD::metrics.histogram("homegear_database_write_duration_seconds", "Execution time of queued database writes.");
+	GD::metrics.registerGaugeCallback("homegear_database_queue_depth", "Number of writes waiting in the database queue.", [this]()
+	{
+		int32_t queueSize = _queueSize;
+		std::lock_guard<std::mutex> queueGuard(_queueMutex);
+		return (int64_t)((_queueHead - _queueTail + queueSize) % queueSize);
+	});
 	GD::bl->threadManager.start(_queueProcessingThread, true, &DatabaseController::processQueueEntry, this);
+	_systemVariableNotifier.start();
 }
 
 //General
@@ -92,29 +119,29 @@ void DatabaseController::initializeDatabase()
 	try
 	{
 		_db.executeCommand("CREATE TABLE IF NOT EXISTS homegearVariables (variableID INTEGER PRIMARY KEY UNIQUE, variableIndex INTEGER NOT NULL, integerValue INTEGER, stringValue TEXT, binaryValue BLOB)");
-		_db.executeCommand("CREATE INDEX IF NOT EXISTS homegearVariablesIndex ON homegearVariables (variableID, variableIndex)");
+		_db.executeCommand("CREATE INDEX IF NOT EXISTS homegearVariablesIndexIndex ON homegearVariables (variableIndex)");
 		_db.executeCommand("CREATE TABLE IF NOT EXISTS peers (peerID INTEGER PRIMARY KEY UNIQUE, parent INTEGER NOT NULL, address INTEGER NOT NULL, serialNumber TEXT NOT NULL, type INTEGER NOT NULL)");
-		_db.executeCommand("CREATE INDEX IF NOT EXISTS peersIndex ON peers (peerID, parent, address, serialNumber, type)");
+		_db.executeCommand("CREATE INDEX IF NOT EXISTS peersParentIndex ON peers (parent)");
 		_db.executeCommand("CREATE TABLE IF NOT EXISTS peerVariables (variableID INTEGER PRIMARY KEY UNIQUE, peerID INTEGER NOT NULL, variableIndex INTEGER NOT NULL, integerValue INTEGER, stringValue TEXT, binaryValue BLOB)");
-		_db.executeCommand("CREATE INDEX IF NOT EXISTS peerVariablesIndex ON peerVariables (variableID, peerID, variableIndex)");
+		_db.executeCommand("CREATE INDEX IF NOT EXISTS peerVariablesPeerIndex ON peerVariables (peerID, variableIndex)");
 		_db.executeCommand("CREATE TABLE IF NOT EXISTS serviceMessages (variableID INTEGER PRIMARY KEY UNIQUE, peerID INTEGER NOT NULL, variableIndex INTEGER NOT NULL, integerValue INTEGER, stringValue TEXT, binaryValue BLOB)");
-		_db.executeCommand("CREATE INDEX IF NOT EXISTS serviceMessagesIndex ON peerVariables (variableID, peerID, variableIndex)");
+		_db.executeCommand("CREATE INDEX IF NOT EXISTS serviceMessagesPeerIndex ON serviceMessages (peerID, variableIndex)");
 		_db.executeCommand("CREATE TABLE IF NOT EXISTS parameters (parameterID INTEGER PRIMARY KEY UNIQUE, peerID INTEGER NOT NULL, parameterSetType INTEGER NOT NULL, peerChannel INTEGER NOT NULL, remotePeer INTEGER, remoteChannel INTEGER, parameterName TEXT, value BLOB)");
-		_db.executeCommand("CREATE INDEX IF NOT EXISTS parametersIndex ON parameters (parameterID, peerID, parameterSetType, peerChannel, remotePeer, remoteChannel, parameterName)");
+		_db.executeCommand("CREATE INDEX IF NOT EXISTS parametersPeerIndex ON parameters (peerID, parameterSetType, peerChannel, remotePeer, remoteChannel, parameterName)");
 		_db.executeCommand("CREATE TABLE IF NOT EXISTS metadata (objectID TEXT, dataID TEXT, serializedObject BLOB)");
 		_db.executeCommand("CREATE INDEX IF NOT EXISTS metadataIndex ON metadata (objectID, dataID)");
 		_db.executeCommand("CREATE TABLE IF NOT EXISTS systemVariables (variableID TEXT, serializedObject BLOB)");
-		_db.executeCommand("CREATE INDEX IF NOT EXISTS systemVariablesIndex ON systemVariables (variableID)");
+		_db.executeCommand("CREATE UNIQUE INDEX IF NOT EXISTS systemVariablesIDIndex ON systemVariables (variableID)");
 		_db.executeCommand("CREATE TABLE IF NOT EXISTS devices (deviceID INTEGER PRIMARY KEY UNIQUE, address INTEGER NOT NULL, serialNumber TEXT NOT NULL, deviceType INTEGER NOT NULL, deviceFamily INTEGER NOT NULL)");
-		_db.executeCommand("CREATE INDEX IF NOT EXISTS devicesIndex ON devices (deviceID, address, deviceType, deviceFamily)");
+		_db.executeCommand("CREATE INDEX IF NOT EXISTS devicesFamilyIndex ON devices (deviceFamily)");
 		_db.executeCommand("CREATE TABLE IF NOT EXISTS deviceVariables (variableID INTEGER PRIMARY KEY UNIQUE, deviceID INTEGER NOT NULL, variableIndex INTEGER NOT NULL, integerValue INTEGER, stringValue TEXT, binaryValue BLOB)");
-		_db.executeCommand("CREATE INDEX IF NOT EXISTS deviceVariablesIndex ON deviceVariables (variableID, deviceID, variableIndex)");
+		_db.executeCommand("CREATE INDEX IF NOT EXISTS deviceVariablesDeviceIndex ON deviceVariables (deviceID, variableIndex)");
 		_db.executeCommand("CREATE TABLE IF NOT EXISTS licenseVariables (variableID INTEGER PRIMARY KEY UNIQUE, moduleID INTEGER NOT NULL, variableIndex INTEGER NOT NULL, integerValue INTEGER, stringValue TEXT, binaryValue BLOB)");
-		_db.executeCommand("CREATE INDEX IF NOT EXISTS licenseVariablesIndex ON licenseVariables (variableID, moduleID, variableIndex)");
+		_db.executeCommand("CREATE INDEX IF NOT EXISTS licenseVariablesModuleIndex ON licenseVariables (moduleID, variableIndex)");
 		_db.executeCommand("CREATE TABLE IF NOT EXISTS users (userID INTEGER PRIMARY KEY UNIQUE, name TEXT NOT NULL, password BLOB NOT NULL, salt BLOB NOT NULL)");
-		_db.executeCommand("CREATE INDEX IF NOT EXISTS usersIndex ON users (userID, name)");
+		_db.executeCommand("CREATE INDEX IF NOT EXISTS usersNameIndex ON users (name)");
 		_db.executeCommand("CREATE TABLE IF NOT EXISTS events (eventID INTEGER PRIMARY KEY UNIQUE, name TEXT NOT NULL, type INTEGER NOT NULL, peerID INTEGER, peerChannel INTEGER, variable TEXT, trigger INTEGER, triggerValue BLOB, eventMethod TEXT, eventMethodParameters BLOB, resetAfter INTEGER, initialTime INTEGER, timeOperation INTEGER, timeFactor REAL, timeLimit INTEGER, resetMethod TEXT, resetMethodParameters BLOB, eventTime INTEGER, endTime INTEGER, recurEvery INTEGER, lastValue BLOB, lastRaised INTEGER, lastReset INTEGER, currentTime INTEGER, enabled INTEGER)");
-		_db.executeCommand("CREATE INDEX IF NOT EXISTS eventsIndex ON events (eventID, name, type, peerID, peerChannel)");
+		_db.executeCommand("CREATE INDEX IF NOT EXISTS eventsNameIndex ON events (name)");
 
 		BaseLib::Database::DataRow data;
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(0)));
@@ -125,7 +152,7 @@ void DatabaseController::initializeDatabase()
 			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn()));
 			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(0)));
 			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn()));
-			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn("0.6.1")));
+			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn("0.7.1")));
 			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn()));
 			_db.executeCommand("INSERT INTO homegearVariables VALUES(?, ?, ?, ?, ?)", data);
 
@@ -135,6 +162,10 @@ void DatabaseController::initializeDatabase()
 			std::string userName("homegear");
 			createUser(userName, passwordHash, salt);
 		}
+
+		loadPeerSnapshot();
+		preloadMetadata();
+		loadSystemVariables();
 	}
 	catch(const std::exception& ex)
     {
@@ -150,35 +181,75 @@ void DatabaseController::initializeDatabase()
     }
 }
 
-void DatabaseController::bufferedWrite(std::string command, BaseLib::Database::DataRow& data)
+std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>> DatabaseController::enqueue(std::string& command, BaseLib::Database::DataRow& data)
+{
+	if(_disposing) return std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>>();
+	int32_t tempHead = _queueHead + 1;
+	if(tempHead >= _queueSize) tempHead = 0;
+	if(tempHead == _queueTail)
+	{
+		GD::out.printError("Error: More than " + std::to_string(_queueSize) + " entries are queued to be written into the database. Your data processing is too slow. Not writing entry.");
+		return std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>>();
+	}
+
+	std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>> entry(new std::pair<std::string, BaseLib::Database::DataRow>(command, data));
+	_queue[_queueHead] = entry;
+	_queueHead++;
+	if(_queueHead >= _queueSize)
+	{
+		_queueHead = 0;
+	}
+	_queueEntryAvailable = true;
+	return entry;
+}
+
+std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>> DatabaseController::bufferedWrite(std::string command, BaseLib::Database::DataRow& data)
 {
 	try
 	{
 		_queueMutex.lock();
-		if(_disposing)
-		{
-			_queueMutex.unlock();
-			return;
-		}
-		int32_t tempHead = _queueHead + 1;
-		if(tempHead >= _queueSize) tempHead = 0;
-		if(tempHead == _queueTail)
-		{
-			GD::out.printError("Error: More than " + std::to_string(_queueSize) + " entries are queued to be written into the database. Your data processing is too slow. Not writing entry.");
-			_queueMutex.unlock();
-			return;
-		}
+		std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>> entry = enqueue(command, data);
+		_queueMutex.unlock();
+
+		if(entry) _queueConditionVariable.notify_one();
+		return entry;
+	}
+    catch(const std::exception& ex)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(const BaseLib::Exception& ex)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>>();
+}
 
-		_queue[_queueHead] = std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>>(new std::pair<std::string, BaseLib::Database::DataRow>(command, data));
-		_queueHead++;
-		if(_queueHead >= _queueSize)
+void DatabaseController::bufferedSystemVariableWrite(const std::string& variableID, BaseLib::Database::DataRow& data)
+{
+	try
+	{
+		std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>> entry;
 		{
-			_queueHead = 0;
+			std::lock_guard<std::mutex> queueGuard(_queueMutex);
+			std::map<std::string, std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>>>::iterator systemVariableIterator = _queuedSystemVariables.find(variableID);
+			if(systemVariableIterator != _queuedSystemVariables.end())
+			{
+				//The previous value wasn't written yet, so only the new one needs to be written.
+				systemVariableIterator->second->second = data;
+				return;
+			}
+
+			std::string command("INSERT OR REPLACE INTO systemVariables VALUES(?, ?)");
+			entry = enqueue(command, data);
+			if(entry) _queuedSystemVariables[variableID] = entry;
 		}
-		_queueEntryAvailable = true;
-		_queueMutex.unlock();
 
-		_queueConditionVariable.notify_one();
+		if(entry) _queueConditionVariable.notify_one();
 	}
     catch(const std::exception& ex)
     {
@@ -217,8 +288,19 @@ void DatabaseController::processQueueEntry()
 				_queueTail++;
 				if(_queueTail >= _queueSize) _queueTail = 0;
 				if(_queueHead == _queueTail) _queueEntryAvailable = false; //Set here, because otherwise it might be set to "true" in raisePacketReceived and then set to false again after the while loop
+				if(entry && !_queuedSystemVariables.empty() && !entry->second.empty())
+				{
+					//The entry can't be changed anymore once it is taken from the queue.
+					std::map<std::string, std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>>>::iterator systemVariableIterator = _queuedSystemVariables.find(entry->second.at(0)->textValue);
+					if(systemVariableIterator != _queuedSystemVariables.end() && systemVariableIterator->second == entry) _queuedSystemVariables.erase(systemVariableIterator);
+				}
 				_queueMutex.unlock();
-				if(entry) _db.executeWriteCommand(entry);
+				if(entry)
+				{
+					int64_t startTime = Metrics::getTime();
+					_db.executeWriteCommand(entry);
+					_writeDuration->record(Metrics::getTime() - startTime);
+				}
 			}
 		}
 		catch(const std::exception& ex)
@@ -252,8 +334,8 @@ bool DatabaseController::convertDatabase()
 		std::shared_ptr<BaseLib::Database::DataTable> result = _db.executeCommand("SELECT * FROM homegearVariables WHERE variableIndex=?", data);
 		if(result->empty()) return false; //Handled in initializeDatabase
 		std::string version = result->at(0).at(3)->textValue;
-		if(version == "0.6.1") return false; //Up to date
-		if(version != "0.3.1" && version != "0.4.3" && version != "0.5.0" && version != "0.5.1" && version != "0.6.0")
+		if(version == "0.7.1") return false; //Up to date
+		if(version != "0.3.1" && version != "0.4.3" && version != "0.5.0" && version != "0.5.1" && version != "0.6.0" && version != "0.6.1" && version != "0.7.0")
 		{
 			GD::out.printCritical("Critical: Unknown database version: " + version);
 			return true; //Don't know, what to do
@@ -408,6 +490,69 @@ bool DatabaseController::convertDatabase()
 			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn()));
 			_db.executeWriteCommand("REPLACE INTO homegearVariables VALUES(?, ?, ?, ?, ?)", data);
 
+			GD::out.printMessage("Exiting Homegear after database conversion...");
+			return true;
+		}
+		else if(version == "0.6.1")
+		{
+			GD::out.printMessage("Converting database from version " + version + " to version 0.7.0...");
+			_db.init(GD::bl->settings.databasePath(), GD::bl->settings.databaseSynchronous(), GD::bl->settings.databaseMemoryJournal(), GD::bl->settings.databaseWALJournal(), GD::bl->settings.databasePath() + ".0.6.1.old");
+
+			//The old indexes start with the primary key, so they can't be used for lookups by peer, parent, device or module and only slow down writes. "serviceMessagesIndex" was created on the wrong table.
+			_db.executeCommand("DROP INDEX IF EXISTS homegearVariablesIndex");
+			_db.executeCommand("DROP INDEX IF EXISTS peersIndex");
+			_db.executeCommand("DROP INDEX IF EXISTS peerVariablesIndex");
+			_db.executeCommand("DROP INDEX IF EXISTS serviceMessagesIndex");
+			_db.executeCommand("DROP INDEX IF EXISTS parametersIndex");
+			_db.executeCommand("DROP INDEX IF EXISTS devicesIndex");
+			_db.executeCommand("DROP INDEX IF EXISTS deviceVariablesIndex");
+			_db.executeCommand("DROP INDEX IF EXISTS licenseVariablesIndex");
+			_db.executeCommand("DROP INDEX IF EXISTS usersIndex");
+			_db.executeCommand("DROP INDEX IF EXISTS eventsIndex");
+
+			_db.executeCommand("CREATE INDEX IF NOT EXISTS homegearVariablesIndexIndex ON homegearVariables (variableIndex)");
+			_db.executeCommand("CREATE INDEX IF NOT EXISTS peersParentIndex ON peers (parent)");
+			_db.executeCommand("CREATE INDEX IF NOT EXISTS peerVariablesPeerIndex ON peerVariables (peerID, variableIndex)");
+			_db.executeCommand("CREATE INDEX IF NOT EXISTS serviceMessagesPeerIndex ON serviceMessages (peerID, variableIndex)");
+			_db.executeCommand("CREATE INDEX IF NOT EXISTS parametersPeerIndex ON parameters (peerID, parameterSetType, peerChannel, remotePeer, remoteChannel, parameterName)");
+			_db.executeCommand("CREATE INDEX IF NOT EXISTS devicesFamilyIndex ON devices (deviceFamily)");
+			_db.executeCommand("CREATE INDEX IF NOT EXISTS deviceVariablesDeviceIndex ON deviceVariables (deviceID, variableIndex)");
+			_db.executeCommand("CREATE INDEX IF NOT EXISTS licenseVariablesModuleIndex ON licenseVariables (moduleID, variableIndex)");
+			_db.executeCommand("CREATE INDEX IF NOT EXISTS usersNameIndex ON users (name)");
+			_db.executeCommand("CREATE INDEX IF NOT EXISTS eventsNameIndex ON events (name)");
+			_db.executeCommand("ANALYZE");
+
+			data.clear();
+			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(result->at(0).at(0)->intValue)));
+			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(0)));
+			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn()));
+			//Don't forget to set new version in initializeDatabase!!!
+			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn("0.7.0")));
+			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn()));
+			_db.executeWriteCommand("REPLACE INTO homegearVariables VALUES(?, ?, ?, ?, ?)", data);
+
+			GD::out.printMessage("Exiting Homegear after database conversion...");
+			return true;
+		}
+		else if(version == "0.7.0")
+		{
+			GD::out.printMessage("Converting database from version " + version + " to version 0.7.1...");
+			_db.init(GD::bl->settings.databasePath(), GD::bl->settings.databaseSynchronous(), GD::bl->settings.databaseMemoryJournal(), GD::bl->settings.databaseWALJournal(), GD::bl->settings.databasePath() + ".0.7.0.old");
+
+			//System variables are written with "INSERT OR REPLACE" now, which needs a unique index. Keep the newest row of duplicates left over from interrupted "DELETE" and "INSERT" pairs.
+			_db.executeCommand("DELETE FROM systemVariables WHERE rowid NOT IN (SELECT MAX(rowid) FROM systemVariables GROUP BY variableID)");
+			_db.executeCommand("DROP INDEX IF EXISTS systemVariablesIndex");
+			_db.executeCommand("CREATE UNIQUE INDEX IF NOT EXISTS systemVariablesIDIndex ON systemVariables (variableID)");
+
+			data.clear();
+			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(result->at(0).at(0)->intValue)));
+			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(0)));
+			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn()));
+			//Don't forget to set new version in initializeDatabase!!!
+			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn("0.7.1")));
+			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn()));
+			_db.executeWriteCommand("REPLACE INTO homegearVariables VALUES(?, ?, ?, ?, ?)", data);
+
 			GD::out.printMessage("Exiting Homegear after database conversion...");
 			return true;
 		}
@@ -497,26 +642,193 @@ void DatabaseController::setHomegearVariableString(HomegearVariables::Enum id, s
 //End Homegear variables
 
 //Metadata
+void DatabaseController::preloadMetadata()
+{
+	try
+	{
+		std::lock_guard<std::mutex> metadataGuard(_metadataMutex);
+		_metadata.clear();
+		_metadataPreloaded = false;
+		_metadataCacheSize = 0;
+		_metadataCount = 0;
+
+		std::shared_ptr<BaseLib::Database::DataTable> rows = _db.executeCommand("SELECT COUNT(*), SUM(LENGTH(dataID) + LENGTH(serializedObject)) FROM metadata");
+		if(rows->empty() || rows->at(0).size() < 2) return;
+		int64_t count = rows->at(0).at(0)->intValue;
+		int64_t size = rows->at(0).at(1)->intValue;
+		if(size > GD::metadataCacheSize)
+		{
+			GD::out.printInfo("Info: Metadata needs " + std::to_string(size) + " bytes which is more than the cache limit of " + std::to_string(GD::metadataCacheSize) + " bytes. Loading metadata on demand.");
+			return;
+		}
+
+		int64_t startTime = BaseLib::HelperFunctions::getTime();
+		rows = _db.executeCommand("SELECT objectID, dataID, serializedObject FROM metadata");
+		for(BaseLib::Database::DataTable::iterator i = rows->begin(); i != rows->end(); ++i)
+		{
+			if(i->second.size() < 3 || !i->second.at(2)->binaryValue) continue;
+			uint64_t peerID = std::strtoull(i->second.at(0)->textValue.c_str(), nullptr, 10);
+			CachedMetadata& entry = _metadata[peerID][i->second.at(1)->textValue];
+			entry.value = _rpcDecoder->decodeResponse(*i->second.at(2)->binaryValue);
+			entry.size = i->second.at(1)->textValue.size() + i->second.at(2)->binaryValue->size();
+			_metadataCacheSize += entry.size;
+		}
+		_metadataCount = count;
+		_metadataPreloaded = true;
+		GD::out.printInfo("Info: Loaded " + std::to_string(count) + " metadata entries (" + std::to_string(_metadataCacheSize) + " bytes) in " + std::to_string(BaseLib::HelperFunctions::getTime() - startTime) + " ms.");
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+void DatabaseController::cacheMetadata(uint64_t peerID, const std::string& dataID, BaseLib::PVariable& metadata, int64_t size, bool force)
+{
+	try
+	{
+		std::map<uint64_t, std::map<std::string, CachedMetadata>>::iterator peerIterator = _metadata.find(peerID);
+		if(peerIterator != _metadata.end())
+		{
+			std::map<std::string, CachedMetadata>::iterator dataIterator = peerIterator->second.find(dataID);
+			if(dataIterator != peerIterator->second.end())
+			{
+				//Cached entries are at least as new as the database, so only written entries replace them.
+				if(!force) return;
+				_metadataCacheSize += size - dataIterator->second.size;
+				dataIterator->second.value = metadata;
+				dataIterator->second.size = size;
+				return;
+			}
+		}
+
+		if(_metadataCacheSize + size > GD::metadataCacheSize)
+		{
+			if(_metadataPreloaded)
+			{
+				GD::out.printInfo("Info: Metadata cache limit of " + std::to_string(GD::metadataCacheSize) + " bytes reached. Loading metadata on demand from now on.");
+				_metadataPreloaded = false;
+			}
+			if(!force) return;
+			evictMetadata(size, peerID, dataID);
+		}
+
+		CachedMetadata& entry = _metadata[peerID][dataID];
+		entry.value = metadata;
+		entry.size = size;
+		_metadataCacheSize += size;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+void DatabaseController::evictMetadata(int64_t size, uint64_t peerID, const std::string& dataID)
+{
+	try
+	{
+		for(std::map<uint64_t, std::map<std::string, CachedMetadata>>::iterator i = _metadata.begin(); i != _metadata.end() && _metadataCacheSize + size > GD::metadataCacheSize;)
+		{
+			for(std::map<std::string, CachedMetadata>::iterator j = i->second.begin(); j != i->second.end() && _metadataCacheSize + size > GD::metadataCacheSize;)
+			{
+				//Entries with queued writes are kept, otherwise reads would return the old value from the database.
+				if((i->first == peerID && j->first == dataID) || !j->second.pendingWrite.expired())
+				{
+					++j;
+					continue;
+				}
+				_metadataCacheSize -= j->second.size;
+				j = i->second.erase(j);
+			}
+			if(i->second.empty()) i = _metadata.erase(i);
+			else ++i;
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+bool DatabaseController::canCacheReadMetadata(uint64_t changes)
+{
+	return changes == _metadataChanges && _lastMetadataRemoval.expired();
+}
+
 BaseLib::PVariable DatabaseController::getAllMetadata(uint64_t peerID)
 {
 	try
 	{
+		BaseLib::PVariable metadataStruct(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+		uint64_t changes = 0;
+
+		{
+			std::lock_guard<std::mutex> metadataGuard(_metadataMutex);
+			changes = _metadataChanges;
+			if(_metadataPreloaded)
+			{
+				std::map<uint64_t, std::map<std::string, CachedMetadata>>::iterator peerIterator = _metadata.find(peerID);
+				if(peerIterator != _metadata.end())
+				{
+					for(std::map<std::string, CachedMetadata>::iterator i = peerIterator->second.begin(); i != peerIterator->second.end(); ++i)
+					{
+						metadataStruct->structValue->insert(BaseLib::StructElement(i->first, i->second.value));
+					}
+				}
+				return metadataStruct;
+			}
+		}
+
 		BaseLib::Database::DataRow data;
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(std::to_string(peerID))));
 
 		std::shared_ptr<BaseLib::Database::DataTable> rows = _db.executeCommand("SELECT dataID, serializedObject FROM metadata WHERE objectID=?", data);
 
-		BaseLib::PVariable metadataStruct(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+		std::lock_guard<std::mutex> metadataGuard(_metadataMutex);
+		//Cached entries might not be written yet, so they take precedence over the database.
+		std::map<uint64_t, std::map<std::string, CachedMetadata>>::iterator peerIterator = _metadata.find(peerID);
+		if(peerIterator != _metadata.end())
+		{
+			for(std::map<std::string, CachedMetadata>::iterator i = peerIterator->second.begin(); i != peerIterator->second.end(); ++i)
+			{
+				metadataStruct->structValue->insert(BaseLib::StructElement(i->first, i->second.value));
+			}
+		}
+		bool fillCache = canCacheReadMetadata(changes);
 		for(BaseLib::Database::DataTable::iterator i = rows->begin(); i != rows->end(); ++i)
 		{
 			if(i->second.size() < 2) continue;
+			if(metadataStruct->structValue->find(i->second.at(0)->textValue) != metadataStruct->structValue->end()) continue;
 			BaseLib::PVariable metadata = _rpcDecoder->decodeResponse(*i->second.at(1)->binaryValue);
 			metadataStruct->structValue->insert(BaseLib::StructElement(i->second.at(0)->textValue, metadata));
+			if(fillCache) cacheMetadata(peerID, i->second.at(0)->textValue, metadata, i->second.at(0)->textValue.size() + i->second.at(1)->binaryValue->size());
 		}
 
-		//getAllMetadata is called repetitively for all central peers. That takes a lot of ressources, so we wait a little after each call.
-		std::this_thread::sleep_for(std::chrono::milliseconds(3));
-
 		return metadataStruct;
 	}
 	catch(const std::exception& ex)
@@ -540,20 +852,18 @@ BaseLib::PVariable DatabaseController::getMetadata(uint64_t peerID, std::string&
 	{
 		if(dataID.size() > 250) return BaseLib::Variable::createError(-32602, "dataID has more than 250 characters.");
 
-		BaseLib::PVariable metadata;
-		_metadataMutex.lock();
-		std::map<uint64_t, std::map<std::string, BaseLib::PVariable>>::iterator peerIterator = _metadata.find(peerID);
-		if(peerIterator != _metadata.end())
+		uint64_t changes = 0;
 		{
-			std::map<std::string, BaseLib::PVariable>::iterator dataIterator = peerIterator->second.find(dataID);
-			if(dataIterator != peerIterator->second.end())
+			std::lock_guard<std::mutex> metadataGuard(_metadataMutex);
+			changes = _metadataChanges;
+			std::map<uint64_t, std::map<std::string, CachedMetadata>>::iterator peerIterator = _metadata.find(peerID);
+			if(peerIterator != _metadata.end())
 			{
-				 metadata = dataIterator->second;
-				_metadataMutex.unlock();
-				return metadata;
+				std::map<std::string, CachedMetadata>::iterator dataIterator = peerIterator->second.find(dataID);
+				if(dataIterator != peerIterator->second.end()) return dataIterator->second.value;
 			}
+			if(_metadataPreloaded) return BaseLib::Variable::createError(-1, "No metadata found.");
 		}
-		_metadataMutex.unlock();
 
 		BaseLib::Database::DataRow data;
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(std::to_string(peerID))));
@@ -565,10 +875,9 @@ BaseLib::PVariable DatabaseController::getMetadata(uint64_t peerID, std::string&
 			return BaseLib::Variable::createError(-1, "No metadata found.");
 		}
 
-		metadata = _rpcDecoder->decodeResponse(*rows->at(0).at(0)->binaryValue);
-		_metadataMutex.lock();
-		_metadata[peerID][dataID] = metadata;
-		_metadataMutex.unlock();
+		BaseLib::PVariable metadata = _rpcDecoder->decodeResponse(*rows->at(0).at(0)->binaryValue);
+		std::lock_guard<std::mutex> metadataGuard(_metadataMutex);
+		if(canCacheReadMetadata(changes)) cacheMetadata(peerID, dataID, metadata, dataID.size() + rows->at(0).at(0)->binaryValue->size());
 		return metadata;
 	}
 	catch(const std::exception& ex)
@@ -596,34 +905,65 @@ BaseLib::PVariable DatabaseController::setMetadata(uint64_t peerID, std::string&
 		if(metadata->stringValue.size() > 1000) return BaseLib::Variable::createError(-32602, "Data has more than 1000 characters.");
 		if(metadata->type != BaseLib::VariableType::tBase64 && metadata->type != BaseLib::VariableType::tString && metadata->type != BaseLib::VariableType::tInteger && metadata->type != BaseLib::VariableType::tFloat && metadata->type != BaseLib::VariableType::tBoolean && metadata->type != BaseLib::VariableType::tStruct && metadata->type != BaseLib::VariableType::tArray) return BaseLib::Variable::createError(-32602, "Type " + BaseLib::Variable::getTypeString(metadata->type) + " is currently not supported.");
 
-		std::shared_ptr<BaseLib::Database::DataTable> rows = _db.executeCommand("SELECT COUNT(*) FROM metadata");
-		if(rows->size() == 0 || rows->at(0).size() == 0)
+		std::vector<char> value;
+		_rpcEncoder->encodeResponse(metadata, value);
+		if(value.size() > 1000)
 		{
-			return BaseLib::Variable::createError(-32500, "Error counting metadata in database.");
+			return BaseLib::Variable::createError(-32602, "Data is larger than 1000 bytes.");
 		}
-		if(rows->at(0).at(0)->intValue > 1000000)
+
+		bool preloaded = false;
 		{
-			return BaseLib::Variable::createError(-32500, "Reached limit of 1000000 metadata entries. Please delete metadata before adding new entries.");
+			std::lock_guard<std::mutex> metadataGuard(_metadataMutex);
+			preloaded = _metadataPreloaded;
+			if(preloaded)
+			{
+				std::map<uint64_t, std::map<std::string, CachedMetadata>>::iterator peerIterator = _metadata.find(peerID);
+				bool exists = peerIterator != _metadata.end() && peerIterator->second.find(dataID) != peerIterator->second.end();
+				if(!exists)
+				{
+					if(_metadataCount >= 1000000) return BaseLib::Variable::createError(-32500, "Reached limit of 1000000 metadata entries. Please delete metadata before adding new entries.");
+					_metadataCount++;
+				}
+				_metadataChanges++;
+				cacheMetadata(peerID, dataID, metadata, dataID.size() + value.size(), true);
+			}
 		}
 
-		_metadataMutex.lock();
-		_metadata[peerID][dataID] = metadata;
-		_metadataMutex.unlock();
+		if(!preloaded)
+		{
+			std::shared_ptr<BaseLib::Database::DataTable> rows = _db.executeCommand("SELECT COUNT(*) FROM metadata");
+			if(rows->size() == 0 || rows->at(0).size() == 0)
+			{
+				return BaseLib::Variable::createError(-32500, "Error counting metadata in database.");
+			}
+			if(rows->at(0).at(0)->intValue > 1000000)
+			{
+				return BaseLib::Variable::createError(-32500, "Reached limit of 1000000 metadata entries. Please delete metadata before adding new entries.");
+			}
+
+			std::lock_guard<std::mutex> metadataGuard(_metadataMutex);
+			_metadataChanges++;
+			cacheMetadata(peerID, dataID, metadata, dataID.size() + value.size(), true);
+		}
 
 		BaseLib::Database::DataRow data;
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(std::to_string(peerID))));
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(dataID)));
 		bufferedWrite("DELETE FROM metadata WHERE objectID=? AND dataID=?", data);
 
-		std::vector<char> value;
-		_rpcEncoder->encodeResponse(metadata, value);
-		if(value.size() > 1000)
+		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(value)));
+		std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>> write = bufferedWrite("INSERT INTO metadata VALUES(?, ?, ?)", data);
+		if(write)
 		{
-			return BaseLib::Variable::createError(-32602, "Data is larger than 1000 bytes.");
+			std::lock_guard<std::mutex> metadataGuard(_metadataMutex);
+			std::map<uint64_t, std::map<std::string, CachedMetadata>>::iterator peerIterator = _metadata.find(peerID);
+			if(peerIterator != _metadata.end())
+			{
+				std::map<std::string, CachedMetadata>::iterator dataIterator = peerIterator->second.find(dataID);
+				if(dataIterator != peerIterator->second.end()) dataIterator->second.pendingWrite = write;
+			}
 		}
-		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(value)));
-
-		bufferedWrite("INSERT INTO metadata VALUES(?, ?, ?)", data);
 
 #ifdef EVENTHANDLER
 		GD::eventHandler->trigger(peerID, -1, dataID, metadata);
@@ -655,17 +995,6 @@ BaseLib::PVariable DatabaseController::deleteMetadata(uint64_t peerID, std::stri
 	{
 		if(dataID.size() > 250) return BaseLib::Variable::createError(-32602, "dataID has more than 250 characters.");
 
-		_metadataMutex.lock();
-		if(dataID.empty())
-		{
-			if(_metadata.find(peerID) != _metadata.end()) _metadata.erase(peerID);
-		}
-		else
-		{
-			if(_metadata.find(peerID) != _metadata.end() && _metadata[peerID].find(dataID) != _metadata[peerID].end()) _metadata[peerID].erase(dataID);
-		}
-		_metadataMutex.unlock();
-
 		BaseLib::Database::DataRow data;
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(std::to_string(peerID))));
 		std::string command("DELETE FROM metadata WHERE objectID=?");
@@ -674,7 +1003,39 @@ BaseLib::PVariable DatabaseController::deleteMetadata(uint64_t peerID, std::stri
 			data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(dataID)));
 			command.append(" AND dataID=?");
 		}
-		bufferedWrite(command, data);
+		//Queue the write first, so reads running in parallel don't cache the deleted entries.
+		std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>> write = bufferedWrite(command, data);
+
+		{
+			std::lock_guard<std::mutex> metadataGuard(_metadataMutex);
+			_metadataChanges++;
+			if(write) _lastMetadataRemoval = write;
+			std::map<uint64_t, std::map<std::string, CachedMetadata>>::iterator peerIterator = _metadata.find(peerID);
+			if(peerIterator != _metadata.end())
+			{
+				if(dataID.empty())
+				{
+					for(std::map<std::string, CachedMetadata>::iterator i = peerIterator->second.begin(); i != peerIterator->second.end(); ++i)
+					{
+						_metadataCacheSize -= i->second.size;
+					}
+					//When preloaded, the cache contains all entries of the peer.
+					if(_metadataPreloaded) _metadataCount -= peerIterator->second.size();
+					_metadata.erase(peerIterator);
+				}
+				else
+				{
+					std::map<std::string, CachedMetadata>::iterator dataIterator = peerIterator->second.find(dataID);
+					if(dataIterator != peerIterator->second.end())
+					{
+						_metadataCacheSize -= dataIterator->second.size;
+						if(_metadataPreloaded) _metadataCount--;
+						peerIterator->second.erase(dataIterator);
+						if(peerIterator->second.empty()) _metadata.erase(peerIterator);
+					}
+				}
+			}
+		}
 
 		std::shared_ptr<std::vector<std::string>> valueKeys(new std::vector<std::string>{dataID});
 		std::shared_ptr<std::vector<BaseLib::PVariable>> values(new std::vector<BaseLib::PVariable>());
@@ -703,21 +1064,60 @@ BaseLib::PVariable DatabaseController::deleteMetadata(uint64_t peerID, std::stri
 //End metadata
 
 //System variables
-BaseLib::PVariable DatabaseController::getAllSystemVariables()
+DatabaseController::SystemVariableShard& DatabaseController::getSystemVariableShard(const std::string& variableID)
+{
+	return _systemVariableShards[std::hash<std::string>()(variableID) % _systemVariableShardCount];
+}
+
+void DatabaseController::loadSystemVariables()
 {
 	try
 	{
+		int64_t startTime = BaseLib::HelperFunctions::getTime();
 		std::shared_ptr<BaseLib::Database::DataTable> rows = _db.executeCommand("SELECT variableID, serializedObject FROM systemVariables");
 
-		BaseLib::PVariable systemVariableStruct(new BaseLib::Variable(BaseLib::VariableType::tStruct));
-		if(rows->empty()) return systemVariableStruct;
+		int64_t count = 0;
+		for(int32_t i = 0; i < _systemVariableShardCount; i++)
+		{
+			std::lock_guard<std::mutex> shardGuard(_systemVariableShards[i].mutex);
+			_systemVariableShards[i].variables.clear();
+		}
 		for(BaseLib::Database::DataTable::iterator i = rows->begin(); i != rows->end(); ++i)
 		{
-			if(i->second.size() < 2) continue;
+			if(i->second.size() < 2 || !i->second.at(1)->binaryValue) continue;
 			BaseLib::PVariable value = _rpcDecoder->decodeResponse(*i->second.at(1)->binaryValue);
-			systemVariableStruct->structValue->insert(BaseLib::StructElement(i->second.at(0)->textValue, value));
+			SystemVariableShard& shard = getSystemVariableShard(i->second.at(0)->textValue);
+			std::lock_guard<std::mutex> shardGuard(shard.mutex);
+			shard.variables[i->second.at(0)->textValue] = value;
+			count++;
 		}
+		_systemVariableCount = count;
+		GD::out.printInfo("Info: Loaded " + std::to_string(count) + " system variables in " + std::to_string(BaseLib::HelperFunctions::getTime() - startTime) + " ms.");
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
 
+BaseLib::PVariable DatabaseController::getAllSystemVariables()
+{
+	try
+	{
+		BaseLib::PVariable systemVariableStruct(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+		for(int32_t i = 0; i < _systemVariableShardCount; i++)
+		{
+			std::lock_guard<std::mutex> shardGuard(_systemVariableShards[i].mutex);
+			systemVariableStruct->structValue->insert(_systemVariableShards[i].variables.begin(), _systemVariableShards[i].variables.end());
+		}
 		return systemVariableStruct;
 	}
 	catch(const std::exception& ex)
@@ -741,30 +1141,11 @@ BaseLib::PVariable DatabaseController::getSystemVariable(std::string& variableID
 	{
 		if(variableID.size() > 250) return BaseLib::Variable::createError(-32602, "variableID has more than 250 characters.");
 
-		BaseLib::PVariable value;
-		_systemVariableMutex.lock();
-		if(_systemVariables.find(variableID) != _systemVariables.end())
-		{
-			 value = _systemVariables.at(variableID);
-			_systemVariableMutex.unlock();
-			return value;
-		}
-		_systemVariableMutex.unlock();
-
-		BaseLib::Database::DataRow data;
-		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(variableID)));
-
-		std::shared_ptr<BaseLib::Database::DataTable> rows = _db.executeCommand("SELECT serializedObject FROM systemVariables WHERE variableID=?", data);
-		if(rows->empty() || rows->at(0).empty())
-		{
-			return BaseLib::Variable::createError(-1, "System variable not found.");
-		}
-
-		value = _rpcDecoder->decodeResponse(*rows->at(0).at(0)->binaryValue);
-		_systemVariableMutex.lock();
-		_systemVariables[variableID] = value;
-		_systemVariableMutex.unlock();
-		return value;
+		SystemVariableShard& shard = getSystemVariableShard(variableID);
+		std::lock_guard<std::mutex> shardGuard(shard.mutex);
+		std::map<std::string, BaseLib::PVariable>::iterator variableIterator = shard.variables.find(variableID);
+		if(variableIterator == shard.variables.end()) return BaseLib::Variable::createError(-1, "System variable not found.");
+		return variableIterator->second;
 	}
 	catch(const std::exception& ex)
 	{
@@ -781,50 +1162,136 @@ BaseLib::PVariable DatabaseController::getSystemVariable(std::string& variableID
 	return BaseLib::Variable::createError(-32500, "Unknown application error.");
 }
 
-BaseLib::PVariable DatabaseController::setSystemVariable(std::string& variableID, BaseLib::PVariable& value)
+BaseLib::PVariable DatabaseController::getSystemVariables(BaseLib::PArray& variableIDs)
 {
 	try
 	{
-		if(!value) return BaseLib::Variable::createError(-32602, "Could not parse data.");
-		if(variableID.size() > 250) return BaseLib::Variable::createError(-32602, "variableID has more than 250 characters.");
-		//Don't check for type here, so base64, string and future data types that use stringValue are handled
-		if(value->stringValue.size() > 1000) return BaseLib::Variable::createError(-32602, "Data has more than 1000 characters.");
-		if(value->type != BaseLib::VariableType::tBase64 && value->type != BaseLib::VariableType::tString && value->type != BaseLib::VariableType::tInteger && value->type != BaseLib::VariableType::tFloat && value->type != BaseLib::VariableType::tBoolean && value->type != BaseLib::VariableType::tStruct && value->type != BaseLib::VariableType::tArray) return BaseLib::Variable::createError(-32602, "Type " + BaseLib::Variable::getTypeString(value->type) + " is currently not supported.");
-
-		std::shared_ptr<BaseLib::Database::DataTable> rows = _db.executeCommand("SELECT COUNT(*) FROM systemVariables");
-		if(rows->size() == 0 || rows->at(0).size() == 0)
-		{
-			return BaseLib::Variable::createError(-32500, "Error counting system variables in database.");
-		}
-		if(rows->at(0).at(0)->intValue > 1000000)
+		BaseLib::PVariable systemVariableStruct(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+		for(BaseLib::Array::iterator i = variableIDs->begin(); i != variableIDs->end(); ++i)
 		{
-			return BaseLib::Variable::createError(-32500, "Reached limit of 1000000 system variable entries. Please delete system variables before adding new ones.");
+			if(!*i) continue;
+			SystemVariableShard& shard = getSystemVariableShard((*i)->stringValue);
+			std::lock_guard<std::mutex> shardGuard(shard.mutex);
+			std::map<std::string, BaseLib::PVariable>::iterator variableIterator = shard.variables.find((*i)->stringValue);
+			if(variableIterator != shard.variables.end()) systemVariableStruct->structValue->insert(BaseLib::StructElement(variableIterator->first, variableIterator->second));
 		}
+		return systemVariableStruct;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
 
-		_systemVariableMutex.lock();
-		_systemVariables[variableID] = value;
-		_systemVariableMutex.unlock();
-
-		BaseLib::Database::DataRow data;
-		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(variableID)));
-		bufferedWrite("DELETE FROM systemVariables WHERE variableID=?", data);
+BaseLib::PVariable DatabaseController::checkSystemVariable(const std::string& variableID, BaseLib::PVariable& value, std::vector<char>& encodedValue)
+{
+	try
+	{
+		if(!value) return BaseLib::Variable::createError(-32602, "Could not parse data.");
+		if(variableID.size() > 250) return BaseLib::Variable::createError(-32602, "variableID has more than 250 characters.");
+		//Don't check for type here, so base64, string and future data types that use stringValue are handled
+		if(value->stringValue.size() > 1000) return BaseLib::Variable::createError(-32602, "Data has more than 1000 characters.");
+		if(value->type != BaseLib::VariableType::tBase64 && value->type != BaseLib::VariableType::tString && value->type != BaseLib::VariableType::tInteger && value->type != BaseLib::VariableType::tFloat && value->type != BaseLib::VariableType::tBoolean && value->type != BaseLib::VariableType::tStruct && value->type != BaseLib::VariableType::tArray) return BaseLib::Variable::createError(-32602, "Type " + BaseLib::Variable::getTypeString(value->type) + " is currently not supported.");
 
-		std::vector<char> encodedValue;
 		_rpcEncoder->encodeResponse(value, encodedValue);
 		if(encodedValue.size() > 1000)
 		{
 			return BaseLib::Variable::createError(-32602, "Data is larger than 1000 bytes.");
 		}
+		return BaseLib::PVariable();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
+
+BaseLib::PVariable DatabaseController::storeSystemVariable(const std::string& variableID, BaseLib::PVariable& value, std::vector<char>& encodedValue)
+{
+	try
+	{
+		{
+			SystemVariableShard& shard = getSystemVariableShard(variableID);
+			std::lock_guard<std::mutex> shardGuard(shard.mutex);
+			std::map<std::string, BaseLib::PVariable>::iterator variableIterator = shard.variables.find(variableID);
+			if(variableIterator == shard.variables.end())
+			{
+				//Reserve the slot first. Checking and incrementing separately lets concurrent calls on different shards exceed the limit.
+				if(_systemVariableCount.fetch_add(1) >= 1000000)
+				{
+					_systemVariableCount--;
+					return BaseLib::Variable::createError(-32500, "Reached limit of 1000000 system variable entries. Please delete system variables before adding new ones.");
+				}
+				try
+				{
+					shard.variables[variableID] = value;
+				}
+				catch(...)
+				{
+					_systemVariableCount--;
+					throw;
+				}
+			}
+			else variableIterator->second = value;
+		}
+
+		BaseLib::Database::DataRow data;
+		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(variableID)));
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(encodedValue)));
+		bufferedSystemVariableWrite(variableID, data);
+		return BaseLib::PVariable();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
 
-		bufferedWrite("INSERT INTO systemVariables VALUES(?, ?)", data);
+BaseLib::PVariable DatabaseController::setSystemVariable(std::string& variableID, BaseLib::PVariable& value)
+{
+	return setSystemVariable(variableID, value, false);
+}
+
+BaseLib::PVariable DatabaseController::setSystemVariable(std::string& variableID, BaseLib::PVariable& value, bool waitForNotification)
+{
+	try
+	{
+		std::vector<char> encodedValue;
+		BaseLib::PVariable result = checkSystemVariable(variableID, value, encodedValue);
+		if(result) return result;
+		result = storeSystemVariable(variableID, value, encodedValue);
+		if(result) return result;
 
-#ifdef EVENTHANDLER
-		GD::eventHandler->trigger(variableID, value);
-#endif
 		std::shared_ptr<std::vector<std::string>> valueKeys(new std::vector<std::string>{variableID});
 		std::shared_ptr<std::vector<BaseLib::PVariable>> values(new std::vector<BaseLib::PVariable>{value});
-		GD::rpcClient->broadcastEvent(0, -1, "", valueKeys, values);
+		_systemVariableNotifier.notify(valueKeys, values, false, waitForNotification);
 
 		return BaseLib::PVariable(new BaseLib::Variable(BaseLib::VariableType::tVoid));
 	}
@@ -843,20 +1310,80 @@ BaseLib::PVariable DatabaseController::setSystemVariable(std::string& variableID
 	return BaseLib::Variable::createError(-32500, "Unknown application error.");
 }
 
+BaseLib::PVariable DatabaseController::setSystemVariables(BaseLib::PStruct& variables, bool waitForNotification)
+{
+	try
+	{
+		//Check all variables first, so either all or no variable is set, unless the limit is reached.
+		std::vector<std::vector<char>> encodedValues(variables->size());
+		int32_t index = 0;
+		for(BaseLib::Struct::iterator i = variables->begin(); i != variables->end(); ++i, ++index)
+		{
+			BaseLib::PVariable result = checkSystemVariable(i->first, i->second, encodedValues.at(index));
+			if(result)
+			{
+				if(result->errorStruct) result->structValue->at("faultString")->stringValue = i->first + ": " + result->structValue->at("faultString")->stringValue;
+				return result;
+			}
+		}
+
+		std::shared_ptr<std::vector<std::string>> valueKeys(new std::vector<std::string>());
+		std::shared_ptr<std::vector<BaseLib::PVariable>> values(new std::vector<BaseLib::PVariable>());
+		valueKeys->reserve(variables->size());
+		values->reserve(variables->size());
+		BaseLib::PVariable result;
+		index = 0;
+		for(BaseLib::Struct::iterator i = variables->begin(); i != variables->end(); ++i, ++index)
+		{
+			result = storeSystemVariable(i->first, i->second, encodedValues.at(index));
+			if(result) break;
+			valueKeys->push_back(i->first);
+			values->push_back(i->second);
+		}
+
+		//One event for all variables that were set.
+		_systemVariableNotifier.notify(valueKeys, values, false, waitForNotification);
+
+		if(result) return result;
+		return BaseLib::PVariable(new BaseLib::Variable(BaseLib::VariableType::tVoid));
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
+
 BaseLib::PVariable DatabaseController::deleteSystemVariable(std::string& variableID)
 {
 	try
 	{
 		if(variableID.size() > 250) return BaseLib::Variable::createError(-32602, "variableID has more than 250 characters.");
 
-		_systemVariableMutex.lock();
-		if(_systemVariables.find(variableID) != _systemVariables.end()) _systemVariables.erase(variableID);
-		_systemVariableMutex.unlock();
+		{
+			SystemVariableShard& shard = getSystemVariableShard(variableID);
+			std::lock_guard<std::mutex> shardGuard(shard.mutex);
+			if(shard.variables.erase(variableID) > 0) _systemVariableCount--;
+		}
 
 		BaseLib::Database::DataRow data;
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(variableID)));
 		std::string command("DELETE FROM systemVariables WHERE variableID=?");
-		bufferedWrite(command, data);
+		{
+			std::lock_guard<std::mutex> queueGuard(_queueMutex);
+			//A following set must not be merged into an entry queued before this delete.
+			_queuedSystemVariables.erase(variableID);
+			enqueue(command, data);
+		}
+		_queueConditionVariable.notify_one();
 
 		std::shared_ptr<std::vector<std::string>> valueKeys(new std::vector<std::string>{variableID});
 		std::shared_ptr<std::vector<BaseLib::PVariable>> values(new std::vector<BaseLib::PVariable>());
@@ -864,7 +1391,7 @@ BaseLib::PVariable DatabaseController::deleteSystemVariable(std::string& variabl
 		value->structValue->insert(BaseLib::StructElement("TYPE", BaseLib::PVariable(new BaseLib::Variable(0))));
 		value->structValue->insert(BaseLib::StructElement("CODE", BaseLib::PVariable(new BaseLib::Variable(1))));
 		values->push_back(value);
-		GD::rpcClient->broadcastEvent(0, -1, "", valueKeys, values);
+		_systemVariableNotifier.notify(valueKeys, values, true, false);
 
 		return BaseLib::PVariable(new BaseLib::Variable(BaseLib::VariableType::tVoid));
 	}
@@ -1259,6 +1786,9 @@ void DatabaseController::deletePeers(int32_t deviceID)
 		BaseLib::Database::DataRow data;
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(deviceID)));
 		bufferedWrite("DELETE FROM peers WHERE parent=?", data);
+		std::lock_guard<std::mutex> prefetchedPeerDataGuard(_prefetchedPeerDataMutex);
+		_prefetchedPeerData.clear();
+		discardSnapshotPeers(deviceID, 0);
 	}
 	catch(const std::exception& ex)
 	{
@@ -1280,7 +1810,11 @@ std::shared_ptr<BaseLib::Database::DataTable> DatabaseController::getPeers(uint6
 	{
 		BaseLib::Database::DataRow data;
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(deviceID)));
-		std::shared_ptr<BaseLib::Database::DataTable> result = _db.executeCommand("SELECT * FROM peers WHERE parent=?", data);
+		std::shared_ptr<BaseLib::Database::DataTable> result;
+		if(takePeerSnapshot(deviceID, result)) return result;
+		result = _db.executeCommand("SELECT * FROM peers WHERE parent=?", data);
+		//The central is about to load its peers, so read their data in bulk instead of three queries per peer.
+		if(result && !result->empty()) prefetchPeerData(deviceID, result);
 		return result;
 	}
 	catch(const std::exception& ex)
@@ -1333,6 +1867,7 @@ void DatabaseController::deletePeer(uint64_t id)
 		bufferedWrite("DELETE FROM peerVariables WHERE peerID=?", data);
 		bufferedWrite("DELETE FROM peers WHERE peerID=?", data);
 		bufferedWrite("DELETE FROM serviceMessages WHERE peerID=?", data);
+		removePrefetchedPeerData(id);
 	}
 	catch(const std::exception& ex)
 	{
@@ -1360,6 +1895,11 @@ uint64_t DatabaseController::savePeer(uint64_t id, uint32_t parentID, int32_t ad
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(serialNumber)));
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(type)));
 		uint64_t result = _db.executeWriteCommand("REPLACE INTO peers VALUES(?, ?, ?, ?, ?)", data);
+		{
+			//The peer rows of the snapshot don't contain this change.
+			std::lock_guard<std::mutex> prefetchedPeerDataGuard(_prefetchedPeerDataMutex);
+			discardSnapshotPeers(parentID, id);
+		}
 		return result;
 	}
 	catch(const std::exception& ex)
@@ -1401,8 +1941,13 @@ void DatabaseController::savePeerParameterAsynchronous(uint64_t peerID, BaseLib:
 			{
 				bufferedWrite("REPLACE INTO parameters VALUES(?, ?, ?, ?, ?, ?, ?, ?)", data);
 			}
-			else GD::out.printError("Error: Either parameterID is 0 or the number of columns is invalid.");
+			else
+			{
+				GD::out.printError("Error: Either parameterID is 0 or the number of columns is invalid.");
+				return;
+			}
 		}
+		invalidatePrefetchedPeerData(peerID, &PrefetchedPeerData::parameters);
 	}
 	catch(const std::exception& ex)
 	{
@@ -1458,8 +2003,13 @@ void DatabaseController::savePeerVariableAsynchronous(uint64_t peerID, BaseLib::
 			{
 				bufferedWrite("REPLACE INTO peerVariables VALUES(?, ?, ?, ?, ?, ?)", data);
 			}
-			else GD::out.printError("Error: Either variableID is 0 or the number of columns is invalid.");
+			else
+			{
+				GD::out.printError("Error: Either variableID is 0 or the number of columns is invalid.");
+				return;
+			}
 		}
+		invalidatePrefetchedPeerData(peerID, &PrefetchedPeerData::variables);
 	}
 	catch(const std::exception& ex)
 	{
@@ -1479,6 +2029,9 @@ std::shared_ptr<BaseLib::Database::DataTable> DatabaseController::getPeerParamet
 {
 	try
 	{
+		std::shared_ptr<BaseLib::Database::DataTable> prefetchedRows = getPrefetchedPeerData(peerID, &PrefetchedPeerData::parameters);
+		if(prefetchedRows) return prefetchedRows;
+
 		BaseLib::Database::DataRow data;
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(peerID)));
 		std::shared_ptr<BaseLib::Database::DataTable> result = _db.executeCommand("SELECT * FROM parameters WHERE peerID=?", data);
@@ -1503,6 +2056,9 @@ std::shared_ptr<BaseLib::Database::DataTable> DatabaseController::getPeerVariabl
 {
 	try
 	{
+		std::shared_ptr<BaseLib::Database::DataTable> prefetchedRows = getPrefetchedPeerData(peerID, &PrefetchedPeerData::variables);
+		if(prefetchedRows) return prefetchedRows;
+
 		BaseLib::Database::DataRow data;
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(peerID)));
 		std::shared_ptr<BaseLib::Database::DataTable> result = _db.executeCommand("SELECT * FROM peerVariables WHERE peerID=?", data);
@@ -1523,6 +2079,569 @@ std::shared_ptr<BaseLib::Database::DataTable> DatabaseController::getPeerVariabl
 	return std::shared_ptr<BaseLib::Database::DataTable>();
 }
 
+std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> DatabaseController::getPeerParametersForParent(uint64_t deviceID)
+{
+	return getRowsForParent("SELECT parameters.* FROM parameters JOIN peers ON parameters.peerID=peers.peerID WHERE peers.parent=?", deviceID);
+}
+
+std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> DatabaseController::getPeerVariablesForParent(uint64_t deviceID)
+{
+	return getRowsForParent("SELECT peerVariables.* FROM peerVariables JOIN peers ON peerVariables.peerID=peers.peerID WHERE peers.parent=?", deviceID);
+}
+
+std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> DatabaseController::getRowsForParent(std::string command, uint64_t deviceID)
+{
+	std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> rowsByPeer;
+	try
+	{
+		BaseLib::Database::DataRow data;
+		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(deviceID)));
+		std::shared_ptr<BaseLib::Database::DataTable> rows = _db.executeCommand(command, data);
+		if(!rows) return rowsByPeer;
+		for(BaseLib::Database::DataTable::iterator i = rows->begin(); i != rows->end(); ++i)
+		{
+			//The second column of all peer tables is the peer ID.
+			if(i->second.size() < 2) continue;
+			std::shared_ptr<BaseLib::Database::DataTable>& peerRows = rowsByPeer[(uint64_t)i->second.at(1)->intValue];
+			if(!peerRows) peerRows.reset(new BaseLib::Database::DataTable());
+			uint32_t index = peerRows->size();
+			(*peerRows)[index] = i->second;
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return rowsByPeer;
+}
+
+void DatabaseController::prefetchPeerData(uint64_t deviceID, std::shared_ptr<BaseLib::Database::DataTable>& peers)
+{
+	try
+	{
+		{
+			std::lock_guard<std::mutex> prefetchedPeerDataGuard(_prefetchedPeerDataMutex);
+			_peerPrefetchesRunning++;
+		}
+
+		std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> parameters = getPeerParametersForParent(deviceID);
+		std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> variables = getPeerVariablesForParent(deviceID);
+		std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> serviceMessages = getServiceMessagesForParent(deviceID);
+
+		int64_t time = BaseLib::HelperFunctions::getTime();
+		std::lock_guard<std::mutex> prefetchedPeerDataGuard(_prefetchedPeerDataMutex);
+		_peerPrefetchesRunning--;
+		bool writeAll = _peerPrefetchWriteAll;
+		std::set<uint64_t> writes;
+		if(_peerPrefetchesRunning == 0)
+		{
+			writes.swap(_peerPrefetchWrites);
+			_peerPrefetchWriteAll = false;
+		}
+		else writes = _peerPrefetchWrites;
+		if(writeAll) return;
+
+		for(std::map<uint64_t, PrefetchedPeerData>::iterator i = _prefetchedPeerData.begin(); i != _prefetchedPeerData.end();)
+		{
+			if(time - i->second.time > _peerPrefetchTimeout) i = _prefetchedPeerData.erase(i);
+			else ++i;
+		}
+		for(BaseLib::Database::DataTable::iterator i = peers->begin(); i != peers->end(); ++i)
+		{
+			if(i->second.empty()) continue;
+			uint64_t peerID = i->second.at(0)->intValue;
+			//The peer was written to while the rows were read, so they might be outdated.
+			if(writes.find(peerID) != writes.end()) continue;
+			PrefetchedPeerData& peerData = _prefetchedPeerData[peerID];
+			peerData.time = time;
+			//Peers without rows get an empty table, so they don't query the database either.
+			std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>>::iterator rowsIterator = parameters.find(peerID);
+			peerData.parameters = rowsIterator != parameters.end() ? rowsIterator->second : std::shared_ptr<BaseLib::Database::DataTable>(new BaseLib::Database::DataTable());
+			rowsIterator = variables.find(peerID);
+			peerData.variables = rowsIterator != variables.end() ? rowsIterator->second : std::shared_ptr<BaseLib::Database::DataTable>(new BaseLib::Database::DataTable());
+			rowsIterator = serviceMessages.find(peerID);
+			peerData.serviceMessages = rowsIterator != serviceMessages.end() ? rowsIterator->second : std::shared_ptr<BaseLib::Database::DataTable>(new BaseLib::Database::DataTable());
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+std::shared_ptr<BaseLib::Database::DataTable> DatabaseController::getPrefetchedPeerData(uint64_t peerID, std::shared_ptr<BaseLib::Database::DataTable> PrefetchedPeerData::* table)
+{
+	try
+	{
+		std::lock_guard<std::mutex> prefetchedPeerDataGuard(_prefetchedPeerDataMutex);
+		if(_prefetchedPeerData.empty()) return std::shared_ptr<BaseLib::Database::DataTable>();
+		std::map<uint64_t, PrefetchedPeerData>::iterator peerDataIterator = _prefetchedPeerData.find(peerID);
+		if(peerDataIterator == _prefetchedPeerData.end()) return std::shared_ptr<BaseLib::Database::DataTable>();
+		if(BaseLib::HelperFunctions::getTime() - peerDataIterator->second.time > _peerPrefetchTimeout)
+		{
+			_prefetchedPeerData.erase(peerDataIterator);
+			return std::shared_ptr<BaseLib::Database::DataTable>();
+		}
+
+		//Prefetched data is only handed out once. Later calls read the current data from the database.
+		std::shared_ptr<BaseLib::Database::DataTable> rows;
+		rows.swap(peerDataIterator->second.*table);
+		if(!peerDataIterator->second.parameters && !peerDataIterator->second.variables && !peerDataIterator->second.serviceMessages) _prefetchedPeerData.erase(peerDataIterator);
+		return rows;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return std::shared_ptr<BaseLib::Database::DataTable>();
+}
+
+void DatabaseController::removePrefetchedPeerData(uint64_t peerID)
+{
+	try
+	{
+		std::lock_guard<std::mutex> prefetchedPeerDataGuard(_prefetchedPeerDataMutex);
+		_prefetchedPeerData.erase(peerID);
+		_snapshotPeerData.erase(peerID);
+		discardSnapshotPeers(0, peerID);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+void DatabaseController::invalidatePrefetchedPeerData(uint64_t peerID, std::shared_ptr<BaseLib::Database::DataTable> PrefetchedPeerData::* table)
+{
+	try
+	{
+		std::lock_guard<std::mutex> prefetchedPeerDataGuard(_prefetchedPeerDataMutex);
+		if(_peerPrefetchesRunning > 0)
+		{
+			if(peerID == 0) _peerPrefetchWriteAll = true;
+			else _peerPrefetchWrites.insert(peerID);
+		}
+		if(!_snapshotPeers.empty())
+		{
+			if(peerID == 0) _snapshotPeerWriteAll = true;
+			else _snapshotPeerWrites.insert(peerID);
+		}
+		if(_prefetchedPeerData.empty()) return;
+
+		for(std::map<uint64_t, PrefetchedPeerData>::iterator i = (peerID == 0 ? _prefetchedPeerData.begin() : _prefetchedPeerData.find(peerID)); i != _prefetchedPeerData.end();)
+		{
+			(i->second.*table).reset();
+			if(!i->second.parameters && !i->second.variables && !i->second.serviceMessages) i = _prefetchedPeerData.erase(i);
+			else ++i;
+			if(peerID != 0) break;
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+void DatabaseController::discardSnapshotPeers(uint64_t parentID, uint64_t peerID)
+{
+	try
+	{
+		if(_snapshotPeers.empty()) return;
+		if(parentID != 0) _snapshotPeers.erase(parentID);
+		if(peerID != 0)
+		{
+			for(std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>>::iterator i = _snapshotPeers.begin(); i != _snapshotPeers.end(); ++i)
+			{
+				bool found = false;
+				for(BaseLib::Database::DataTable::iterator j = i->second->begin(); j != i->second->end(); ++j)
+				{
+					if(!j->second.empty() && (uint64_t)j->second.at(0)->intValue == peerID)
+					{
+						found = true;
+						break;
+					}
+				}
+				if(found)
+				{
+					_snapshotPeers.erase(i);
+					break;
+				}
+			}
+		}
+		if(_snapshotPeers.empty())
+		{
+			_snapshotPeerData.clear();
+			_snapshotPeerWrites.clear();
+			_snapshotPeerWriteAll = false;
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+std::string DatabaseController::getPeerSnapshotPath()
+{
+	return GD::bl->settings.databasePath() + ".peers";
+}
+
+void DatabaseController::loadPeerSnapshot()
+{
+	try
+	{
+		BaseLib::Database::DataRow data;
+		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(_peerSnapshotGenerationIndex)));
+		std::shared_ptr<BaseLib::Database::DataTable> result = _db.executeCommand("SELECT variableID, integerValue FROM homegearVariables WHERE variableIndex=?", data);
+		int64_t variableID = 0;
+		int64_t generation = 0;
+		if(!result->empty() && result->at(0).size() >= 2)
+		{
+			variableID = result->at(0).at(0)->intValue;
+			generation = result->at(0).at(1)->intValue;
+		}
+
+		std::string path = getPeerSnapshotPath();
+		if(BaseLib::Io::fileExists(path))
+		{
+			if(GD::peerSnapshot)
+			{
+				int64_t startTime = BaseLib::HelperFunctions::getTime();
+				if(readPeerSnapshot(path, generation)) GD::out.printInfo("Info: Peer snapshot loaded in " + std::to_string(BaseLib::HelperFunctions::getTime() - startTime) + " ms.");
+				else GD::out.printInfo("Info: Peer snapshot is outdated or invalid. Loading peers from database.");
+			}
+			//The snapshot is only valid for one start.
+			GD::bl->io.deleteFile(path);
+		}
+
+		//Increase the generation on every start. This invalidates existing snapshots, even when the snapshot couldn't be deleted.
+		_peerSnapshotGeneration = generation + 1;
+		data.clear();
+		if(variableID == 0) data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn()));
+		else data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(variableID)));
+		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(_peerSnapshotGenerationIndex)));
+		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(_peerSnapshotGeneration)));
+		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn()));
+		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn()));
+		_db.executeWriteCommand("REPLACE INTO homegearVariables VALUES(?, ?, ?, ?, ?)", data);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+bool DatabaseController::readPeerSnapshot(const std::string& path, int64_t generation)
+{
+	int32_t fileDescriptor = -1;
+	void* file = MAP_FAILED;
+	size_t fileSize = 0;
+	try
+	{
+		fileDescriptor = ::open(path.c_str(), O_RDONLY);
+		if(fileDescriptor == -1) return false;
+		struct stat fileInfo;
+		if(fstat(fileDescriptor, &fileInfo) == -1 || fileInfo.st_size < 16)
+		{
+			::close(fileDescriptor);
+			return false;
+		}
+		fileSize = fileInfo.st_size;
+		file = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		::close(fileDescriptor);
+		if(file == MAP_FAILED) return false;
+
+		const char* position = (const char*)file;
+		const char* end = position + fileSize;
+		//Every read is bounds checked. On error the whole snapshot is discarded.
+		std::function<bool(void*, size_t)> read = [&](void* target, size_t size) -> bool
+		{
+			if((size_t)(end - position) < size) return false;
+			memcpy(target, position, size);
+			position += size;
+			return true;
+		};
+
+		char magic[4];
+		uint32_t version = 0;
+		int64_t snapshotGeneration = 0;
+		if(!read(magic, 4) || memcmp(magic, "HGPS", 4) != 0 || !read(&version, 4) || version != _peerSnapshotVersion || !read(&snapshotGeneration, 8) || snapshotGeneration != generation)
+		{
+			munmap(file, fileSize);
+			return false;
+		}
+
+		//Tables in file order: peers, parameters, peerVariables, serviceMessages. In all tables the second column is used for grouping (peers: parent, other tables: peerID).
+		std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> tables[4];
+		for(int32_t table = 0; table < 4; table++)
+		{
+			uint32_t rowCount = 0;
+			if(!read(&rowCount, 4))
+			{
+				munmap(file, fileSize);
+				return false;
+			}
+			for(uint32_t row = 0; row < rowCount; row++)
+			{
+				uint32_t columnCount = 0;
+				if(!read(&columnCount, 4) || columnCount < 2 || columnCount > 100)
+				{
+					munmap(file, fileSize);
+					return false;
+				}
+				std::map<uint32_t, std::shared_ptr<BaseLib::Database::DataColumn>> columns;
+				for(uint32_t i = 0; i < columnCount; i++)
+				{
+					std::shared_ptr<BaseLib::Database::DataColumn> column(new BaseLib::Database::DataColumn());
+					column->index = i;
+					uint8_t type = 0;
+					bool valid = read(&type, 1);
+					if(valid)
+					{
+						column->dataType = (BaseLib::Database::DataColumn::DataType::Enum)type;
+						if(column->dataType == BaseLib::Database::DataColumn::DataType::Enum::INTEGER) valid = read(&column->intValue, 8);
+						else if(column->dataType == BaseLib::Database::DataColumn::DataType::Enum::FLOAT) valid = read(&column->floatValue, 8);
+						else if(column->dataType == BaseLib::Database::DataColumn::DataType::Enum::TEXT || column->dataType == BaseLib::Database::DataColumn::DataType::Enum::BLOB)
+						{
+							uint32_t size = 0;
+							valid = read(&size, 4) && (size_t)(end - position) >= size;
+							if(valid && column->dataType == BaseLib::Database::DataColumn::DataType::Enum::TEXT) column->textValue = std::string(position, size);
+							else if(valid && size > 0) column->binaryValue.reset(new std::vector<char>(position, position + size));
+							if(valid) position += size;
+						}
+						else if(column->dataType != BaseLib::Database::DataColumn::DataType::Enum::NODATA) valid = false;
+					}
+					if(!valid)
+					{
+						munmap(file, fileSize);
+						return false;
+					}
+					columns[i] = column;
+				}
+				std::shared_ptr<BaseLib::Database::DataTable>& rows = tables[table][(uint64_t)columns.at(1)->intValue];
+				if(!rows) rows.reset(new BaseLib::Database::DataTable());
+				uint32_t index = rows->size();
+				(*rows)[index] = columns;
+			}
+		}
+		munmap(file, fileSize);
+		file = MAP_FAILED;
+		if(position != end) return false;
+
+		std::lock_guard<std::mutex> prefetchedPeerDataGuard(_prefetchedPeerDataMutex);
+		_snapshotPeers.swap(tables[0]);
+		for(std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>>::iterator i = tables[1].begin(); i != tables[1].end(); ++i) _snapshotPeerData[i->first].parameters = i->second;
+		for(std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>>::iterator i = tables[2].begin(); i != tables[2].end(); ++i) _snapshotPeerData[i->first].variables = i->second;
+		for(std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>>::iterator i = tables[3].begin(); i != tables[3].end(); ++i) _snapshotPeerData[i->first].serviceMessages = i->second;
+		return true;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	if(file != MAP_FAILED) munmap(file, fileSize);
+	return false;
+}
+
+void DatabaseController::writePeerSnapshot()
+{
+	try
+	{
+		int64_t startTime = BaseLib::HelperFunctions::getTime();
+		std::vector<char> buffer;
+		buffer.reserve(1048576);
+		std::function<void(const void*, size_t)> write = [&](const void* source, size_t size)
+		{
+			buffer.insert(buffer.end(), (const char*)source, (const char*)source + size);
+		};
+
+		uint32_t version = _peerSnapshotVersion;
+		write("HGPS", 4);
+		write(&version, 4);
+		write(&_peerSnapshotGeneration, 8);
+
+		//Keep in sync with readPeerSnapshot().
+		std::vector<std::string> tables{ "peers", "parameters", "peerVariables", "serviceMessages" };
+		BaseLib::Database::DataRow data;
+		for(std::vector<std::string>::iterator i = tables.begin(); i != tables.end(); ++i)
+		{
+			std::shared_ptr<BaseLib::Database::DataTable> rows = _db.executeCommand("SELECT * FROM " + *i, data);
+			if(!rows) return;
+			uint32_t rowCount = rows->size();
+			write(&rowCount, 4);
+			for(BaseLib::Database::DataTable::iterator j = rows->begin(); j != rows->end(); ++j)
+			{
+				uint32_t columnCount = j->second.size();
+				write(&columnCount, 4);
+				for(std::map<uint32_t, std::shared_ptr<BaseLib::Database::DataColumn>>::iterator k = j->second.begin(); k != j->second.end(); ++k)
+				{
+					uint8_t type = (uint8_t)k->second->dataType;
+					write(&type, 1);
+					if(k->second->dataType == BaseLib::Database::DataColumn::DataType::Enum::INTEGER) write(&k->second->intValue, 8);
+					else if(k->second->dataType == BaseLib::Database::DataColumn::DataType::Enum::FLOAT) write(&k->second->floatValue, 8);
+					else if(k->second->dataType == BaseLib::Database::DataColumn::DataType::Enum::TEXT)
+					{
+						uint32_t size = k->second->textValue.size();
+						write(&size, 4);
+						write(k->second->textValue.data(), size);
+					}
+					else if(k->second->dataType == BaseLib::Database::DataColumn::DataType::Enum::BLOB)
+					{
+						uint32_t size = k->second->binaryValue ? k->second->binaryValue->size() : 0;
+						write(&size, 4);
+						if(size > 0) write(k->second->binaryValue->data(), size);
+					}
+				}
+			}
+		}
+
+		//Write to a temporary file first, so an interrupted write never leaves a truncated snapshot.
+		std::string path = getPeerSnapshotPath();
+		std::string tempPath = path + ".tmp";
+		BaseLib::Io::writeFile(tempPath, buffer, buffer.size());
+		if(rename(tempPath.c_str(), path.c_str()) == -1)
+		{
+			GD::out.printError("Error: Could not write peer snapshot to " + path + ".");
+			GD::bl->io.deleteFile(tempPath);
+			return;
+		}
+		GD::out.printInfo("Info: Peer snapshot written in " + std::to_string(BaseLib::HelperFunctions::getTime() - startTime) + " ms.");
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+bool DatabaseController::takePeerSnapshot(uint64_t deviceID, std::shared_ptr<BaseLib::Database::DataTable>& peers)
+{
+	try
+	{
+		std::lock_guard<std::mutex> prefetchedPeerDataGuard(_prefetchedPeerDataMutex);
+		if(_snapshotPeers.empty()) return false;
+		std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>>::iterator peersIterator = _snapshotPeers.find(deviceID);
+		if(peersIterator == _snapshotPeers.end()) return false;
+		peers = peersIterator->second;
+		_snapshotPeers.erase(peersIterator);
+
+		int64_t time = BaseLib::HelperFunctions::getTime();
+		for(BaseLib::Database::DataTable::iterator i = peers->begin(); i != peers->end(); ++i)
+		{
+			if(i->second.empty()) continue;
+			uint64_t peerID = i->second.at(0)->intValue;
+			if(_snapshotPeerWriteAll || _snapshotPeerWrites.find(peerID) != _snapshotPeerWrites.end())
+			{
+				//Written to after the snapshot was read. The peer reads its data from the database.
+				_snapshotPeerData.erase(peerID);
+				continue;
+			}
+			PrefetchedPeerData& peerData = _prefetchedPeerData[peerID];
+			std::map<uint64_t, PrefetchedPeerData>::iterator snapshotIterator = _snapshotPeerData.find(peerID);
+			if(snapshotIterator != _snapshotPeerData.end())
+			{
+				peerData = snapshotIterator->second;
+				_snapshotPeerData.erase(snapshotIterator);
+			}
+			peerData.time = time;
+			if(!peerData.parameters) peerData.parameters.reset(new BaseLib::Database::DataTable());
+			if(!peerData.variables) peerData.variables.reset(new BaseLib::Database::DataTable());
+			if(!peerData.serviceMessages) peerData.serviceMessages.reset(new BaseLib::Database::DataTable());
+		}
+		if(_snapshotPeers.empty())
+		{
+			_snapshotPeerData.clear();
+			_snapshotPeerWrites.clear();
+			_snapshotPeerWriteAll = false;
+		}
+		return true;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return false;
+}
+
 void DatabaseController::deletePeerParameter(uint64_t peerID, BaseLib::Database::DataRow& data)
 {
 	try
@@ -1548,6 +2667,7 @@ void DatabaseController::deletePeerParameter(uint64_t peerID, BaseLib::Database:
 		{
 			bufferedWrite("DELETE FROM parameters WHERE peerID=? AND parameterSetType=? AND peerChannel=? AND parameterName=? AND remotePeer=? AND remoteChannel=?", data);
 		}
+		invalidatePrefetchedPeerData(peerID, &PrefetchedPeerData::parameters);
 	}
 	catch(const std::exception& ex)
 	{
@@ -1575,13 +2695,52 @@ bool DatabaseController::setPeerID(uint64_t oldPeerID, uint64_t newPeerID)
 		bufferedWrite("UPDATE peerVariables SET peerID=? WHERE peerID=?", data);
 		bufferedWrite("UPDATE serviceMessages SET peerID=? WHERE peerID=?", data);
 		bufferedWrite("UPDATE events SET peerID=? WHERE peerID=?", data);
-		_metadataMutex.lock();
-		_metadata.erase(oldPeerID);
-		_metadataMutex.unlock();
+		removePrefetchedPeerData(oldPeerID);
+		removePrefetchedPeerData(newPeerID);
 		data.clear();
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(std::to_string(newPeerID))));
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(std::to_string(oldPeerID))));
-		bufferedWrite("UPDATE metadata SET objectID=? WHERE objectID=?", data);
+		std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>> write = bufferedWrite("UPDATE metadata SET objectID=? WHERE objectID=?", data);
+		{
+			std::lock_guard<std::mutex> metadataGuard(_metadataMutex);
+			//Until the update is executed, the database still contains the entries of the old peer.
+			_metadataChanges++;
+			if(write) _lastMetadataRemoval = write;
+			std::map<uint64_t, std::map<std::string, CachedMetadata>>::iterator peerIterator = _metadata.find(oldPeerID);
+			if(_metadataPreloaded)
+			{
+				if(peerIterator != _metadata.end())
+				{
+					//Merge the entries, so the preloaded cache stays complete. Entries of the old peer replace existing entries of the new peer.
+					std::map<std::string, CachedMetadata>& newEntries = _metadata[newPeerID];
+					for(std::map<std::string, CachedMetadata>::iterator i = peerIterator->second.begin(); i != peerIterator->second.end(); ++i)
+					{
+						std::map<std::string, CachedMetadata>::iterator existingIterator = newEntries.find(i->first);
+						if(existingIterator != newEntries.end())
+						{
+							_metadataCacheSize -= existingIterator->second.size;
+							_metadataCount--;
+						}
+						newEntries[i->first] = std::move(i->second);
+					}
+					_metadata.erase(peerIterator);
+				}
+			}
+			else
+			{
+				//The database might contain entries of both peers, which aren't cached. Load them on demand.
+				for(uint64_t peerID : { oldPeerID, newPeerID })
+				{
+					peerIterator = _metadata.find(peerID);
+					if(peerIterator == _metadata.end()) continue;
+					for(std::map<std::string, CachedMetadata>::iterator i = peerIterator->second.begin(); i != peerIterator->second.end(); ++i)
+					{
+						_metadataCacheSize -= i->second.size;
+					}
+					_metadata.erase(peerIterator);
+				}
+			}
+		}
 		return true;
 	}
 	catch(const std::exception& ex)
@@ -1605,6 +2764,9 @@ std::shared_ptr<BaseLib::Database::DataTable> DatabaseController::getServiceMess
 {
 	try
 	{
+		std::shared_ptr<BaseLib::Database::DataTable> prefetchedRows = getPrefetchedPeerData(peerID, &PrefetchedPeerData::serviceMessages);
+		if(prefetchedRows) return prefetchedRows;
+
 		BaseLib::Database::DataRow data;
 		data.push_back(std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(peerID)));
 		std::shared_ptr<BaseLib::Database::DataTable> result = _db.executeCommand("SELECT * FROM serviceMessages WHERE peerID=?", data);
@@ -1625,6 +2787,11 @@ std::shared_ptr<BaseLib::Database::DataTable> DatabaseController::getServiceMess
 	return std::shared_ptr<BaseLib::Database::DataTable>();
 }
 
+std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> DatabaseController::getServiceMessagesForParent(uint64_t deviceID)
+{
+	return getRowsForParent("SELECT serviceMessages.* FROM serviceMessages JOIN peers ON serviceMessages.peerID=peers.peerID WHERE peers.parent=?", deviceID);
+}
+
 void DatabaseController::saveServiceMessageAsynchronous(uint64_t peerID, BaseLib::Database::DataRow& data)
 {
 	try
@@ -1672,7 +2839,12 @@ void DatabaseController::saveServiceMessageAsynchronous(uint64_t peerID, BaseLib
 		{
 			bufferedWrite("REPLACE INTO serviceMessages VALUES(?, ?, ?, ?, ?, ?)", data);
 		}
-		else GD::out.printError("Error: Either variableID is 0 or the number of columns is invalid.");
+		else
+		{
+			GD::out.printError("Error: Either variableID is 0 or the number of columns is invalid.");
+			return;
+		}
+		invalidatePrefetchedPeerData(peerID, &PrefetchedPeerData::serviceMessages);
 	}
 	catch(const std::exception& ex)
 	{
@@ -1694,6 +2866,8 @@ void DatabaseController::deleteServiceMessage(uint64_t databaseID)
 	{
 		BaseLib::Database::DataRow data({std::shared_ptr<BaseLib::Database::DataColumn>(new BaseLib::Database::DataColumn(databaseID))});
 		_db.executeCommand("DELETE FROM serviceMessages WHERE variableID=?", data);
+		//The peer of the service message is unknown here.
+		invalidatePrefetchedPeerData(0, &PrefetchedPeerData::serviceMessages);
 	}
 	catch(const std::exception& ex)
 	{
@@ -35,9 +35,13 @@
 #include "homegear-base/Encoding/RPCEncoder.h"
 #include "homegear-base/Encoding/RPCDecoder.h"
 #include "../Database/SQLite3.h"
+#include "SystemVariableNotifier.h"
+#include "../Metrics/Metrics.h"
 
 #include <thread>
+#include <atomic>
 #include <condition_variable>
+#include <set>
 
 class DatabaseController : public BaseLib::Database::IDatabaseController
 {
@@ -76,6 +80,29 @@ public:
 	virtual BaseLib::PVariable getSystemVariable(std::string& variableID);
 	virtual BaseLib::PVariable getAllSystemVariables();
 	virtual BaseLib::PVariable deleteSystemVariable(std::string& variableID);
+
+	/**
+	 * Sets a system variable.
+	 *
+	 * @param waitForNotification By default the event handler and RPC clients are notified asynchronously. When true, the method returns after all events are queued for the subscribers.
+	 */
+	BaseLib::PVariable setSystemVariable(std::string& variableID, BaseLib::PVariable& value, bool waitForNotification);
+
+	/**
+	 * Returns multiple system variables at once.
+	 *
+	 * @param variableIDs The IDs of the system variables to return.
+	 * @return Returns a struct with the variable IDs as keys. Unknown variables are left out.
+	 */
+	BaseLib::PVariable getSystemVariables(BaseLib::PArray& variableIDs);
+
+	/**
+	 * Sets multiple system variables at once. All variables are checked before the first one is set. One event containing all variables is broadcasted.
+	 *
+	 * @param variables A struct with the variable IDs as keys.
+	 * @param waitForNotification See setSystemVariable().
+	 */
+	BaseLib::PVariable setSystemVariables(BaseLib::PStruct& variables, bool waitForNotification = false);
 	//End system variables
 
 	//Users
@@ -113,6 +140,22 @@ public:
 	virtual std::shared_ptr<BaseLib::Database::DataTable> getPeerVariables(uint64_t peerID);
 	virtual void deletePeerParameter(uint64_t peerID, BaseLib::Database::DataRow& data);
 
+	/**
+	 * Returns the parameters of all peers of a central in one query.
+	 *
+	 * @param deviceID The ID of the central (the "parent" column of the peers table).
+	 * @return Returns the rows grouped by peer ID. Each table has the same format as the one returned by getPeerParameters().
+	 */
+	std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> getPeerParametersForParent(uint64_t deviceID);
+
+	/**
+	 * Returns the variables of all peers of a central in one query.
+	 *
+	 * @param deviceID The ID of the central (the "parent" column of the peers table).
+	 * @return Returns the rows grouped by peer ID. Each table has the same format as the one returned by getPeerVariables().
+	 */
+	std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> getPeerVariablesForParent(uint64_t deviceID);
+
 	/**
 	 * {@inheritDoc}
 	 */
@@ -123,6 +166,14 @@ public:
 	virtual std::shared_ptr<BaseLib::Database::DataTable> getServiceMessages(uint64_t peerID);
 	virtual void saveServiceMessageAsynchronous(uint64_t peerID, BaseLib::Database::DataRow& data);
 	virtual void deleteServiceMessage(uint64_t databaseID);
+
+	/**
+	 * Returns the service messages of all peers of a central in one query.
+	 *
+	 * @param deviceID The ID of the central (the "parent" column of the peers table).
+	 * @return Returns the rows grouped by peer ID. Each table has the same format as the one returned by getServiceMessages().
+	 */
+	std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> getServiceMessagesForParent(uint64_t deviceID);
 	//End service messages
 
 	// {{{ License modules
@@ -138,11 +189,191 @@ protected:
 	std::unique_ptr<BaseLib::RPC::RPCDecoder> _rpcDecoder;
 	std::unique_ptr<BaseLib::RPC::RPCEncoder> _rpcEncoder;
 
-	std::mutex _systemVariableMutex;
-	std::map<std::string, BaseLib::PVariable> _systemVariables;
+	/* System variables */
+	/**
+	 * All system variables are loaded on start and distributed over the shards by the hash of their ID, so concurrent requests rarely wait for the same mutex.
+	 */
+	static const int32_t _systemVariableShardCount = 16;
+
+	struct SystemVariableShard
+	{
+		std::mutex mutex;
+		std::map<std::string, BaseLib::PVariable> variables;
+	};
+
+	SystemVariableShard _systemVariableShards[_systemVariableShardCount];
+	std::atomic<int64_t> _systemVariableCount{0};
+
+	SystemVariableNotifier _systemVariableNotifier;
+
+	SystemVariableShard& getSystemVariableShard(const std::string& variableID);
+	void loadSystemVariables();
+
+	/**
+	 * Checks and encodes a system variable.
+	 *
+	 * @return Returns nullptr on success or the error to return to the client.
+	 */
+	BaseLib::PVariable checkSystemVariable(const std::string& variableID, BaseLib::PVariable& value, std::vector<char>& encodedValue);
+
+	/**
+	 * Stores a checked system variable in memory and queues the database write. The caller needs to notify _systemVariableNotifier.
+	 *
+	 * @return Returns nullptr on success or the error to return to the client.
+	 */
+	BaseLib::PVariable storeSystemVariable(const std::string& variableID, BaseLib::PVariable& value, std::vector<char>& encodedValue);
+	/* System variables End */
+
+	/* Metadata cache */
+	struct CachedMetadata
+	{
+		BaseLib::PVariable value;
+
+		/**
+		 * Estimated memory usage in bytes (size of the serialized object plus size of the data ID).
+		 */
+		int64_t size = 0;
+
+		/**
+		 * The queued database write of this entry. The entry is not evicted before the write was executed, so reads never see older data than the write queue.
+		 */
+		std::weak_ptr<std::pair<std::string, BaseLib::Database::DataRow>> pendingWrite;
+	};
 
 	std::mutex _metadataMutex;
-	std::map<uint64_t, std::map<std::string, BaseLib::PVariable>> _metadata;
+	std::map<uint64_t, std::map<std::string, CachedMetadata>> _metadata;
+
+	/**
+	 * True when _metadata contains all metadata stored in the database. Otherwise _metadata only contains entries loaded on demand and getAllMetadata() queries the database.
+	 */
+	bool _metadataPreloaded = false;
+
+	/**
+	 * Sum of CachedMetadata::size of all entries in _metadata.
+	 */
+	int64_t _metadataCacheSize = 0;
+
+	/**
+	 * Number of metadata entries in the database. Only valid when _metadataPreloaded is true.
+	 */
+	int64_t _metadataCount = 0;
+
+	/**
+	 * Incremented on every metadata change. Entries read from the database are only cached, when nothing changed while reading.
+	 */
+	uint64_t _metadataChanges = 0;
+
+	/**
+	 * The last queued write removing metadata rows. Until it is executed, the database might still contain removed entries, so entries read from the database are not cached.
+	 */
+	std::weak_ptr<std::pair<std::string, BaseLib::Database::DataRow>> _lastMetadataRemoval;
+
+	/**
+	 * Checks if entries read from the database can be cached. _metadataMutex needs to be locked.
+	 *
+	 * @param changes The value of _metadataChanges before reading from the database.
+	 */
+	bool canCacheReadMetadata(uint64_t changes);
+
+	/**
+	 * Loads all metadata into _metadata with one query. When the metadata is larger than GD::metadataCacheSize, it is loaded on demand instead.
+	 */
+	void preloadMetadata();
+
+	/**
+	 * Inserts or replaces an entry in _metadata. _metadataMutex needs to be locked.
+	 *
+	 * @param force Set to true for written entries. They always replace existing entries and are always inserted, so reads never see older data than the write queue. When false (for entries read from the database), only missing entries are inserted and only when the cache stays below GD::metadataCacheSize.
+	 */
+	void cacheMetadata(uint64_t peerID, const std::string& dataID, BaseLib::PVariable& metadata, int64_t size, bool force = false);
+
+	/**
+	 * Removes written entries from _metadata until "size" more bytes fit into GD::metadataCacheSize. The entry identified by "peerID" and "dataID" is kept. _metadataMutex needs to be locked.
+	 */
+	void evictMetadata(int64_t size, uint64_t peerID, const std::string& dataID);
+	/* Metadata cache End */
+
+	/* Peer prefetching */
+	struct PrefetchedPeerData
+	{
+		int64_t time = 0;
+		std::shared_ptr<BaseLib::Database::DataTable> parameters;
+		std::shared_ptr<BaseLib::Database::DataTable> variables;
+		std::shared_ptr<BaseLib::Database::DataTable> serviceMessages;
+	};
+
+	/**
+	 * Prefetched data not requested within this time (in milliseconds) is discarded.
+	 */
+	static const int64_t _peerPrefetchTimeout = 60000;
+	std::mutex _prefetchedPeerDataMutex;
+	std::map<uint64_t, PrefetchedPeerData> _prefetchedPeerData;
+
+	/**
+	 * Number of prefetchPeerData() calls reading from the database right now. Protected by _prefetchedPeerDataMutex.
+	 */
+	int32_t _peerPrefetchesRunning = 0;
+
+	/**
+	 * Peers written to while a prefetch was running. Their rows read by the prefetch might be outdated, so they are not prefetched. Protected by _prefetchedPeerDataMutex.
+	 */
+	std::set<uint64_t> _peerPrefetchWrites;
+	bool _peerPrefetchWriteAll = false;
+
+	/**
+	 * Reads the parameters, variables and service messages of all peers of a central with three queries. The data is handed out once by getPeerParameters(), getPeerVariables() and getServiceMessages(), which are called by every peer while it is loaded.
+	 */
+	void prefetchPeerData(uint64_t deviceID, std::shared_ptr<BaseLib::Database::DataTable>& peers);
+	std::shared_ptr<BaseLib::Database::DataTable> getPrefetchedPeerData(uint64_t peerID, std::shared_ptr<BaseLib::Database::DataTable> PrefetchedPeerData::* table);
+	void removePrefetchedPeerData(uint64_t peerID);
+
+	/**
+	 * Discards prefetched rows of one table after it was written to, so getPeerParameters(), getPeerVariables() and getServiceMessages() read the current data from the database.
+	 *
+	 * @param peerID The ID of the peer written to or "0" for all peers.
+	 */
+	void invalidatePrefetchedPeerData(uint64_t peerID, std::shared_ptr<BaseLib::Database::DataTable> PrefetchedPeerData::* table);
+
+	/**
+	 * Peer rows read from the snapshot file, grouped by central ID (the "parent" column). Protected by _prefetchedPeerDataMutex.
+	 */
+	std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> _snapshotPeers;
+
+	/**
+	 * Parameters, variables and service messages read from the snapshot file. Moved to _prefetchedPeerData, when the central calls getPeers(). Protected by _prefetchedPeerDataMutex.
+	 */
+	std::map<uint64_t, PrefetchedPeerData> _snapshotPeerData;
+
+	/**
+	 * Peers whose parameters, variables or service messages were written to before the snapshot was taken. Their snapshot rows are outdated and not used. Protected by _prefetchedPeerDataMutex.
+	 */
+	std::set<uint64_t> _snapshotPeerWrites;
+	bool _snapshotPeerWriteAll = false;
+
+	/**
+	 * Discards the snapshot peer rows of a central, so the central reads its peers from the database. _prefetchedPeerDataMutex needs to be locked.
+	 *
+	 * @param parentID The ID of the central or "0" to find the central by "peerID".
+	 * @param peerID The ID of a peer of the central or "0".
+	 */
+	void discardSnapshotPeers(uint64_t parentID, uint64_t peerID);
+	std::map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> getRowsForParent(std::string command, uint64_t deviceID);
+	/* Peer prefetching End */
+
+	/* Peer snapshot */
+	/**
+	 * "variableIndex" of the generation counter in table homegearVariables. The counter is increased on every start, so a snapshot is only used when it was written by the previous run.
+	 */
+	static const int32_t _peerSnapshotGenerationIndex = 1000;
+	static const uint32_t _peerSnapshotVersion = 1;
+	int64_t _peerSnapshotGeneration = 0;
+
+	std::string getPeerSnapshotPath();
+	void loadPeerSnapshot();
+	bool readPeerSnapshot(const std::string& path, int64_t generation);
+	void writePeerSnapshot();
+	bool takePeerSnapshot(uint64_t deviceID, std::shared_ptr<BaseLib::Database::DataTable>& peers);
+	/* Peer snapshot End */
 
 	/* Queueing */
 	static const int32_t _queueSize = 100000;
@@ -155,8 +386,33 @@ protected:
 	bool _queueEntryAvailable = false;
 	std::condition_variable _queueConditionVariable;
 	bool _stopQueueProcessingThread = false;
+	Metrics::PHistogram _writeDuration;
+
+	/**
+	 * Queues a database write.
+	 *
+	 * @return Returns the queued entry or nullptr, when the queue is full. The entry is released after it was written.
+	 */
+	std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>> bufferedWrite(std::string command, BaseLib::Database::DataRow& data);
+
+	/**
+	 * Adds an entry to the queue. _queueMutex needs to be locked and _queueConditionVariable needs to be notified afterwards.
+	 *
+	 * @return Returns the queued entry or nullptr, when the queue is full.
+	 */
+	std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>> enqueue(std::string& command, BaseLib::Database::DataRow& data);
+
+	/**
+	 * System variables waiting in the queue. Setting a variable again before it is written only replaces the data of the queued entry. Protected by _queueMutex.
+	 */
+	std::map<std::string, std::shared_ptr<std::pair<std::string, BaseLib::Database::DataRow>>> _queuedSystemVariables;
 
-	void bufferedWrite(std::string command, BaseLib::Database::DataRow& data);
+	/**
+	 * Queues an upsert of a system variable or merges it with an upsert of the same variable which is still queued.
+	 *
+	 * @param data The variable ID and the encoded value.
+	 */
+	void bufferedSystemVariableWrite(const std::string& variableID, BaseLib::Database::DataRow& data);
 	void processQueueEntry();
 	/* Queueing End */
 };
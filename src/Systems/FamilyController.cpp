@@ -176,6 +176,7 @@ std::unique_ptr<BaseLib::Systems::DeviceFamily> ModuleLoader::createModule(BaseL
 
 FamilyController::FamilyController()
 {
+	_valueChangeEpoch = BaseLib::HelperFunctions::getRandomNumber(1, 2147483647);
 }
 
 FamilyController::~FamilyController()
@@ -243,6 +244,7 @@ void FamilyController::onRPCNewDevices(BaseLib::PVariable deviceDescriptions)
 {
 	try
 	{
+		updatePeerIndex(deviceDescriptions, false);
 		GD::rpcClient->broadcastNewDevices(deviceDescriptions);
 	}
 	catch(const std::exception& ex)
@@ -263,6 +265,7 @@ void FamilyController::onRPCDeleteDevices(BaseLib::PVariable deviceAddresses, Ba
 {
 	try
 	{
+		updatePeerIndex(deviceInfo, true);
 		GD::rpcClient->broadcastDeleteDevices(deviceAddresses, deviceInfo);
 	}
 	catch(const std::exception& ex)
@@ -286,6 +289,7 @@ void FamilyController::onEvent(uint64_t peerID, int32_t channel, std::shared_ptr
 #ifdef EVENTHANDLER
 		GD::eventHandler->trigger(peerID, channel, variables, values);
 #endif
+		addValueChanges(peerID, channel, variables, values);
 		GD::scriptEngineServer->broadcastEvent(peerID, channel, variables, values);
 	}
 	catch(const std::exception& ex)
@@ -302,6 +306,109 @@ void FamilyController::onEvent(uint64_t peerID, int32_t channel, std::shared_ptr
 	}
 }
 
+void FamilyController::addValueChanges(uint64_t peerID, int32_t channel, std::shared_ptr<std::vector<std::string>>& variables, std::shared_ptr<std::vector<BaseLib::PVariable>>& values)
+{
+	try
+	{
+		if(!variables || !values || variables->size() != values->size()) return;
+		std::lock_guard<std::mutex> valueChangesGuard(_valueChangesMutex);
+		for(uint32_t i = 0; i < variables->size(); ++i)
+		{
+			if(_valueChangeSequence == 2147483647)
+			{
+				//Start over in a new epoch, so all clients are asked to do a full sync.
+				_valueChanges.clear();
+				_valueChangesByVariable.clear();
+				_valueChangeSequence = 0;
+				_minimumValueChangeSequence = 0;
+				int32_t epoch = _valueChangeEpoch;
+				while(_valueChangeEpoch == epoch) _valueChangeEpoch = BaseLib::HelperFunctions::getRandomNumber(1, 2147483647);
+			}
+
+			PValueChange& change = _valueChangesByVariable[peerID][channel][variables->at(i)];
+			if(change) _valueChanges.erase(change->sequence);
+			else
+			{
+				change.reset(new ValueChange());
+				change->peerId = peerID;
+				change->channel = channel;
+				change->variable = variables->at(i);
+			}
+			change->sequence = ++_valueChangeSequence;
+			change->value = values->at(i);
+			_valueChanges[change->sequence] = change;
+		}
+
+		while(_valueChanges.size() > _maxValueChanges)
+		{
+			PValueChange oldestChange = _valueChanges.begin()->second;
+			_valueChanges.erase(_valueChanges.begin());
+			_minimumValueChangeSequence = oldestChange->sequence;
+			std::map<int32_t, std::map<std::string, PValueChange>>& channels = _valueChangesByVariable[oldestChange->peerId];
+			channels[oldestChange->channel].erase(oldestChange->variable);
+			if(channels[oldestChange->channel].empty()) channels.erase(oldestChange->channel);
+			if(channels.empty()) _valueChangesByVariable.erase(oldestChange->peerId);
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+BaseLib::PVariable FamilyController::getValuesChangedSince(int32_t epoch, int32_t sequence)
+{
+	try
+	{
+		BaseLib::PVariable result(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+		BaseLib::PVariable changes(new BaseLib::Variable(BaseLib::VariableType::tArray));
+		std::lock_guard<std::mutex> valueChangesGuard(_valueChangesMutex);
+		result->structValue->insert(BaseLib::StructElement("EPOCH", BaseLib::PVariable(new BaseLib::Variable(_valueChangeEpoch))));
+		result->structValue->insert(BaseLib::StructElement("SEQUENCE", BaseLib::PVariable(new BaseLib::Variable(_valueChangeSequence))));
+		if(epoch != _valueChangeEpoch || sequence < _minimumValueChangeSequence || sequence > _valueChangeSequence)
+		{
+			result->structValue->insert(BaseLib::StructElement("FULL_SYNC", BaseLib::PVariable(new BaseLib::Variable(true))));
+			result->structValue->insert(BaseLib::StructElement("VALUES", changes));
+			return result;
+		}
+
+		changes->arrayValue->reserve(_valueChangeSequence - sequence);
+		for(std::map<int32_t, PValueChange>::iterator i = _valueChanges.upper_bound(sequence); i != _valueChanges.end(); ++i)
+		{
+			BaseLib::PVariable change(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+			change->structValue->insert(BaseLib::StructElement("PEERID", BaseLib::PVariable(new BaseLib::Variable((int64_t)i->second->peerId))));
+			change->structValue->insert(BaseLib::StructElement("CHANNEL", BaseLib::PVariable(new BaseLib::Variable(i->second->channel))));
+			change->structValue->insert(BaseLib::StructElement("VARIABLE", BaseLib::PVariable(new BaseLib::Variable(i->second->variable))));
+			change->structValue->insert(BaseLib::StructElement("VALUE", i->second->value));
+			changes->arrayValue->push_back(change);
+		}
+		result->structValue->insert(BaseLib::StructElement("FULL_SYNC", BaseLib::PVariable(new BaseLib::Variable(false))));
+		result->structValue->insert(BaseLib::StructElement("VALUES", changes));
+		return result;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	return BaseLib::Variable::createError(-32500, "Unknown application error.");
+}
+
 void FamilyController::onRunScript(PScriptInfo& scriptInfo, bool wait)
 {
 	try
@@ -526,12 +633,14 @@ int32_t FamilyController::loadModule(std::string filename)
 			BaseLib::HelperFunctions::toLower(name);
 			BaseLib::HelperFunctions::stringReplace(name, " ", "");
 			_families[family->getFamily()] = family;
+			updateFamiliesSnapshot();
 			if(!familyAvailable(family->getFamily()) || !family->init())
 			{
 				if(familyAvailable(family->getFamily())) GD::out.printError("Error: Could not initialize device family " + family->getName() + ".");
 				else GD::out.printInfo("Info: Not initializing device family " + family->getName() + ", because no physical interface was found.");
 				_families[family->getFamily()]->dispose();
 				_families[family->getFamily()].reset();
+				updateFamiliesSnapshot();
 				family.reset();
 				_moduleLoaders.at(filename)->dispose();
 				_moduleLoaders.erase(filename);
@@ -599,6 +708,7 @@ int32_t FamilyController::unloadModule(std::string filename)
 			_familiesMutex.lock();
 			familyIterator->second->lock();
 			_familiesMutex.unlock();
+			updateFamiliesSnapshot(); //Release the snapshot's reference, otherwise use_count() never drops to 1
 			familyIterator->second->homegearShuttingDown();
 			familyIterator->second->physicalInterfaces()->stopListening();
 			while(familyIterator->second.use_count() > 1)
@@ -608,6 +718,7 @@ int32_t FamilyController::unloadModule(std::string filename)
 			familyIterator->second->save(false);
 			familyIterator->second->dispose();
 			familyIterator->second.reset();
+			updateFamiliesSnapshot();
 		}
 
 		moduleLoaderIterator->second->dispose();
@@ -701,6 +812,7 @@ void FamilyController::loadModules()
 				_moduleLoaders.erase(*i);
 			}
 		}
+		updateFamiliesSnapshot();
 		if(_families.empty())
 		{
 			GD::out.printCritical("Critical: Could not load any family modules from \"" + GD::bl->settings.modulePath() + "\".");
@@ -725,6 +837,8 @@ void FamilyController::load()
 {
 	try
 	{
+		int64_t startTime = BaseLib::HelperFunctions::getTime();
+		std::vector<std::shared_ptr<BaseLib::Systems::DeviceFamily>> familiesToLoad;
 		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = getFamilies();
 		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
 		{
@@ -735,6 +849,7 @@ void FamilyController::load()
 				i->second->dispose();
 				i->second.reset();
 				_families[i->first].reset();
+				updateFamiliesSnapshot();
 				_moduleLoadersMutex.lock();
 				std::map<std::string, std::unique_ptr<ModuleLoader>>::iterator moduleIterator = _moduleLoaders.find(_moduleFilenames[i->first]);
 				if(moduleIterator != _moduleLoaders.end())
@@ -745,7 +860,120 @@ void FamilyController::load()
 				_moduleLoadersMutex.unlock();
 				continue;
 			}
-			i->second->load();
+			familiesToLoad.push_back(i->second);
+		}
+		families.clear();
+		if(familiesToLoad.empty()) return;
+
+		{
+			std::lock_guard<std::mutex> familiesGuard(_familiesMutex);
+			for(std::vector<std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = familiesToLoad.begin(); i != familiesToLoad.end(); ++i)
+			{
+				_loadingFamilies.insert((*i)->getFamily());
+			}
+		}
+		updateFamiliesSnapshot();
+
+		uint32_t threadCount = std::min((uint32_t)familiesToLoad.size(), (uint32_t)_maxFamilyLoadThreads);
+		{
+			std::lock_guard<std::mutex> familyLoadQueueGuard(_familyLoadQueueMutex);
+			_familyLoadQueue.swap(familiesToLoad);
+		}
+
+		std::lock_guard<std::mutex> familyLoadThreadsGuard(_familyLoadThreadsMutex);
+		_familyLoadStartTime = startTime;
+		_familyLoadThreads.reserve(threadCount);
+		for(uint32_t i = 0; i < threadCount; i++)
+		{
+			_familyLoadThreads.emplace_back();
+			if(!GD::bl->threadManager.start(_familyLoadThreads.back(), true, &FamilyController::loadFamiliesThread, this))
+			{
+				_familyLoadThreads.pop_back();
+				break;
+			}
+		}
+		//Load the families synchronously if no thread could be started.
+		if(_familyLoadThreads.empty()) loadFamiliesThread();
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+void FamilyController::waitForFamiliesLoaded()
+{
+	try
+	{
+		std::lock_guard<std::mutex> familyLoadThreadsGuard(_familyLoadThreadsMutex);
+		if(_familyLoadThreads.empty()) return;
+		for(std::vector<std::thread>::iterator i = _familyLoadThreads.begin(); i != _familyLoadThreads.end(); ++i)
+		{
+			GD::bl->threadManager.join(*i);
+		}
+		_familyLoadThreads.clear();
+		GD::out.printInfo("Info: All device families loaded in " + std::to_string(BaseLib::HelperFunctions::getTime() - _familyLoadStartTime) + " ms.");
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+void FamilyController::loadFamiliesThread()
+{
+	try
+	{
+		while(true)
+		{
+			std::shared_ptr<BaseLib::Systems::DeviceFamily> family;
+			{
+				std::lock_guard<std::mutex> familyLoadQueueGuard(_familyLoadQueueMutex);
+				if(_familyLoadQueue.empty()) return;
+				family = _familyLoadQueue.back();
+				_familyLoadQueue.pop_back();
+			}
+
+			int64_t startTime = BaseLib::HelperFunctions::getTime();
+			try
+			{
+				family->load();
+			}
+			catch(const std::exception& ex)
+			{
+				GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+			}
+			catch(BaseLib::Exception& ex)
+			{
+				GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+			}
+			catch(...)
+			{
+				GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+			}
+			GD::out.printInfo("Info: Device family " + family->getName() + " loaded in " + std::to_string(BaseLib::HelperFunctions::getTime() - startTime) + " ms.");
+
+			{
+				std::lock_guard<std::mutex> familiesGuard(_familiesMutex);
+				_loadingFamilies.erase(family->getFamily());
+			}
+			updateFamiliesSnapshot();
 		}
 	}
 	catch(const std::exception& ex)
@@ -766,16 +994,32 @@ void FamilyController::disposeDeviceFamilies()
 {
 	try
 	{
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = getFamilies();
+		//Families that haven't started loading yet are not loaded anymore. The ones being loaded are finished first.
+		{
+			std::lock_guard<std::mutex> familyLoadQueueGuard(_familyLoadQueueMutex);
+			_familyLoadQueue.clear();
+		}
+		waitForFamiliesLoaded();
+
+		//Not getFamilies(), because it doesn't contain families that were never loaded.
+		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families;
+		{
+			std::lock_guard<std::mutex> familiesGuard(_familiesMutex);
+			families = _families;
+		}
 		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
 		{
 			if(!i->second) continue;
 			i->second->dispose();
 			i->second.reset();
-			_families[i->first].reset();
 		}
 		families.clear();
-		_families.clear();
+		{
+			std::lock_guard<std::mutex> familiesGuard(_familiesMutex);
+			_families.clear();
+			_loadingFamilies.clear();
+		}
+		updateFamiliesSnapshot();
 	}
 	catch(const std::exception& ex)
     {
@@ -797,11 +1041,17 @@ void FamilyController::dispose()
 	{
 		if(_disposed) return;
 		_disposed = true;
+		{
+			std::lock_guard<std::mutex> familyLoadQueueGuard(_familyLoadQueueMutex);
+			_familyLoadQueue.clear();
+		}
+		waitForFamiliesLoaded();
 		_rpcCache.reset();
 		_familiesMutex.lock();
 		_currentFamily.reset();
 		_families.clear();
 		_familiesMutex.unlock();
+		updateFamiliesSnapshot();
 		_moduleLoadersMutex.lock();
 		_moduleLoaders.clear();
 		_moduleLoadersMutex.unlock();
@@ -820,14 +1070,18 @@ void FamilyController::dispose()
     }
 }
 
-bool FamilyController::lifetick()
+bool FamilyController::lifetick(LifetickInfo& info)
 {
 	try
 	{
 		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = getFamilies();
 		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
 		{
-			if(!i->second->lifetick()) return false;
+			int64_t startTime = BaseLib::HelperFunctions::getTime();
+			bool result = i->second->lifetick();
+			int64_t duration = BaseLib::HelperFunctions::getTime() - startTime;
+			if(duration > info.stallTime) info.stallTime = duration;
+			if(!result) return false;
 		}
 		return true;
 	}
@@ -870,18 +1124,20 @@ void FamilyController::save(bool full)
     }
 }
 
-std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> FamilyController::getFamilies()
+void FamilyController::updateFamiliesSnapshot()
 {
-	std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families;
 	try
 	{
-		_familiesMutex.lock();
+		std::shared_ptr<std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>> families(new std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>());
+		std::lock_guard<std::mutex> familiesGuard(_familiesMutex);
 		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = _families.begin(); i != _families.end(); ++i)
 		{
-			if(!i->second || i->second->locked()) continue;
-			families.insert(*i);
+			if(!i->second || i->second->locked() || _loadingFamilies.find(i->first) != _loadingFamilies.end()) continue;
+			families->insert(*i);
 		}
-		_familiesMutex.unlock();
+		std::atomic_store(&_familiesSnapshot, std::shared_ptr<const std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>>(families));
+		//Peers of a family that just became visible are unknown to the index.
+		clearPeerIndexMisses();
 	}
 	catch(const std::exception& ex)
     {
@@ -895,24 +1151,45 @@ std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> FamilyControl
     {
         GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
     }
-    return families;
+}
+
+std::shared_ptr<const std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>> FamilyController::getFamiliesSnapshot()
+{
+	std::shared_ptr<const std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>> families = std::atomic_load(&_familiesSnapshot);
+	if(!families) return std::shared_ptr<const std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>>(new std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>());
+	return families;
+}
+
+std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> FamilyController::getFamilies()
+{
+	try
+	{
+		std::shared_ptr<const std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>> families = std::atomic_load(&_familiesSnapshot);
+		if(families) return *families;
+	}
+	catch(const std::exception& ex)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>();
 }
 
 std::shared_ptr<BaseLib::Systems::DeviceFamily> FamilyController::getFamily(int32_t familyId)
 {
 	try
 	{
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator familyIterator = _families.find(familyId);
-		std::shared_ptr<BaseLib::Systems::DeviceFamily> family;
-		if(familyIterator != _families.end()) family = familyIterator->second;
-		if(!family) return std::shared_ptr<BaseLib::Systems::DeviceFamily>();
-		_familiesMutex.lock();
-		if(!family->locked())
-		{
-			_familiesMutex.unlock();
-			return family;
-		}
-		_familiesMutex.unlock();
+		std::shared_ptr<const std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>> families = std::atomic_load(&_familiesSnapshot);
+		if(!families) return std::shared_ptr<BaseLib::Systems::DeviceFamily>();
+		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::const_iterator familyIterator = families->find(familyId);
+		if(familyIterator != families->end() && !familyIterator->second->locked()) return familyIterator->second;
 	}
 	catch(const std::exception& ex)
     {
@@ -930,20 +1207,184 @@ std::shared_ptr<BaseLib::Systems::DeviceFamily> FamilyController::getFamily(int3
 }
 
 bool FamilyController::peerExists(uint64_t peerId)
+{
+	return (bool)getCentral(peerId);
+}
+
+std::shared_ptr<BaseLib::Systems::ICentral> FamilyController::getCentral(uint64_t peerId)
 {
 	try
 	{
-		std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> families = getFamilies();
-		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::iterator i = families.begin(); i != families.end(); ++i)
+		int32_t familyId = -1;
+		uint64_t peerIndexGeneration = 0;
+		{
+			std::lock_guard<std::mutex> peerIndexGuard(_peerIndexMutex);
+			std::map<uint64_t, int32_t>::iterator indexIterator = _familyByPeerId.find(peerId);
+			if(indexIterator != _familyByPeerId.end()) familyId = indexIterator->second;
+			else if(_unknownPeerIds.find(peerId) != _unknownPeerIds.end()) return std::shared_ptr<BaseLib::Systems::ICentral>();
+			peerIndexGeneration = _peerIndexGeneration;
+		}
+		//Loaded after the generation, so a family that becomes visible in between invalidates the miss stored below.
+		std::shared_ptr<const std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>> families = getFamiliesSnapshot();
+		if(familyId != -1)
 		{
+			std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::const_iterator familyIterator = families->find(familyId);
+			if(familyIterator != families->end() && !familyIterator->second->locked())
+			{
+				std::shared_ptr<BaseLib::Systems::ICentral> central = familyIterator->second->getCentral();
+				if(central && central->peerExists(peerId)) return central;
+			}
+		}
+
+		//Not indexed yet or the index entry is outdated
+		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::const_iterator i = families->begin(); i != families->end(); ++i)
+		{
+			if(i->first == familyId || i->second->locked()) continue;
 			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
-			if(central)
+			if(central && central->peerExists(peerId))
 			{
-				if(central->peerExists(peerId))
-				{
-					if(i->second->locked()) return false;
-					return true;
-				}
+				std::lock_guard<std::mutex> peerIndexGuard(_peerIndexMutex);
+				_familyByPeerId[peerId] = i->first;
+				return central;
+			}
+		}
+		{
+			std::lock_guard<std::mutex> peerIndexGuard(_peerIndexMutex);
+			if(familyId != -1) _familyByPeerId.erase(peerId);
+			if(peerIndexGeneration == _peerIndexGeneration)
+			{
+				if(_unknownPeerIds.size() >= _maxPeerIndexMisses) _unknownPeerIds.clear();
+				_unknownPeerIds.insert(peerId);
+			}
+		}
+	}
+	catch(const std::exception& ex)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return std::shared_ptr<BaseLib::Systems::ICentral>();
+}
+
+std::shared_ptr<BaseLib::Systems::ICentral> FamilyController::getCentral(const std::string& serialNumber)
+{
+	try
+	{
+		int32_t familyId = -1;
+		uint64_t peerIndexGeneration = 0;
+		{
+			std::lock_guard<std::mutex> peerIndexGuard(_peerIndexMutex);
+			std::map<std::string, int32_t>::iterator indexIterator = _familyBySerialNumber.find(serialNumber);
+			if(indexIterator != _familyBySerialNumber.end()) familyId = indexIterator->second;
+			else if(_unknownSerialNumbers.find(serialNumber) != _unknownSerialNumbers.end()) return std::shared_ptr<BaseLib::Systems::ICentral>();
+			peerIndexGeneration = _peerIndexGeneration;
+		}
+		std::shared_ptr<const std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>> families = getFamiliesSnapshot();
+		if(familyId != -1)
+		{
+			std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::const_iterator familyIterator = families->find(familyId);
+			if(familyIterator != families->end() && !familyIterator->second->locked())
+			{
+				std::shared_ptr<BaseLib::Systems::ICentral> central = familyIterator->second->getCentral();
+				if(central && central->peerExists(serialNumber)) return central;
+			}
+		}
+
+		//Not indexed yet or the index entry is outdated
+		for(std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>::const_iterator i = families->begin(); i != families->end(); ++i)
+		{
+			if(i->first == familyId || i->second->locked()) continue;
+			std::shared_ptr<BaseLib::Systems::ICentral> central = i->second->getCentral();
+			if(central && central->peerExists(serialNumber))
+			{
+				std::lock_guard<std::mutex> peerIndexGuard(_peerIndexMutex);
+				_familyBySerialNumber[serialNumber] = i->first;
+				return central;
+			}
+		}
+		{
+			std::lock_guard<std::mutex> peerIndexGuard(_peerIndexMutex);
+			if(familyId != -1) _familyBySerialNumber.erase(serialNumber);
+			if(peerIndexGeneration == _peerIndexGeneration)
+			{
+				if(_unknownSerialNumbers.size() >= _maxPeerIndexMisses) _unknownSerialNumbers.clear();
+				_unknownSerialNumbers.insert(serialNumber);
+			}
+		}
+	}
+	catch(const std::exception& ex)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+    return std::shared_ptr<BaseLib::Systems::ICentral>();
+}
+
+void FamilyController::clearPeerIndexMisses()
+{
+	try
+	{
+		std::lock_guard<std::mutex> peerIndexGuard(_peerIndexMutex);
+		_unknownPeerIds.clear();
+		_unknownSerialNumbers.clear();
+		_peerIndexGeneration++;
+	}
+	catch(const std::exception& ex)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+void FamilyController::updatePeerIndex(BaseLib::PVariable& deviceDescriptions, bool remove)
+{
+	try
+	{
+		if(!deviceDescriptions || deviceDescriptions->type != BaseLib::VariableType::tArray) return;
+		std::lock_guard<std::mutex> peerIndexGuard(_peerIndexMutex);
+		if(!remove) _peerIndexGeneration++;
+		for(BaseLib::Array::iterator i = deviceDescriptions->arrayValue->begin(); i != deviceDescriptions->arrayValue->end(); ++i)
+		{
+			if((*i)->type != BaseLib::VariableType::tStruct) continue;
+			BaseLib::Struct::iterator idIterator = (*i)->structValue->find("ID");
+			BaseLib::Struct::iterator addressIterator = (*i)->structValue->find("ADDRESS");
+			BaseLib::Struct::iterator familyIterator = (*i)->structValue->find("FAMILY");
+			std::string serialNumber;
+			if(addressIterator != (*i)->structValue->end() && addressIterator->second->stringValue.find(':') == std::string::npos) serialNumber = addressIterator->second->stringValue;
+			if(remove)
+			{
+				if(idIterator != (*i)->structValue->end()) _familyByPeerId.erase((uint64_t)idIterator->second->integerValue);
+				if(!serialNumber.empty()) _familyBySerialNumber.erase(serialNumber);
+			}
+			else if(familyIterator != (*i)->structValue->end())
+			{
+				//Channel descriptions have an address containing ":" and are skipped.
+				if(serialNumber.empty()) continue;
+				if(idIterator != (*i)->structValue->end()) _unknownPeerIds.erase((uint64_t)idIterator->second->integerValue);
+				_unknownSerialNumbers.erase(serialNumber);
+				if(idIterator != (*i)->structValue->end()) _familyByPeerId[(uint64_t)idIterator->second->integerValue] = familyIterator->second->integerValue;
+				_familyBySerialNumber[serialNumber] = familyIterator->second->integerValue;
 			}
 		}
 	}
@@ -959,7 +1400,6 @@ bool FamilyController::peerExists(uint64_t peerId)
     {
         GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
     }
-    return false;
 }
 
 std::string FamilyController::handleCliCommand(std::string& command)
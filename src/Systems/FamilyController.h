@@ -32,6 +32,7 @@
 #define FAMILYCONTROLLER_H_
 
 #include "homegear-base/BaseLib.h"
+#include "../Monitor.h"
 
 #include <string>
 #include <iostream>
@@ -99,7 +100,14 @@ public:
 	virtual ~FamilyController();
 	void disposeDeviceFamilies();
 	void dispose();
-	bool lifetick();
+
+	/**
+	 * Calls the lifetick method of all device families.
+	 *
+	 * @param info Is filled with the time in milliseconds the slowest lifetick call of a family took. A slow call means the family's locks are held for a long time.
+	 * @return Returns false when one of the families hangs.
+	 */
+	bool lifetick(LifetickInfo& info);
 
 	/**
 	 * Returns a vector of type ModuleInfo with information about all loaded and not loaded modules.
@@ -130,17 +138,37 @@ public:
 	int32_t reloadModule(std::string filename);
 
 	void loadModules();
+
+	/**
+	 * Initializes all families and starts loading their peers in the background. Independent families are loaded concurrently. A family becomes
+	 * visible through getFamilies() as soon as it is loaded.
+	 */
 	void load();
+
+	/**
+	 * Waits until all families started by load() are loaded.
+	 */
+	void waitForFamiliesLoaded();
+
+	/**
+	 * Forgets all peer IDs and serial numbers that were not found. Needs to be called when peers are added or their ID changes.
+	 */
+	void clearPeerIndexMisses();
 	void save(bool full);
 	bool familySelected() { return (bool)_currentFamily; }
 	std::string handleCliCommand(std::string& command);
 	bool familyAvailable(int32_t family);
 
 	/*
-	 * Returns the family map.
+	 * Returns a copy of the family map.
 	 */
 	std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> getFamilies();
 
+	/*
+	 * Returns the current family map without locking or copying. The returned map is never modified, so it can be iterated while families are loaded or unloaded. Don't keep it longer than necessary, as it holds references to the families.
+	 */
+	std::shared_ptr<const std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>> getFamiliesSnapshot();
+
 	/*
 	 * Returns the device family specified by familyId.
 	 */
@@ -151,6 +179,16 @@ public:
 	 */
 	bool peerExists(uint64_t peerId);
 
+	/*
+	 * Returns the central the peer with the provided id belongs to or nullptr if the peer doesn't exist. The family is taken from the peer index, so no family needs to be searched in the common case.
+	 */
+	std::shared_ptr<BaseLib::Systems::ICentral> getCentral(uint64_t peerId);
+
+	/*
+	 * Returns the central the peer with the provided serial number belongs to or nullptr if the peer doesn't exist.
+	 */
+	std::shared_ptr<BaseLib::Systems::ICentral> getCentral(const std::string& serialNumber);
+
 	/*
      * Executed when Homegear is fully started.
      */
@@ -172,7 +210,31 @@ public:
 	// }}}
 
 	BaseLib::PVariable listFamilies();
+
+	/**
+	 * Returns all variable values that changed after the provided change sequence number.
+	 *
+	 * @param epoch The value of "EPOCH" returned by the last call. Sequence numbers are only comparable within one epoch. A new epoch starts on every start of Homegear and when the sequence number overflows.
+	 * @param sequence The value of "SEQUENCE" returned by the last call.
+	 * @return Returns a struct with the current epoch ("EPOCH"), the current sequence number ("SEQUENCE") and an array of changed values ("VALUES"). When "epoch" doesn't match or the changes since "sequence" are not available anymore, "FULL_SYNC" is set to true and no values are returned. In this case the client needs to read all values (e. g. using getAllValues).
+	 */
+	BaseLib::PVariable getValuesChangedSince(int32_t epoch, int32_t sequence);
 private:
+	struct ValueChange
+	{
+		int32_t sequence = 0;
+		uint64_t peerId = 0;
+		int32_t channel = -1;
+		std::string variable;
+		BaseLib::PVariable value;
+	};
+	typedef std::shared_ptr<ValueChange> PValueChange;
+
+	/**
+	 * The maximum number of variables kept in the change log. When exceeded, the oldest changes are removed.
+	 */
+	static const uint32_t _maxValueChanges = 100000;
+
 	bool _disposed = false;
 	BaseLib::PVariable _rpcCache;
 
@@ -183,8 +245,61 @@ private:
 
 	std::mutex _familiesMutex;
 	std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>> _families;
+
+	/**
+	 * The maximum number of families loaded concurrently by load().
+	 */
+	static const uint32_t _maxFamilyLoadThreads = 4;
+
+	/**
+	 * Families that are initialized, but not loaded yet. They are excluded from _familiesSnapshot. Protected by _familiesMutex.
+	 */
+	std::set<int32_t> _loadingFamilies;
+
+	std::mutex _familyLoadQueueMutex;
+	std::vector<std::shared_ptr<BaseLib::Systems::DeviceFamily>> _familyLoadQueue;
+	std::mutex _familyLoadThreadsMutex;
+	std::vector<std::thread> _familyLoadThreads;
+	int64_t _familyLoadStartTime = 0;
+
+	/**
+	 * Immutable copy of the valid, unlocked and loaded entries of _families. Only accessed with std::atomic_load and std::atomic_store.
+	 */
+	std::shared_ptr<const std::map<int32_t, std::shared_ptr<BaseLib::Systems::DeviceFamily>>> _familiesSnapshot;
 	std::shared_ptr<BaseLib::Systems::DeviceFamily> _currentFamily;
 
+	/**
+	 * Maps peer IDs and serial numbers to family IDs. Entries are only hints: They are verified on every lookup, so stale entries (e. g. after a peer's ID was changed) just cause a search over all families.
+	 */
+	std::mutex _peerIndexMutex;
+	std::map<uint64_t, int32_t> _familyByPeerId;
+	std::map<std::string, int32_t> _familyBySerialNumber;
+
+	/**
+	 * Peer IDs and serial numbers no family knows, so repeated lookups of unknown peers don't search all families every time. Cleared by
+	 * clearPeerIndexMisses(). _peerIndexGeneration is incremented on every clear, so a search that started before a peer was added doesn't
+	 * store a miss afterwards. Protected by _peerIndexMutex.
+	 */
+	std::set<uint64_t> _unknownPeerIds;
+	std::set<std::string> _unknownSerialNumbers;
+	uint64_t _peerIndexGeneration = 0;
+	const size_t _maxPeerIndexMisses = 10000;
+
+	std::mutex _valueChangesMutex;
+	int32_t _valueChangeEpoch = 0;
+	int32_t _valueChangeSequence = 0;
+	int32_t _minimumValueChangeSequence = 0;
+	std::map<int32_t, PValueChange> _valueChanges;
+	std::map<uint64_t, std::map<int32_t, std::map<std::string, PValueChange>>> _valueChangesByVariable;
+
+	/**
+	 * Rebuilds _familiesSnapshot. Needs to be called after every change to _families or when a family is locked.
+	 */
+	void updateFamiliesSnapshot();
+	void loadFamiliesThread();
+	void updatePeerIndex(BaseLib::PVariable& deviceDescriptions, bool remove);
+	void addValueChanges(uint64_t peerID, int32_t channel, std::shared_ptr<std::vector<std::string>>& variables, std::shared_ptr<std::vector<BaseLib::PVariable>>& values);
+
 	FamilyController(const FamilyController&);
 	FamilyController& operator=(const FamilyController&);
 };
@@ -0,0 +1,206 @@
+/* Copyright 2013-2016 Sathya Laufer
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Homegear.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ * 
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "SystemVariableNotifier.h"
+#include "../GD/GD.h"
+
+namespace
+{
+	/**
+	 * True on the thread processing the queue. Notifications triggered from there can't wait for the queue.
+	 */
+	thread_local bool isQueueThread = false;
+}
+
+SystemVariableNotifier::SystemVariableNotifier() : BaseLib::IQueue(GD::bl.get(), 1000)
+{
+	_started = false;
+	_queueDepth = GD::metrics.queueDepth("systemVariableNotifier");
+}
+
+SystemVariableNotifier::~SystemVariableNotifier()
+{
+	stop();
+}
+
+void SystemVariableNotifier::start()
+{
+	try
+	{
+		if(_started) return;
+		_started = true;
+		startQueue(0, 1, 0, SCHED_OTHER);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+void SystemVariableNotifier::stop()
+{
+	try
+	{
+		if(!_started) return;
+		_started = false;
+		stopQueue(0);
+		_queueDepth->clear();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+void SystemVariableNotifier::notify(std::shared_ptr<std::vector<std::string>>& variableIDs, std::shared_ptr<std::vector<BaseLib::PVariable>>& values, bool deleted, bool wait)
+{
+	try
+	{
+		if(!variableIDs || !values || variableIDs->empty()) return;
+		if(!_started || isQueueThread)
+		{
+			//Nothing is queued when the queue is stopped. Notifications from the queue thread itself are a consequence of the notification being processed, so they are sent right away.
+			send(variableIDs, values, deleted);
+			return;
+		}
+		std::shared_ptr<QueueEntry> queueEntry(new QueueEntry(variableIDs, values, deleted));
+		std::future<void> processed;
+		if(wait)
+		{
+			queueEntry->processed.reset(new std::promise<void>());
+			processed = queueEntry->processed->get_future();
+		}
+		std::shared_ptr<BaseLib::IQueueEntry> entry = queueEntry;
+		_queueDepth->increment();
+		if(!enqueue(0, entry))
+		{
+			//Queue is full. Wait for space instead of sending the notification out of order.
+			GD::out.printWarning("Warning: Too many system variable notifications are queued. Waiting for the queue.");
+			std::unique_lock<std::mutex> queueSpaceGuard(_queueSpaceMutex);
+			while(!enqueue(0, entry))
+			{
+				if(!_started)
+				{
+					queueSpaceGuard.unlock();
+					_queueDepth->decrement();
+					send(variableIDs, values, deleted);
+					return;
+				}
+				_queueSpaceConditionVariable.wait_for(queueSpaceGuard, std::chrono::milliseconds(100));
+			}
+		}
+		if(wait) processed.wait();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+void SystemVariableNotifier::send(std::shared_ptr<std::vector<std::string>>& variableIDs, std::shared_ptr<std::vector<BaseLib::PVariable>>& values, bool deleted)
+{
+	try
+	{
+#ifdef EVENTHANDLER
+		if(!deleted)
+		{
+			for(uint32_t i = 0; i < variableIDs->size() && i < values->size(); i++)
+			{
+				GD::eventHandler->trigger(variableIDs->at(i), values->at(i));
+			}
+		}
+#endif
+		//All keys in one call. The values are shared by all subscribers and encoded to JSON once for MQTT.
+		if(GD::rpcClient) GD::rpcClient->broadcastEvent(0, -1, "", variableIDs, values);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+void SystemVariableNotifier::processQueueEntry(int32_t index, std::shared_ptr<BaseLib::IQueueEntry>& entry)
+{
+	try
+	{
+		_queueDepth->decrement();
+		_queueSpaceConditionVariable.notify_all();
+		std::shared_ptr<QueueEntry> queueEntry;
+		queueEntry = std::dynamic_pointer_cast<QueueEntry>(entry);
+		if(!queueEntry) return;
+		isQueueThread = true;
+		send(queueEntry->variableIDs, queueEntry->values, queueEntry->deleted);
+		if(queueEntry->processed) queueEntry->processed->set_value();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(const BaseLib::Exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
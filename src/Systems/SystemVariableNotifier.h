@@ -0,0 +1,90 @@
+/* Copyright 2013-2016 Sathya Laufer
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Homegear.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ * 
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#ifndef SYSTEMVARIABLENOTIFIER_H_
+#define SYSTEMVARIABLENOTIFIER_H_
+
+#include "homegear-base/BaseLib.h"
+#include "../Metrics/Metrics.h"
+
+#include <atomic>
+#include <future>
+
+/**
+ * Sends system variable changes to the event handler and to all RPC clients (including MQTT) on a separate thread, so the thread setting the variable doesn't wait for the subscribers.
+ */
+class SystemVariableNotifier : public BaseLib::IQueue
+{
+public:
+	SystemVariableNotifier();
+	virtual ~SystemVariableNotifier();
+
+	void start();
+	void stop();
+
+	/**
+	 * Notifies the event handler and all RPC clients about changed system variables.
+	 *
+	 * @param variableIDs The IDs of the changed variables.
+	 * @param values The new values. For deleted variables this is the struct broadcasted as deletion event.
+	 * @param deleted Set to true when the variables were deleted. The event handler is not triggered in this case.
+	 * @param wait When true, the method returns after the notification was processed, so all events are queued for the subscribers. Notifications are always processed in the order of the calls to this method.
+	 */
+	void notify(std::shared_ptr<std::vector<std::string>>& variableIDs, std::shared_ptr<std::vector<BaseLib::PVariable>>& values, bool deleted, bool wait);
+private:
+	class QueueEntry : public BaseLib::IQueueEntry
+	{
+	public:
+		QueueEntry() {}
+		QueueEntry(std::shared_ptr<std::vector<std::string>>& variableIDs, std::shared_ptr<std::vector<BaseLib::PVariable>>& values, bool deleted) { this->variableIDs = variableIDs; this->values = values; this->deleted = deleted; }
+		virtual ~QueueEntry() {}
+
+		std::shared_ptr<std::vector<std::string>> variableIDs;
+		std::shared_ptr<std::vector<BaseLib::PVariable>> values;
+		bool deleted = false;
+		std::shared_ptr<std::promise<void>> processed;
+	};
+
+	std::atomic_bool _started;
+	Metrics::PQueueDepth _queueDepth;
+
+	/**
+	 * Signaled whenever an entry was processed, so notify() can wait for space in a full queue.
+	 */
+	std::mutex _queueSpaceMutex;
+	std::condition_variable _queueSpaceConditionVariable;
+
+	SystemVariableNotifier(const SystemVariableNotifier&);
+	SystemVariableNotifier& operator=(const SystemVariableNotifier&);
+	void send(std::shared_ptr<std::vector<std::string>>& variableIDs, std::shared_ptr<std::vector<BaseLib::PVariable>>& values, bool deleted);
+	void processQueueEntry(int32_t index, std::shared_ptr<BaseLib::IQueueEntry>& entry);
+};
+
+#endif
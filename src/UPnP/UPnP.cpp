@@ -38,6 +38,10 @@ UPnP::UPnP()
 	try
 	{
 		_serverSocketDescriptor.reset(new BaseLib::FileDescriptor());
+		memset(&_multicastAddress, 0, sizeof(_multicastAddress));
+		_multicastAddress.sin_family = AF_INET;
+		_multicastAddress.sin_addr.s_addr = inet_addr("239.255.255.250");
+		_multicastAddress.sin_port = htons(1900);
 	}
 	catch(const std::exception& ex)
 	{
@@ -196,6 +200,8 @@ void UPnP::listen()
 		_out.printInfo("Info: Started listening.");
 
 		_lastAdvertisement = BaseLib::HelperFunctions::getTimeSeconds();
+		_pendingReplies.clear();
+		_pendingNotifyTime = 0;
 		char buffer[1024];
 		int32_t bytesReceived = 0;
 		struct sockaddr_in si_other;
@@ -203,6 +209,7 @@ void UPnP::listen()
 		fd_set readFileDescriptor;
 		timeval timeout;
 		int32_t nfds = 0;
+		int32_t waitTime = 0;
 		BaseLib::Http http;
 		while(!_stopServer)
 		{
@@ -216,8 +223,9 @@ void UPnP::listen()
 					continue;
 				}
 
-				timeout.tv_sec = 1;
-				timeout.tv_usec = 0;
+				waitTime = sendPendingPackets();
+				timeout.tv_sec = waitTime / 1000;
+				timeout.tv_usec = (waitTime % 1000) * 1000;
 				FD_ZERO(&readFileDescriptor);
 				GD::bl->fileDescriptorManager.lock();
 				nfds = _serverSocketDescriptor->descriptor + 1;
@@ -230,11 +238,7 @@ void UPnP::listen()
 				FD_SET(_serverSocketDescriptor->descriptor, &readFileDescriptor);
 				GD::bl->fileDescriptorManager.unlock();
 				bytesReceived = select(nfds, &readFileDescriptor, NULL, NULL, &timeout);
-				if(bytesReceived == 0)
-				{
-					if(BaseLib::HelperFunctions::getTimeSeconds() - _lastAdvertisement >= 60) sendNotify();
-					continue;
-				}
+				if(bytesReceived == 0) continue;
 				if(bytesReceived != 1)
 				{
 					_out.printError("Error: Socket closed (2).");
@@ -293,17 +297,10 @@ void UPnP::processPacket(BaseLib::Http& http)
 			{
 				int32_t mx = 500;
 				if(header.fields.find("mx") != header.fields.end()) mx = BaseLib::Math::getNumber(header.fields.at("mx"), false) * 1000;
-				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+				int32_t delay = 20;
 				//Wait for 0 to mx seconds for load balancing
-				if(mx > 500)
-				{
-					mx = BaseLib::HelperFunctions::getRandomNumber(0, mx - 500);
-					GD::out.printDebug("Debug: Sleeping " + std::to_string(mx) + "ms before sending response.");
-					std::this_thread::sleep_for(std::chrono::milliseconds(mx));
-				}
-				sendOK(address.first, port, header.fields.at("st") == "upnp:rootdevice");
-				std::this_thread::sleep_for(std::chrono::milliseconds(100));
-				sendNotify();
+				if(mx > 500) delay += BaseLib::HelperFunctions::getRandomNumber(0, mx - 500);
+				scheduleOK(address.first, port, header.fields.at("st") == "upnp:rootdevice", delay);
 			}
 		}
 	}
@@ -395,35 +392,84 @@ void UPnP::registerServers()
 	}
 }
 
-void UPnP::sendOK(std::string destinationIpAddress, int32_t destinationPort, bool rootDeviceOnly)
+void UPnP::scheduleOK(std::string& destinationIpAddress, int32_t destinationPort, bool rootDeviceOnly, int32_t delay)
 {
 	try
 	{
-		if(!_serverSocketDescriptor || _serverSocketDescriptor->descriptor == -1 || _packets.empty()) return;
-		struct sockaddr_in addessInfo;
-		addessInfo.sin_family = AF_INET;
-		addessInfo.sin_addr.s_addr = inet_addr(destinationIpAddress.c_str());
-		addessInfo.sin_port = htons(destinationPort);
+		std::string key = destinationIpAddress + ':' + std::to_string(destinationPort);
+		std::map<std::string, PendingReply>::iterator replyIterator = _pendingReplies.find(key);
+		if(replyIterator != _pendingReplies.end())
+		{
+			//Answer with all packets if any of the requests asked for more than the root device.
+			if(!rootDeviceOnly) replyIterator->second.rootDeviceOnly = false;
+			if(GD::bl->debugLevel >= 5) _out.printDebug("Debug: Response to " + key + " is already pending.");
+			return;
+		}
+		if(_pendingReplies.size() >= _maxPendingReplies)
+		{
+			_out.printWarning("Warning: Too many discovery responses are pending. Ignoring request from " + key + ".");
+			return;
+		}
 
-		for(std::map<int32_t, Packets>::iterator i = _packets.begin(); i != _packets.end(); ++i)
+		PendingReply reply;
+		memset(&reply.address, 0, sizeof(reply.address));
+		reply.address.sin_family = AF_INET;
+		reply.address.sin_addr.s_addr = inet_addr(destinationIpAddress.c_str());
+		reply.address.sin_port = htons(destinationPort);
+		if(reply.address.sin_addr.s_addr == INADDR_NONE) return;
+		reply.rootDeviceOnly = rootDeviceOnly;
+		reply.time = BaseLib::HelperFunctions::getTime() + delay;
+		if(GD::bl->debugLevel >= 5) _out.printDebug("Debug: Sending response to " + key + " in " + std::to_string(delay) + "ms.");
+		_pendingReplies[key] = reply;
+	}
+	catch(const std::exception& ex)
+	{
+		_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+int32_t UPnP::sendPendingPackets()
+{
+	try
+	{
+		int64_t time = BaseLib::HelperFunctions::getTime();
+		int64_t nextTime = time + 1000;
+		for(std::map<std::string, PendingReply>::iterator i = _pendingReplies.begin(); i != _pendingReplies.end();)
 		{
-			if(GD::bl->debugLevel >= 5) _out.printDebug("Debug: Sending discovery response packets to " + destinationIpAddress + " on port " + std::to_string(destinationPort));
-			if(sendto(_serverSocketDescriptor->descriptor, &i->second.okRoot.at(0), i->second.okRoot.size(), 0, (struct sockaddr*)&addessInfo, sizeof(addessInfo)) == -1)
+			if(i->second.time <= time)
 			{
-				_out.printWarning("Warning: Error sending packet in UPnP server: " + std::string(strerror(errno)));
+				sendOK(i->second.address, i->second.rootDeviceOnly);
+				i = _pendingReplies.erase(i);
+				//One notification 100ms after the responses. Responses sent in the meantime don't trigger another one.
+				if(_pendingNotifyTime == 0) _pendingNotifyTime = time + 100;
 			}
-			if(!rootDeviceOnly)
+			else
 			{
-				if(sendto(_serverSocketDescriptor->descriptor, &i->second.okRootUUID.at(0), i->second.okRootUUID.size(), 0, (struct sockaddr*)&addessInfo, sizeof(addessInfo)) == -1)
-				{
-					_out.printWarning("Warning: Error sending packet in UPnP server: " + std::string(strerror(errno)));
-				}
-				if(sendto(_serverSocketDescriptor->descriptor, &i->second.ok.at(0), i->second.ok.size(), 0, (struct sockaddr*)&addessInfo, sizeof(addessInfo)) == -1)
-				{
-					_out.printWarning("Warning: Error sending packet in UPnP server: " + std::string(strerror(errno)));
-				}
+				if(i->second.time < nextTime) nextTime = i->second.time;
+				++i;
 			}
 		}
+
+		if(_pendingNotifyTime != 0)
+		{
+			if(_pendingNotifyTime <= time)
+			{
+				_pendingNotifyTime = 0;
+				sendNotify();
+			}
+			else if(_pendingNotifyTime < nextTime) nextTime = _pendingNotifyTime;
+		}
+		if(BaseLib::HelperFunctions::getTimeSeconds() - _lastAdvertisement >= 60) sendNotify();
+
+		return nextTime - time;
 	}
 	catch(const std::exception& ex)
 	{
@@ -437,34 +483,75 @@ void UPnP::sendOK(std::string destinationIpAddress, int32_t destinationPort, boo
 	{
 		_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
 	}
+	return 1000;
 }
 
-void UPnP::sendNotify()
+void UPnP::sendPacket(std::vector<char>& packet, struct sockaddr_in& address)
 {
 	try
 	{
-		if(!_serverSocketDescriptor || _serverSocketDescriptor->descriptor == -1 || _packets.empty()) return;
-		struct sockaddr_in addessInfo;
-		addessInfo.sin_family = AF_INET;
-		addessInfo.sin_addr.s_addr = inet_addr("239.255.255.250");
-		addessInfo.sin_port = htons(1900);
+		if(packet.empty()) return;
+		if(sendto(_serverSocketDescriptor->descriptor, &packet.at(0), packet.size(), 0, (struct sockaddr*)&address, sizeof(address)) == -1)
+		{
+			_out.printWarning("Warning: Error sending packet in UPnP server: " + std::string(strerror(errno)));
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
 
+void UPnP::sendOK(struct sockaddr_in& address, bool rootDeviceOnly)
+{
+	try
+	{
+		if(!_serverSocketDescriptor || _serverSocketDescriptor->descriptor == -1 || _packets.empty()) return;
+		if(GD::bl->debugLevel >= 5) _out.printDebug("Debug: Sending discovery response packets to " + std::string(inet_ntoa(address.sin_addr)) + " on port " + std::to_string(ntohs(address.sin_port)));
 		for(std::map<int32_t, Packets>::iterator i = _packets.begin(); i != _packets.end(); ++i)
 		{
-			if(GD::bl->debugLevel >= 5) _out.printDebug("Debug: Sending notify packets.");
-			if(sendto(_serverSocketDescriptor->descriptor, &i->second.notifyRoot.at(0), i->second.notifyRoot.size(), 0, (struct sockaddr*)&addessInfo, sizeof(addessInfo)) == -1)
-			{
-				_out.printWarning("Warning: Error sending packet in UPnP server: " + std::string(strerror(errno)));
-			}
-			if(sendto(_serverSocketDescriptor->descriptor, &i->second.notifyRootUUID.at(0), i->second.notifyRootUUID.size(), 0, (struct sockaddr*)&addessInfo, sizeof(addessInfo)) == -1)
-			{
-				_out.printWarning("Warning: Error sending packet in UPnP server: " + std::string(strerror(errno)));
-			}
-			if(sendto(_serverSocketDescriptor->descriptor, &i->second.notify.at(0), i->second.notify.size(), 0, (struct sockaddr*)&addessInfo, sizeof(addessInfo)) == -1)
+			sendPacket(i->second.okRoot, address);
+			if(!rootDeviceOnly)
 			{
-				_out.printWarning("Warning: Error sending packet in UPnP server: " + std::string(strerror(errno)));
+				sendPacket(i->second.okRootUUID, address);
+				sendPacket(i->second.ok, address);
 			}
 		}
+	}
+	catch(const std::exception& ex)
+	{
+		_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(BaseLib::Exception& ex)
+	{
+		_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	catch(...)
+	{
+		_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+}
+
+void UPnP::sendNotify()
+{
+	try
+	{
+		if(!_serverSocketDescriptor || _serverSocketDescriptor->descriptor == -1 || _packets.empty()) return;
+		if(GD::bl->debugLevel >= 5) _out.printDebug("Debug: Sending notify packets.");
+		for(std::map<int32_t, Packets>::iterator i = _packets.begin(); i != _packets.end(); ++i)
+		{
+			sendPacket(i->second.notifyRoot, _multicastAddress);
+			sendPacket(i->second.notifyRootUUID, _multicastAddress);
+			sendPacket(i->second.notify, _multicastAddress);
+		}
 		_lastAdvertisement = BaseLib::HelperFunctions::getTimeSeconds();
 	}
 	catch(const std::exception& ex)
@@ -486,26 +573,12 @@ void UPnP::sendByebye()
 	try
 	{
 		if(!_serverSocketDescriptor || _serverSocketDescriptor->descriptor == -1 || _packets.empty()) return;
-		struct sockaddr_in addessInfo;
-		addessInfo.sin_family = AF_INET;
-		addessInfo.sin_addr.s_addr = inet_addr("239.255.255.250");
-		addessInfo.sin_port = htons(1900);
-
+		if(GD::bl->debugLevel >= 5) _out.printDebug("Debug: Sending byebye packets.");
 		for(std::map<int32_t, Packets>::iterator i = _packets.begin(); i != _packets.end(); ++i)
 		{
-			if(GD::bl->debugLevel >= 5) _out.printDebug("Debug: Sending byebye packets.");
-			if(sendto(_serverSocketDescriptor->descriptor, &i->second.byebyeRoot.at(0), i->second.byebyeRoot.size(), 0, (struct sockaddr*)&addessInfo, sizeof(addessInfo)) == -1)
-			{
-				_out.printWarning("Warning: Error sending packet in UPnP server: " + std::string(strerror(errno)));
-			}
-			if(sendto(_serverSocketDescriptor->descriptor, &i->second.byebyeRootUUID.at(0), i->second.byebyeRootUUID.size(), 0, (struct sockaddr*)&addessInfo, sizeof(addessInfo)) == -1)
-			{
-				_out.printWarning("Warning: Error sending packet in UPnP server: " + std::string(strerror(errno)));
-			}
-			if(sendto(_serverSocketDescriptor->descriptor, &i->second.byebye.at(0), i->second.byebye.size(), 0, (struct sockaddr*)&addessInfo, sizeof(addessInfo)) == -1)
-			{
-				_out.printWarning("Warning: Error sending packet in UPnP server: " + std::string(strerror(errno)));
-			}
+			sendPacket(i->second.byebyeRoot, _multicastAddress);
+			sendPacket(i->second.byebyeRootUUID, _multicastAddress);
+			sendPacket(i->second.byebye, _multicastAddress);
 		}
 	}
 	catch(const std::exception& ex)
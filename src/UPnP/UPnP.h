@@ -33,6 +33,8 @@
 
 #include "homegear-base/BaseLib.h"
 
+#include <netinet/in.h>
+
 class UPnP : public BaseLib::Rpc::IWebserverEventSink
 {
 public:
@@ -57,6 +59,13 @@ private:
 		std::vector<char> description;
 	};
 
+	struct PendingReply
+	{
+		int64_t time = 0;
+		struct sockaddr_in address;
+		bool rootDeviceOnly = true;
+	};
+
 	BaseLib::Output _out;
 	bool _stopServer = true;
 	std::shared_ptr<BaseLib::FileDescriptor> _serverSocketDescriptor;
@@ -66,6 +75,15 @@ private:
 	std::string _st;
 	std::map<int32_t, Packets> _packets;
 	int32_t _lastAdvertisement = 0;
+	struct sockaddr_in _multicastAddress;
+
+	/**
+	 * Discovery responses waiting for their send time. They are sent by the listen thread, so receiving is never blocked by the delay requested
+	 * in "MX". The key is "IP:port" of the requester, so there is only one pending response per requester.
+	 */
+	std::map<std::string, PendingReply> _pendingReplies;
+	uint32_t _maxPendingReplies = 100;
+	int64_t _pendingNotifyTime = 0;
 
 	// {{{ Webserver events
 		BaseLib::PEventHandler _webserverEventHandler;
@@ -78,7 +96,16 @@ private:
 	void getSocketDescriptor();
 	void listen();
 	void processPacket(BaseLib::Http& http);
-	void sendOK(std::string destinationIpAddress, int32_t destinationPort, bool rootDeviceOnly);
+	void scheduleOK(std::string& destinationIpAddress, int32_t destinationPort, bool rootDeviceOnly, int32_t delay);
+
+	/**
+	 * Sends all pending packets which are due.
+	 *
+	 * @return Returns the time in milliseconds until the next packet is due (at most 1000).
+	 */
+	int32_t sendPendingPackets();
+	void sendPacket(std::vector<char>& packet, struct sockaddr_in& address);
+	void sendOK(struct sockaddr_in& address, bool rootDeviceOnly);
 	void sendNotify();
 	void sendByebye();
 	void registerServers();
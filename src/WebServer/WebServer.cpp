@@ -58,6 +58,19 @@ void WebServer::get(BaseLib::Http& http, std::shared_ptr<BaseLib::SocketOperatio
 		std::vector<char> content;
 		if(!path.empty() && path.front() == '/') path = path.substr(1);
 
+		// {{{ Metrics in Prometheus text format. Files in the content directory take precedence.
+		if(path == "metrics" && !GD::bl->io.fileExists(_serverInfo->contentPath + path) && !GD::bl->io.directoryExists(_serverInfo->contentPath + path))
+		{
+			std::string contentString = GD::metrics.getPrometheusText();
+			std::string header;
+			_http.constructHeader(contentString.size(), "text/plain; version=0.0.4", 200, "OK", headers, header);
+			content.insert(content.end(), header.begin(), header.end());
+			if(http.getHeader().method != "HEAD") content.insert(content.end(), contentString.begin(), contentString.end());
+			send(socket, content);
+			return;
+		}
+		// }}}
+
 		bool isDirectory = false;
 		BaseLib::Io::isDirectory(_serverInfo->contentPath + path, isDirectory);
 		if(isDirectory)
@@ -148,6 +161,12 @@ void WebServer::get(BaseLib::Http& http, std::shared_ptr<BaseLib::SocketOperatio
 			{
 				std::string fullPath = _serverInfo->contentPath + path;
 				std::string relativePath = '/' + path;
+				if(http.getHeader().method == "GET")
+				{
+					executeCachedScript(http, socket, fullPath, relativePath);
+					socket->close();
+					return;
+				}
 				BaseLib::ScriptEngine::PScriptInfo scriptInfo(new BaseLib::ScriptEngine::ScriptInfo(BaseLib::ScriptEngine::ScriptInfo::ScriptType::web, fullPath, relativePath, http, _serverInfo));
 				scriptInfo->socket = socket;
 				scriptInfo->scriptHeadersCallback = std::bind(&WebServer::sendHeaders, this, std::placeholders::_1, std::placeholders::_2);
@@ -390,33 +409,377 @@ void WebServer::sendHeaders(BaseLib::ScriptEngine::PScriptInfo& scriptInfo, Base
 	try
 	{
 		if(!scriptInfo || !scriptInfo->socket || !headers) return;
+		std::string output = constructHeader(scriptInfo->http, headers);
+		scriptInfo->socket->proofwrite(output.c_str(), output.size());
+	}
+	catch(const std::exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+std::string WebServer::constructHeader(BaseLib::Http& http, BaseLib::PVariable& headers)
+{
+	try
+	{
 		BaseLib::Struct::iterator headerIterator = headers->structValue->find("RESPONSE_CODE");
 		int32_t responseCode = 500;
 		if(headerIterator != headers->structValue->end()) responseCode = headerIterator->second->integerValue;
 		if(responseCode == 0) responseCode = 500;
-		scriptInfo->http.getHeader().responseCode = responseCode;
+		http.getHeader().responseCode = responseCode;
 		headers->structValue->erase("RESPONSE_CODE");
 
 		{
 			std::lock_guard<std::mutex> sendHeaderGuard(_sendHeaderHookMutex);
 			for(std::map<std::string, std::function<void(BaseLib::Http& http, BaseLib::PVariable& headers)>>::iterator i = _sendHeaderHooks.begin(); i != _sendHeaderHooks.end(); ++i)
 			{
-				i->second(scriptInfo->http, headers);
+				i->second(http, headers);
 			}
 		}
 
 		std::string output;
 		output.reserve(1024);
-		output.append("HTTP/1.1 " + std::to_string(responseCode) + ' ' + scriptInfo->http.getStatusText(responseCode) + "\r\n");
+		output.append("HTTP/1.1 " + std::to_string(responseCode) + ' ' + http.getStatusText(responseCode) + "\r\n");
 		for(BaseLib::Struct::iterator i = headers->structValue->begin(); i != headers->structValue->end(); ++i)
 		{
 			if(output.size() + i->first.size() + i->second->stringValue.size() + 6 > output.capacity()) output.reserve(output.capacity() + 1024);
 			output.append(i->first + ": " + i->second->stringValue + "\r\n");
 		}
 		output.append("\r\n");
+		return output;
+	}
+	catch(const std::exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+	return "";
+}
+
+// {{{ Script cache
+void WebServer::executeCachedScript(BaseLib::Http& http, std::shared_ptr<BaseLib::SocketOperations>& socket, std::string& fullPath, std::string& relativePath)
+{
+	try
+	{
+		std::string key = getScriptCacheKey(http, relativePath);
+		PScriptCacheEntry entry;
+		{
+			std::lock_guard<std::mutex> scriptCacheGuard(_scriptCacheMutex);
+			std::map<std::string, PScriptCacheEntry>::iterator cacheIterator = _scriptCache.find(key);
+			if(cacheIterator != _scriptCache.end()) entry = cacheIterator->second;
+		}
+
+		//Only responses already known to be cacheable are in the cache, so only requests to those wait for each other.
+		if(entry)
+		{
+			std::unique_lock<std::mutex> entryLock(entry->mutex);
+			if(entry->executing)
+			{
+				//Another request is refreshing the entry right now. Wait for its result instead of executing the script again.
+				if(!entry->conditionVariable.wait_for(entryLock, std::chrono::milliseconds(_scriptCacheWaitTimeout), [&]{ return !entry->executing; }))
+				{
+					_out.printInfo("Info: Script cache entry for " + relativePath + " is still being refreshed. Executing script without the cache.");
+					entryLock.unlock();
+					entry.reset();
+				}
+			}
+			if(entry)
+			{
+				if(entry->cacheable && BaseLib::HelperFunctions::getTime() < entry->expirationTime)
+				{
+					int32_t responseCode = entry->responseCode;
+					std::vector<std::pair<std::string, std::string>> headers = entry->headers;
+					std::string content = entry->content;
+					entryLock.unlock();
+					_out.printDebug("Debug: Answering request to " + relativePath + " from script cache.");
+					sendCachedResponse(http, socket, responseCode, headers, content);
+					return;
+				}
+				if(entry->cacheable) entry->executing = true; //Expired. Refresh it, other requests wait.
+				else
+				{
+					//Refreshing failed or the response isn't cacheable anymore.
+					entryLock.unlock();
+					entry.reset();
+				}
+			}
+		}
+
+		//Not in the cache. The entry is added when the response is cacheable.
+		if(!entry) entry.reset(new ScriptCacheEntry());
+
+		PScriptCacheResponse response(new ScriptCacheResponse());
+		BaseLib::ScriptEngine::PScriptInfo scriptInfo(new BaseLib::ScriptEngine::ScriptInfo(BaseLib::ScriptEngine::ScriptInfo::ScriptType::web, fullPath, relativePath, http, _serverInfo));
+		scriptInfo->socket = socket;
+		scriptInfo->scriptHeadersCallback = std::bind(&WebServer::sendCacheableHeaders, this, std::placeholders::_1, std::placeholders::_2, response);
+		scriptInfo->scriptOutputCallback = std::bind(&WebServer::collectCacheableOutput, this, std::placeholders::_1, std::placeholders::_2, response);
+		try
+		{
+			GD::scriptEngineServer->executeScript(scriptInfo, true);
+		}
+		catch(...)
+		{
+			storeScriptCacheEntry(key, entry, response, -1);
+			throw;
+		}
+		storeScriptCacheEntry(key, entry, response, scriptInfo->exitCode);
+	}
+	catch(const std::exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+std::string WebServer::getScriptCacheKey(BaseLib::Http& http, std::string& relativePath)
+{
+	try
+	{
+		static const std::vector<std::string> keyHeaders{ "host", "accept", "accept-encoding", "accept-language", "authorization", "cookie" };
+
+		BaseLib::Http::Header& header = http.getHeader();
+		std::string key = relativePath + '?' + header.args;
+		for(std::vector<std::string>::const_iterator i = keyHeaders.begin(); i != keyHeaders.end(); ++i)
+		{
+			std::map<std::string, std::string>::iterator fieldIterator = header.fields.find(*i);
+			if(fieldIterator == header.fields.end()) continue;
+			key.append("\n" + *i + ": " + fieldIterator->second);
+		}
+		return key;
+	}
+	catch(const std::exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+	return "";
+}
+
+void WebServer::sendCacheableHeaders(BaseLib::ScriptEngine::PScriptInfo& scriptInfo, BaseLib::PVariable& headers, PScriptCacheResponse response)
+{
+	try
+	{
+		if(!scriptInfo || !scriptInfo->socket || !headers) return;
+
+		int32_t maxAge = 0;
+		std::vector<std::pair<std::string, std::string>> scriptHeaders;
+		scriptHeaders.reserve(headers->structValue->size());
+		for(BaseLib::Struct::iterator i = headers->structValue->begin(); i != headers->structValue->end();)
+		{
+			if(BaseLib::HelperFunctions::toLower(i->first) == "x-homegear-cache")
+			{
+				std::string value = BaseLib::HelperFunctions::toLower(i->second->stringValue);
+				std::string::size_type pos = value.find("max-age=");
+				if(pos != std::string::npos) maxAge = BaseLib::Math::getNumber(value.substr(pos + 8));
+				i = headers->structValue->erase(i);
+				continue;
+			}
+			if(i->first != "RESPONSE_CODE") scriptHeaders.push_back(std::pair<std::string, std::string>(i->first, i->second->stringValue));
+			++i;
+		}
+
+		//Executes the send header hooks. Cacheability is checked afterwards, because hooks can modify the response.
+		std::string output = constructHeader(scriptInfo->http, headers);
+		int32_t responseCode = scriptInfo->http.getHeader().responseCode;
+
+		//Responses setting cookies are user specific and are never cached.
+		bool setsCookie = false;
+		for(BaseLib::Struct::iterator i = headers->structValue->begin(); i != headers->structValue->end(); ++i)
+		{
+			if(BaseLib::HelperFunctions::toLower(i->first) == "set-cookie")
+			{
+				setsCookie = true;
+				break;
+			}
+		}
+
+		if(maxAge > 0 && !setsCookie && responseCode == 200 && output.size() < _scriptCacheMaxEntrySize)
+		{
+			std::lock_guard<std::mutex> responseGuard(response->mutex);
+			response->maxAge = maxAge > _scriptCacheMaxAge ? _scriptCacheMaxAge : maxAge;
+			response->responseCode = responseCode;
+			response->headerSize = output.size();
+			response->headers.swap(scriptHeaders);
+		}
+
 		scriptInfo->socket->proofwrite(output.c_str(), output.size());
 	}
-    catch(const std::exception& ex)
+	catch(const std::exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+void WebServer::collectCacheableOutput(BaseLib::ScriptEngine::PScriptInfo& scriptInfo, std::string& output, PScriptCacheResponse response)
+{
+	try
+	{
+		std::lock_guard<std::mutex> responseGuard(response->mutex);
+		if(response->maxAge <= 0) return;
+		if(response->headerSize + response->content.size() + output.size() > _scriptCacheMaxEntrySize)
+		{
+			//Too large to be cached.
+			response->maxAge = 0;
+			std::string().swap(response->content);
+			return;
+		}
+		response->content.append(output);
+	}
+	catch(const std::exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+void WebServer::storeScriptCacheEntry(std::string& key, PScriptCacheEntry& entry, PScriptCacheResponse& response, int32_t exitCode)
+{
+	try
+	{
+		int32_t maxAge = 0;
+		int32_t responseCode = 0;
+		std::vector<std::pair<std::string, std::string>> headers;
+		std::string content;
+		{
+			std::lock_guard<std::mutex> responseGuard(response->mutex);
+			if(exitCode == 0 && response->maxAge > 0)
+			{
+				maxAge = response->maxAge;
+				responseCode = response->responseCode;
+				headers.swap(response->headers);
+				content.swap(response->content);
+			}
+		}
+
+		int64_t time = BaseLib::HelperFunctions::getTime();
+		{
+			std::lock_guard<std::mutex> entryGuard(entry->mutex);
+			entry->cacheable = maxAge > 0;
+			entry->responseCode = responseCode;
+			entry->headers.swap(headers);
+			entry->content.swap(content);
+			entry->expirationTime = time + (int64_t)maxAge * 1000;
+			entry->executing = false;
+		}
+		entry->conditionVariable.notify_all();
+
+		std::lock_guard<std::mutex> scriptCacheGuard(_scriptCacheMutex);
+		std::map<std::string, PScriptCacheEntry>::iterator cacheIterator = _scriptCache.find(key);
+		if(maxAge <= 0)
+		{
+			//Not cacheable. Remove the entry, so requests don't wait for each other anymore.
+			if(cacheIterator != _scriptCache.end() && cacheIterator->second == entry) _scriptCache.erase(cacheIterator);
+			return;
+		}
+		if(cacheIterator == _scriptCache.end() && _scriptCache.size() >= _scriptCacheMaxEntries)
+		{
+			collectScriptCacheGarbage(time);
+			if(_scriptCache.size() >= _scriptCacheMaxEntries) return;
+		}
+		_scriptCache[key] = entry;
+	}
+	catch(const std::exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+void WebServer::sendCachedResponse(BaseLib::Http& http, std::shared_ptr<BaseLib::SocketOperations>& socket, int32_t responseCode, std::vector<std::pair<std::string, std::string>>& headers, std::string& content)
+{
+	try
+	{
+		BaseLib::PVariable headerStruct(new BaseLib::Variable(BaseLib::VariableType::tStruct));
+		for(std::vector<std::pair<std::string, std::string>>::iterator i = headers.begin(); i != headers.end(); ++i)
+		{
+			headerStruct->structValue->insert(BaseLib::StructElement(i->first, BaseLib::PVariable(new BaseLib::Variable(i->second))));
+		}
+		headerStruct->structValue->insert(BaseLib::StructElement("RESPONSE_CODE", BaseLib::PVariable(new BaseLib::Variable(responseCode))));
+
+		std::string header = constructHeader(http, headerStruct);
+		std::vector<char> data;
+		data.reserve(header.size() + content.size());
+		data.insert(data.end(), header.begin(), header.end());
+		data.insert(data.end(), content.begin(), content.end());
+		send(socket, data);
+	}
+	catch(const std::exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(BaseLib::Exception& ex)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    catch(...)
+    {
+    	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+    }
+}
+
+void WebServer::collectScriptCacheGarbage(int64_t time)
+{
+	try
+	{
+		for(std::map<std::string, PScriptCacheEntry>::iterator i = _scriptCache.begin(); i != _scriptCache.end();)
+		{
+			std::lock_guard<std::mutex> expiredEntryGuard(i->second->mutex);
+			if(!i->second->executing && i->second->expirationTime <= time) i = _scriptCache.erase(i);
+			else ++i;
+		}
+	}
+	catch(const std::exception& ex)
     {
     	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
@@ -429,6 +792,7 @@ void WebServer::sendHeaders(BaseLib::ScriptEngine::PScriptInfo& scriptInfo, Base
     	_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
     }
 }
+// }}}
 
 // {{{ Hooks
 void WebServer::registerSendHeadersHook(std::string& moduleName, std::function<void(BaseLib::Http& http, BaseLib::PVariable& headers)>& callback)
@@ -49,6 +49,38 @@ namespace WebServer
 			void registerSendHeadersHook(std::string& moduleName, std::function<void(BaseLib::Http& http, BaseLib::PVariable& headers)>& callback);
 		protected:
 		private:
+			/**
+			 * Cached response of a web script. Scripts opt in by sending the header "X-Homegear-Cache: max-age=<seconds>". Only the headers as sent by
+			 * the script and the body are stored, the send header hooks are executed for every request. An entry is added to the cache after the first
+			 * cacheable response. When it expires, one request refreshes it and concurrent identical requests wait for the result.
+			 */
+			struct ScriptCacheEntry
+			{
+				std::mutex mutex;
+				std::condition_variable conditionVariable;
+				bool executing = false;
+				bool cacheable = false;
+				int64_t expirationTime = 0;
+				int32_t responseCode = 0;
+				std::vector<std::pair<std::string, std::string>> headers;
+				std::string content;
+			};
+			typedef std::shared_ptr<ScriptCacheEntry> PScriptCacheEntry;
+
+			/**
+			 * Collects headers and output of a script execution, so the response can be stored in the script cache.
+			 */
+			struct ScriptCacheResponse
+			{
+				std::mutex mutex;
+				int32_t maxAge = 0;
+				int32_t responseCode = 0;
+				size_t headerSize = 0;
+				std::vector<std::pair<std::string, std::string>> headers;
+				std::string content;
+			};
+			typedef std::shared_ptr<ScriptCacheResponse> PScriptCacheResponse;
+
 			BaseLib::Output _out;
 			BaseLib::Rpc::PServerInfo _serverInfo;
 			BaseLib::Http _http;
@@ -56,8 +88,34 @@ namespace WebServer
 			std::mutex _sendHeaderHookMutex;
 			std::map<std::string, std::function<void(BaseLib::Http& http, BaseLib::PVariable& headers)>> _sendHeaderHooks;
 
+			const int32_t _scriptCacheMaxAge = 3600;
+			const size_t _scriptCacheMaxEntrySize = 1048576;
+			const size_t _scriptCacheMaxEntries = 1000;
+			const int64_t _scriptCacheWaitTimeout = 10000;
+			std::mutex _scriptCacheMutex;
+			std::map<std::string, PScriptCacheEntry> _scriptCache;
+
 			void send(std::shared_ptr<BaseLib::SocketOperations>& socket, std::vector<char>& data);
 			void sendHeaders(BaseLib::ScriptEngine::PScriptInfo& scriptInfo, BaseLib::PVariable& headers);
+			std::string constructHeader(BaseLib::Http& http, BaseLib::PVariable& headers);
+
+			// {{{ Script cache
+			/**
+			 * Executes a web script for a GET request. When the script marked its response as cacheable, identical requests are answered from memory
+			 * until the response expires. Concurrent identical requests to expired entries are coalesced into one execution.
+			 */
+			void executeCachedScript(BaseLib::Http& http, std::shared_ptr<BaseLib::SocketOperations>& socket, std::string& fullPath, std::string& relativePath);
+			std::string getScriptCacheKey(BaseLib::Http& http, std::string& relativePath);
+			void sendCacheableHeaders(BaseLib::ScriptEngine::PScriptInfo& scriptInfo, BaseLib::PVariable& headers, PScriptCacheResponse response);
+			void collectCacheableOutput(BaseLib::ScriptEngine::PScriptInfo& scriptInfo, std::string& output, PScriptCacheResponse response);
+			void storeScriptCacheEntry(std::string& key, PScriptCacheEntry& entry, PScriptCacheResponse& response, int32_t exitCode);
+			void sendCachedResponse(BaseLib::Http& http, std::shared_ptr<BaseLib::SocketOperations>& socket, int32_t responseCode, std::vector<std::pair<std::string, std::string>>& headers, std::string& content);
+
+			/**
+			 * Removes expired entries from the script cache. "_scriptCacheMutex" needs to be locked.
+			 */
+			void collectScriptCacheGarbage(int64_t time);
+			// }}}
 	};
 }
 #endif
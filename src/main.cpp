@@ -243,6 +243,8 @@ void terminate(int32_t signalNumber)
 			if(GD::familyController) GD::familyController->physicalInterfaceStopListening();
 			GD::out.printInfo("(Shutdown) => Stopping script engine server...");
 			GD::scriptEngineServer->stop();
+			GD::out.printInfo("(Shutdown) => Stopping parallel RPC call pool...");
+			if(GD::parallelCallPool) GD::parallelCallPool->stop();
 			GD::out.printMessage("(Shutdown) => Saving device families");
 			if(GD::familyController) GD::familyController->save(false);
 			GD::out.printMessage("(Shutdown) => Disposing device families");
@@ -513,10 +515,16 @@ void printHelp()
 	std::cout << "-g\t\t\tRun as group" << std::endl;
 	std::cout << "-c <path>\t\tSpecify path to config file" << std::endl;
 	std::cout << "-d\t\t\tRun as daemon" << std::endl;
+	std::cout << "-ps\t\t\tWrite a snapshot of all peer data on shutdown and load it on the next start" << std::endl;
+	std::cout << "-mc <bytes>\t\tMaximum memory used to cache metadata (default: 10485760)" << std::endl;
+	std::cout << "-mp <count>\t\tMaximum number of read-only calls of one system.multicall executed in parallel (default: 1)" << std::endl;
+	std::cout << "-hi <seconds>\t\tInterval of the monitor process' health checks (default: 10)" << std::endl;
+	std::cout << "-ht <seconds>\t\tTime to wait for the response to a health check (default: 60)" << std::endl;
 	std::cout << "-p <pid path>\t\tSpecify path to process id file" << std::endl;
 	std::cout << "-s <user> <group>\tSet GPIO settings and necessary permissions for all defined physical devices" << std::endl;
 	std::cout << "-r\t\t\tConnect to Homegear on this machine" << std::endl;
 	std::cout << "-e <command>\t\tExecute CLI command" << std::endl;
+	std::cout << "-b\t\t\tExecute CLI commands read line by line from standard input over one connection" << std::endl;
 	std::cout << "-o <input> <output>\tConvert old device description file into new format." << std::endl;
 	std::cout << "-v\t\t\tPrint program version" << std::endl;
 }
@@ -540,7 +548,7 @@ void startMainProcess()
 		{
 			_monitorProcess = true;
 			_mainProcessId = pid;
-			_monitor.prepareParent();
+			_monitor.prepareParent(_mainProcessId);
 		}
 		else
 		{
@@ -688,7 +696,6 @@ void startUp()
     				GD::out.printError("Homegear was terminated. Restarting (2)...");
     				startMainProcess();
     			}
-    			_monitor.checkHealth(_mainProcessId);
     		}
     	}
 
@@ -848,6 +855,10 @@ void startUp()
 				exit(1);
 			}
 		}
+		GD::out.printInfo("Starting parallel RPC call pool...");
+		GD::parallelCallPool.reset(new RPC::ParallelCallPool());
+		GD::parallelCallPool->start();
+
 		GD::out.printInfo("Starting script engine server...");
 		GD::scriptEngineServer.reset(new ScriptEngine::ScriptEngineServer());
 		if(!GD::scriptEngineServer->start())
@@ -866,6 +877,14 @@ void startUp()
         if(BaseLib::Io::fileExists(GD::configPath + "physicalinterfaces.conf")) GD::out.printWarning("Warning: File physicalinterfaces.conf exists in config directory. Interface configuration has been moved to " + GD::bl->settings.familyConfigPath());
         GD::familyController->load(); //Don't load before database is open!
 
+        //The RPC servers are started while the families are loading. Families only become visible to RPC methods once they are loaded.
+        GD::out.printInfo("Initializing RPC client...");
+        GD::rpcClient->init();
+
+        startRPCServers();
+
+        GD::familyController->waitForFamiliesLoaded();
+
         GD::out.printInfo("Start listening for packets...");
         GD::familyController->physicalInterfaceStartListening();
         if(!GD::familyController->physicalInterfaceIsOpen())
@@ -875,17 +894,12 @@ void startUp()
         	exitHomegear(1);
         }
 
-        GD::out.printInfo("Initializing RPC client...");
-        GD::rpcClient->init();
-
         if(GD::mqtt->enabled())
 		{
 			GD::out.printInfo("Starting MQTT client...");;
 			GD::mqtt->start();
 		}
 
-        startRPCServers();
-
 		GD::out.printInfo("Starting CLI server...");
 		GD::cliServer.reset(new CLI::Server());
 		GD::cliServer->start();
@@ -1109,6 +1123,66 @@ int main(int argc, char* argv[])
     		{
     			_startAsDaemon = true;
     		}
+    		else if(arg == "-ps")
+    		{
+    			GD::peerSnapshot = true;
+    		}
+    		else if(arg == "-mc")
+    		{
+    			if(i + 1 < argc)
+    			{
+    				GD::metadataCacheSize = BaseLib::Math::getNumber64(std::string(argv[i + 1]));
+    				if(GD::metadataCacheSize < 0) GD::metadataCacheSize = 0;
+    				i++;
+    			}
+    			else
+    			{
+    				printHelp();
+    				exit(1);
+    			}
+    		}
+    		else if(arg == "-mp")
+    		{
+    			if(i + 1 < argc)
+    			{
+    				GD::multicallParallelism = BaseLib::Math::getNumber(std::string(argv[i + 1]));
+    				if(GD::multicallParallelism < 1) GD::multicallParallelism = 1;
+    				i++;
+    			}
+    			else
+    			{
+    				printHelp();
+    				exit(1);
+    			}
+    		}
+    		else if(arg == "-hi")
+    		{
+    			if(i + 1 < argc)
+    			{
+    				GD::healthCheckInterval = BaseLib::Math::getNumber(std::string(argv[i + 1]));
+    				if(GD::healthCheckInterval < 1) GD::healthCheckInterval = 1;
+    				i++;
+    			}
+    			else
+    			{
+    				printHelp();
+    				exit(1);
+    			}
+    		}
+    		else if(arg == "-ht")
+    		{
+    			if(i + 1 < argc)
+    			{
+    				GD::healthCheckTimeout = BaseLib::Math::getNumber(std::string(argv[i + 1]));
+    				if(GD::healthCheckTimeout < 1) GD::healthCheckTimeout = 1;
+    				i++;
+    			}
+    			else
+    			{
+    				printHelp();
+    				exit(1);
+    			}
+    		}
     		else if(arg == "-r")
     		{
 #ifndef __aarch64__
@@ -1174,6 +1248,14 @@ int main(int argc, char* argv[])
     			int32_t exitCode = cliClient.start(command.str());
     			exit(exitCode);
     		}
+    		else if(arg == "-b")
+    		{
+    			GD::bl->settings.load(GD::configPath + "main.conf");
+    			GD::bl->debugLevel = 3; //Only output warnings.
+    			CLI::Client cliClient;
+    			int32_t exitCode = cliClient.startBatch();
+    			exit(exitCode);
+    		}
     		else if(arg == "-tc")
     		{
     			GD::bl->threadManager.testMaxThreadCount();